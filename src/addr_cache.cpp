@@ -0,0 +1,145 @@
+// addr_cache.cpp - text cache of resolved RVAs, one "name hexrva" per line
+#include "addr_cache.h"
+#include <cstdio>
+#include <cstring>
+
+static const int CACHE_VERSION     = 1;
+static const int CACHE_MAX_ENTRIES = 64;
+static const int CACHE_NAME_LEN    = 32;
+
+// An entry holds a scanned value (stored), an override (memory only), or
+// both; the override wins on lookup.
+struct CacheEntry
+{
+    char     name[CACHE_NAME_LEN];
+    uint32_t rva;
+    uint32_t over;
+    bool     scanned;
+    bool     overridden;
+};
+
+static char       g_path[260];
+static char       g_build[64];
+static PeKey      g_mpKey, g_hwKey;
+static CacheEntry g_entries[CACHE_MAX_ENTRIES];
+static int        g_count = 0;
+static bool       g_dirty = false;
+
+static bool SameKey(const PeKey& a, const PeKey& b)
+{
+    return a.timeDateStamp == b.timeDateStamp && a.checkSum == b.checkSum
+        && a.sizeOfImage == b.sizeOfImage;
+}
+
+static bool ReadKey(const char* line, const char* tag, PeKey& out)
+{
+    char t[8];
+    unsigned a, b, c;
+    if (sscanf(line, "%7s %x %x %x", t, &a, &b, &c) != 4 || strcmp(t, tag)) return false;
+    out = { a, b, c };
+    return true;
+}
+
+bool AddrCache_Open(const char* path, const char* build, const PeKey& mp, const PeKey& hw)
+{
+    snprintf(g_path, sizeof(g_path), "%s", path);
+    snprintf(g_build, sizeof(g_build), "%s", build);
+    g_mpKey = mp; g_hwKey = hw;
+    g_count = 0; g_dirty = true;
+
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[128];
+    int  ver = 0;
+    PeKey fmp = {}, fhw = {};
+    bool ok = fgets(line, sizeof(line), f) && sscanf(line, "csnz_addr_cache %d", &ver) == 1
+           && ver == CACHE_VERSION
+           && fgets(line, sizeof(line), f) && !strncmp(line, "build ", 6)
+           && !strncmp(line + 6, build, strlen(build)) && line[6 + strlen(build)] == '\n'
+           && fgets(line, sizeof(line), f) && ReadKey(line, "mp", fmp) && SameKey(fmp, mp)
+           && fgets(line, sizeof(line), f) && ReadKey(line, "hw", fhw) && SameKey(fhw, hw);
+    if (ok)
+    {
+        while (g_count < CACHE_MAX_ENTRIES && fgets(line, sizeof(line), f))
+        {
+            CacheEntry& e = g_entries[g_count];
+            unsigned rva = 0;
+            if (sscanf(line, "%31s %x", e.name, &rva) != 2) continue;
+            e.rva        = rva;
+            e.scanned    = true;
+            e.overridden = false;
+            g_count++;
+        }
+        g_dirty = false;
+    }
+    fclose(f);
+    return ok;
+}
+
+static CacheEntry* Find(const char* name)
+{
+    for (int i = 0; i < g_count; i++)
+        if (!strcmp(g_entries[i].name, name)) return &g_entries[i];
+    return nullptr;
+}
+
+static CacheEntry* FindOrAdd(const char* name)
+{
+    if (CacheEntry* e = Find(name)) return e;
+    if (g_count >= CACHE_MAX_ENTRIES || strlen(name) >= CACHE_NAME_LEN) return nullptr;
+    CacheEntry& e = g_entries[g_count++];
+    snprintf(e.name, sizeof(e.name), "%s", name);
+    e.scanned = e.overridden = false;
+    return &e;
+}
+
+bool AddrCache_Get(const char* name, uint32_t& rva)
+{
+    const CacheEntry* e = Find(name);
+    if (!e) return false;
+    if (e->overridden)   rva = e->over;
+    else if (e->scanned) rva = e->rva;
+    else                 return false;
+    return true;
+}
+
+uint32_t AddrCache_GetOr(const char* name, uint32_t fallback)
+{
+    uint32_t rva = fallback;
+    AddrCache_Get(name, rva);
+    return rva;
+}
+
+void AddrCache_Put(const char* name, uint32_t rva)
+{
+    CacheEntry* e = FindOrAdd(name);
+    if (!e || (e->scanned && e->rva == rva)) return;
+    e->rva     = rva;
+    e->scanned = true;
+    g_dirty    = true;
+}
+
+void AddrCache_Override(const char* name, uint32_t rva)
+{
+    CacheEntry* e = FindOrAdd(name);
+    if (!e) return;
+    e->over       = rva;
+    e->overridden = true;
+}
+
+bool AddrCache_Save()
+{
+    if (!g_dirty || !g_path[0]) return true;
+    FILE* f = fopen(g_path, "w");
+    if (!f) return false;
+    fprintf(f, "csnz_addr_cache %d\n", CACHE_VERSION);
+    fprintf(f, "build %s\n", g_build);
+    fprintf(f, "mp %08X %08X %08X\n", g_mpKey.timeDateStamp, g_mpKey.checkSum, g_mpKey.sizeOfImage);
+    fprintf(f, "hw %08X %08X %08X\n", g_hwKey.timeDateStamp, g_hwKey.checkSum, g_hwKey.sizeOfImage);
+    for (int i = 0; i < g_count; i++)
+        if (g_entries[i].scanned) fprintf(f, "%s %08X\n", g_entries[i].name, g_entries[i].rva);
+    bool ok = fclose(f) == 0;
+    if (ok) g_dirty = false;
+    return ok;
+}
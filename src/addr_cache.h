@@ -0,0 +1,50 @@
+#pragma once
+// addr_cache.h - on-disk cache of resolved RVAs.
+// Keyed by the mp.dll/hw.dll PE header (TimeDateStamp, CheckSum,
+// SizeOfImage) plus a build string naming what the entries were derived
+// from (hashes of the compiled-in defaults, see AddrCache_Hash); any
+// mismatch drops every entry so the caller falls back to a full rescan.
+// The build string has to cover every input a stored value depends on.
+// Only values resolved from the image are stored (AddrCache_Put), never a
+// default: a default is already in the binary, and a cached copy would
+// outlive a rebuild. Values from elsewhere (csnz_offsets.txt) go through
+// AddrCache_Override, which is held in memory and never written, so
+// dropping the override brings the scanned value back.
+
+#include "pe_scan.h"
+#include <cstdint>
+
+struct PeKey
+{
+    uint32_t timeDateStamp;
+    uint32_t checkSum;
+    uint32_t sizeOfImage;
+};
+
+inline PeKey PeKey_From(const PeImage& img)
+{
+    return { img.timeDateStamp, img.checkSum, img.sizeOfImage };
+}
+
+// FNV-1a, chained: h = AddrCache_Hash(h, p, n) starting from ADDR_CACHE_HASH0.
+static const uint32_t ADDR_CACHE_HASH0 = 2166136261u;
+inline uint32_t AddrCache_Hash(uint32_t h, const void* p, size_t n)
+{
+    const uint8_t* b = (const uint8_t*)p;
+    for (size_t i = 0; i < n; i++) h = (h ^ b[i]) * 16777619u;
+    return h;
+}
+
+// Load the cache at path. Returns true on a warm start (file present and
+// keys match); otherwise the cache starts empty under the new keys.
+bool AddrCache_Open(const char* path, const char* build, const PeKey& mp, const PeKey& hw);
+bool AddrCache_Get(const char* name, uint32_t& rva);
+// The cached rva, or fallback (not stored) if name isn't cached.
+uint32_t AddrCache_GetOr(const char* name, uint32_t fallback);
+// A value resolved from the image; saved.
+void AddrCache_Put(const char* name, uint32_t rva);
+// A value from outside the image for this run only. Lookups return it over
+// any scanned value; Save skips it.
+void AddrCache_Override(const char* name, uint32_t rva);
+// Write the file back if anything changed since Open.
+bool AddrCache_Save();
@@ -0,0 +1,52 @@
+// attach.cpp - install state machine (portable)
+#include "attach.h"
+
+void AttachMachine::OnModuleLoaded()
+{
+    if (m_state.load() != ATTACH_WAIT_MODULE) return;
+    // The hook may fire as soon as it's armed, so the state goes first.
+    m_state = ATTACH_WAIT_FRAME;
+    if (!m_host.ArmFrameHook()) m_state = ATTACH_POLLING;
+}
+
+void AttachMachine::OnModuleUnloaded()
+{
+    AttachState s = m_state.load();
+    if (s == ATTACH_DONE || s == ATTACH_FAILED) return;
+    if (s == ATTACH_WAIT_FRAME) m_host.DisarmFrameHook();
+    m_state = ATTACH_FAILED;
+}
+
+void AttachMachine::OnFrame()
+{
+    if (m_state.load() != ATTACH_WAIT_FRAME) return;
+    if (m_frames++ % ATTACH_RETRY_FRAMES) return;
+    TryInstall();
+    if (m_state.load() != ATTACH_WAIT_FRAME) m_host.DisarmFrameHook();
+}
+
+void AttachMachine::OnPollTick()
+{
+    if (m_state.load() != ATTACH_POLLING || !m_host.ServerReady()) return;
+    TryInstall();
+}
+
+void AttachMachine::TryInstall()
+{
+    m_tries++;
+    if (m_host.Install())                m_state = ATTACH_DONE;
+    else if (m_tries >= ATTACH_MAX_TRIES) m_state = ATTACH_FAILED;
+}
+
+const char* Attach_StateStr(AttachState s)
+{
+    switch (s)
+    {
+    case ATTACH_WAIT_MODULE: return "waiting for module";
+    case ATTACH_WAIT_FRAME:  return "waiting for first frame";
+    case ATTACH_POLLING:     return "polling";
+    case ATTACH_DONE:        return "done";
+    case ATTACH_FAILED:      return "failed";
+    }
+    return "?";
+}
@@ -0,0 +1,66 @@
+#pragma once
+// attach.h - when to install: a small state machine fed by events instead
+// of a polling loop.
+//
+//   WAIT_MODULE --module loaded--> WAIT_FRAME --first frame, Install ok--> DONE
+//                      |                   \--Install failed N times--> FAILED
+//                      \--can't arm--> POLLING --tick, ready, Install ok--> DONE
+//
+// Normally the loader notification reports mp.dll, a one-shot hook is armed
+// on the server's next frame, and everything is installed from inside that
+// frame, on the game thread. If the frame hook can't be armed, a slow poll
+// on server readiness is the fallback. mp.dll unloading before DONE is
+// FAILED; we don't chase a reloaded module.
+// The host does the real work, so the machine runs against a simulated
+// loader and server just as well.
+
+#include <atomic>
+
+enum AttachState
+{
+    ATTACH_WAIT_MODULE,
+    ATTACH_WAIT_FRAME,
+    ATTACH_POLLING,
+    ATTACH_DONE,
+    ATTACH_FAILED,
+};
+
+// Backend: the game process (dllmain.cpp) or a simulation.
+struct AttachHost
+{
+    virtual ~AttachHost() {}
+    // Make OnFrame() get called on server frames. False = fall back to polling.
+    virtual bool ArmFrameHook() = 0;
+    virtual void DisarmFrameHook() = 0;
+    // Polling fallback: is the server far enough along to install?
+    virtual bool ServerReady() = 0;
+    // Every hook plus post-init. May be retried after a failure.
+    virtual bool Install() = 0;
+};
+
+static const int ATTACH_MAX_TRIES    = 8;
+static const int ATTACH_RETRY_FRAMES  = 64;   // frames between install attempts
+
+class AttachMachine
+{
+public:
+    explicit AttachMachine(AttachHost& host) : m_host(host) {}
+
+    void OnModuleLoaded();
+    void OnModuleUnloaded();
+    void OnFrame();       // game thread, from the armed frame hook
+    void OnPollTick();    // fallback timer; ignored unless POLLING
+
+    AttachState State() const { return m_state.load(); }
+    int         Tries() const { return m_tries; }
+
+private:
+    void TryInstall();
+
+    AttachHost&              m_host;
+    std::atomic<AttachState> m_state{ ATTACH_WAIT_MODULE };
+    int                      m_tries = 0;
+    int                      m_frames = 0;
+};
+
+const char* Attach_StateStr(AttachState s);
@@ -0,0 +1,35 @@
+#pragma once
+// cpu_features.h - runtime ISA checks for the kernels that carry an AVX2
+// path next to their SSE2 one (pe_scan, spread). x86 only; call once and
+// keep the answer.
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#  define CPU_X86 1
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    include <immintrin.h>
+#    define CPU_TARGET_SSE2
+#    define CPU_TARGET_AVX2
+#  else
+#    include <immintrin.h>
+#    define CPU_TARGET_SSE2 __attribute__((target("sse2")))
+#    define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+
+// AVX2 in the CPU and its YMM state enabled by the OS.
+inline bool Cpu_HasAvx2()
+{
+#  if defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    bool osxsave = (r[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#  else
+    return __builtin_cpu_supports("avx2");
+#  endif
+}
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+// damage_accum.h - per-victim damage for one attack.
+// The SDK's gMultiDamage holds a single victim and flushes whenever the
+// next hit lands on someone else, so a shotgun spread over two players or
+// a piercing shot alternating between zombies calls TakeDamage again and
+// again. This keeps up to DMG_ACCUM_MAX victims at once: hits add to their
+// victim's entry (damage summed, type bits OR'd) and Apply hands each
+// victim over exactly once, in first-hit order. Lookup is open addressing
+// over a byte index, so Clear is a 64-byte memset. Portable.
+
+#include <cstdint>
+#include <cstring>
+
+static const int DMG_ACCUM_MAX   = 32;
+static const int DMG_ACCUM_BITS  = 6;
+static const int DMG_ACCUM_SLOTS = 1 << DMG_ACCUM_BITS;   // at least 2 * DMG_ACCUM_MAX
+
+struct DamageEntry
+{
+    void* victim;
+    float damage;
+    int   bits;
+    int   hits;
+};
+
+class DamageAccum
+{
+public:
+    DamageAccum() { Clear(); }
+
+    void Clear()
+    {
+        memset(m_index, 0, sizeof(m_index));
+        m_count = 0;
+    }
+
+    // False when victim is new and every entry is taken; the caller then
+    // applies that hit on its own.
+    bool Add(void* victim, float damage, int bits)
+    {
+        uint32_t h = ((uint32_t)(uintptr_t)victim >> 4) * 0x9E3779B1u >> (32 - DMG_ACCUM_BITS);
+        for (;; h = (h + 1) & (DMG_ACCUM_SLOTS - 1))
+        {
+            int i = m_index[h];
+            if (i && m_entries[i - 1].victim == victim)
+            {
+                DamageEntry& e = m_entries[i - 1];
+                e.damage += damage;
+                e.bits   |= bits;
+                e.hits++;
+                return true;
+            }
+            if (i) continue;
+            if (m_count == DMG_ACCUM_MAX) return false;
+            m_entries[m_count] = { victim, damage, bits, 1 };
+            m_index[h] = (uint8_t)++m_count;
+            return true;
+        }
+    }
+
+    int                Count() const    { return m_count; }
+    const DamageEntry& Entry(int i) const { return m_entries[i]; }
+
+    // fn(const DamageEntry&) once per victim in first-hit order, then Clear.
+    template<typename Fn>
+    void Apply(Fn&& fn)
+    {
+        for (int i = 0; i < m_count; i++) fn(m_entries[i]);
+        Clear();
+    }
+
+private:
+    uint8_t     m_index[DMG_ACCUM_SLOTS];   // entry + 1, 0 = empty
+    int         m_count;
+    DamageEntry m_entries[DMG_ACCUM_MAX];
+};
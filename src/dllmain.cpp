@@ -1,70 +1,185 @@
 // dllmain.cpp
 // DLL injection entry point.
 // Step 4 from the plan: on DLL attach, hook the weapon_janus1 entry point.
-// We wait for the server to be fully running first.
+// Installed from inside the server's first frame once mp.dll loads (attach.h).
 
 #include <windows.h>
+#include "attach.h"
+#include "frame_clock.h"
 #include "hooks.h"
+#include "loader_notify.h"
 #include "logger.h"
+#include "offset_db.h"
+#include "pe_scan.h"
+#include "weapon_alloc.h"
+#include "weapon_db.h"
+#include "platform/platform.h"
 #include "hlsdk/mp_offsets.h"
 
+bool Janus1_Register(HMODULE hMp);
 void Janus1_PostInit(uintptr_t mpBase);
 
+static const char* WEAPON_DB_FILE = "csnz_weapons.wdb";
+static const char* OFFSET_DB_FILE = "csnz_offsets.txt";
+static const DWORD ATTACH_TIMEOUT_MS = 240000;
+static const DWORD ATTACH_POLL_MS    = 500;   // only without notifications / frame hook
+
 static float ReadTime(HMODULE hMp)
 {
     uint32_t pGlobals = 0;
-    __try { pGlobals = *reinterpret_cast<uint32_t*>((uintptr_t)hMp + RVA_pGlobals); }
-    __except(EXCEPTION_EXECUTE_HANDLER) { return -1.f; }
+    if (!Plat_SafeRead(&pGlobals, (uintptr_t)hMp + Ofs_Rva(OFS_Rva_pGlobals), sizeof(pGlobals))) return -1.f;
     if (!pGlobals) return 0.f;
     float t = 0.f;
-    __try { t = *reinterpret_cast<float*>((uintptr_t)pGlobals); }
-    __except(EXCEPTION_EXECUTE_HANDLER) { return -2.f; }
+    if (!Plat_SafeRead(&t, pGlobals, sizeof(t))) return -2.f;
     return t;
 }
 
-static DWORD WINAPI MainThread(LPVOID)
+static void LogOffsetDbError(void*, int line, const char* msg)
 {
-    Log("=== csnz_weapons loaded ===\n");
-    Log("Following approach: HLSDK weapon class, injected DLL, entry point hook\n");
+    LOG_ERROR(main, "%s:%d: %s\n", OFFSET_DB_FILE, line, msg);
+}
 
-    for (int i = 0; i < 480; i++)
-    {
-        Sleep(500);
+// Once per attach, before anything reads an offset: overrides for this
+// mp.dll build from csnz_offsets.txt.
+static void LoadOffsets(HMODULE hMp)
+{
+    PeImage mp;
+    if (!Pe_ParseModule(hMp, mp)) return;
+    int n = OffsetDb_Load(OFFSET_DB_FILE, PeKey_From(mp), LogOffsetDbError, nullptr);
+    if (n > 0)       LOG_INFO(main, "%s: %d offsets overridden\n", OFFSET_DB_FILE, n);
+    else if (n < 0)  LOG_WARN(main, "%s rejected, using built-in offsets\n", OFFSET_DB_FILE);
+    else             LOG_DEBUG(main, "no %s entries for mp %08X, using built-in offsets\n",
+                               OFFSET_DB_FILE, mp.timeDateStamp);
+}
 
-        HMODULE hMp = GetModuleHandleA("mp.dll");
-        if (!hMp) { if (i%10==0) Log("[main] Waiting for mp.dll...\n"); continue; }
+static void OnServerFrame();
 
-        float t = ReadTime(hMp);
-        if (t < 0.1f) { if (i%10==0) Log("[main] Waiting for server (t=%.3f)...\n",t); continue; }
+// AttachMachine's view of the game process.
+struct ProcessAttachHost : AttachHost
+{
+    HMODULE hMp = nullptr;
 
-        Log("[main] Server ready! mp=0x%08zX t=%.3f\n", (uintptr_t)hMp, t);
+    bool ArmFrameHook() override
+    {
+        // Detours registered here go out in the same batch as the weapon hooks.
+        Janus1_Register(hMp);
+        WeaponAlloc_Register(hMp);
+        FrameClock_SetFrameHook(OnServerFrame);
+        if (FrameClock_Arm(hMp)) return true;
+        FrameClock_SetFrameHook(nullptr);
+        return false;
+    }
+    void DisarmFrameHook() override { FrameClock_SetFrameHook(nullptr); }
+    bool ServerReady() override     { return ReadTime(hMp) >= 0.1f; }
+
+    bool Install() override
+    {
+        Janus1_Register(hMp);
+        WeaponAlloc_Register(hMp);
+        FrameClock_Register(hMp);
 
         // Step 4: hook entry points
-        if (!Hooks_Install(hMp))
+        HooksResult r = Hooks_Install(hMp);
+        if (r == HOOKS_FAILED)
         {
-            Log("[main] Hooks_Install failed, retrying...\n");
-            continue;
+            LOG_WARN(main, "Hooks_Install failed, retrying...\n");
+            return false;
         }
-
+        if (r == HOOKS_PARTIAL) LOG_WARN(main, "some detours were left out, their features stay off\n");
         // Post-init per weapon (build vtables, resolve fns)
+        if (!WeaponAlloc_PostInit()) LOG_WARN(main, "weapon slab off, objects stay on the engine heap\n");
         Janus1_PostInit(GetMpBase());
+        Hooks_SaveCache();
+
+        LOG_INFO(main, "All done. Hooks active.\n");
+        return true;
+    }
+};
+
+static ProcessAttachHost g_host;
+static AttachMachine     g_attach(g_host);
+static HANDLE            g_mpLoaded = nullptr;
+
+// Game thread, top of StartFrame, until the machine is done with it.
+static void OnServerFrame()
+{
+    g_attach.OnFrame();
+    if (g_attach.State() == ATTACH_FAILED)
+        LOG_ERROR(main, "giving up after %d install attempts\n", g_attach.Tries());
+}
+
+// Loader lock held: signal or flip state, nothing else.
+static void OnMpNotify(bool loaded, void*, void*)
+{
+    if (loaded) SetEvent(g_mpLoaded);
+    else        g_attach.OnModuleUnloaded();
+}
+
+static DWORD WINAPI MainThread(LPVOID)
+{
+    LOG_INFO(main, "=== csnz_weapons loaded ===\n");
+    LOG_DEBUG(main, "Following approach: HLSDK weapon class, injected DLL, entry point hook\n");
+
+    if (WeaponDb_Open(WEAPON_DB_FILE))
+        LOG_INFO(main, "%s: %d weapon definitions\n", WEAPON_DB_FILE, WeaponDb_Count());
+    else
+        LOG_WARN(main, "%s missing or invalid, using built-in weapon data\n", WEAPON_DB_FILE);
+
+    g_mpLoaded = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    bool notified = g_mpLoaded && LoaderNotify_Watch(L"mp.dll", OnMpNotify, nullptr);
+    if (!notified) LOG_WARN(main, "no loader notifications, polling for mp.dll\n");
 
-        Log("[main] All done. Hooks active.\n");
+    // Already there if we were injected late; otherwise sleep until the
+    // loader reports it.
+    DWORD t0 = GetTickCount();
+    HMODULE hMp;
+    while (!(hMp = GetModuleHandleA("mp.dll")))
+    {
+        if (GetTickCount() - t0 > ATTACH_TIMEOUT_MS) { LOG_ERROR(main, "Timed out waiting for mp.dll.\n"); return 0; }
+        if (notified) WaitForSingleObject(g_mpLoaded, ATTACH_TIMEOUT_MS);
+        else          Sleep(ATTACH_POLL_MS);
+    }
+    // Takes the loader lock, so it returns once mp.dll's DllMain is done;
+    // the extra reference keeps it mapped under our patches.
+    LoadLibraryA("mp.dll");
+    LOG_INFO(main, "mp.dll @ 0x%08zX\n", (uintptr_t)hMp);
+
+    LoadOffsets(hMp);
+    g_host.hMp = hMp;
+    g_attach.OnModuleLoaded();
+    if (g_attach.State() == ATTACH_WAIT_FRAME)
+    {
+        LOG_INFO(main, "installing on the first server frame\n");
         return 0;
     }
 
-    Log("[main] Timed out.\n");
+    LOG_WARN(main, "first-frame hook unavailable, polling for the server\n");
+    for (DWORD t1 = GetTickCount(); g_attach.State() == ATTACH_POLLING; )
+    {
+        if (GetTickCount() - t1 > ATTACH_TIMEOUT_MS) { LOG_ERROR(main, "Timed out.\n"); return 0; }
+        Sleep(ATTACH_POLL_MS);
+        g_attach.OnPollTick();
+    }
+    if (g_attach.State() == ATTACH_FAILED)
+        LOG_ERROR(main, "giving up after %d install attempts\n", g_attach.Tries());
     return 0;
 }
 
-BOOL WINAPI DllMain(HINSTANCE hInst, DWORD reason, LPVOID)
+BOOL WINAPI DllMain(HINSTANCE hInst, DWORD reason, LPVOID reserved)
 {
     if (reason == DLL_PROCESS_ATTACH)
     {
-        Log("[main] DLL_PROCESS_ATTACH\n");
+        LOG_INFO(main, "DLL_PROCESS_ATTACH\n");
         DisableThreadLibraryCalls(hInst);
         HANDLE h = CreateThread(nullptr, 0, MainThread, nullptr, 0, nullptr);
         if (h) CloseHandle(h);
     }
+    else if (reason == DLL_PROCESS_DETACH)
+    {
+        LOG_INFO(main, "DLL_PROCESS_DETACH\n");
+        // The notification would otherwise call into our unmapped code.
+        LoaderNotify_Stop();
+        Log_FlushAtExit(reserved != nullptr);
+    }
     return TRUE;
 }
@@ -0,0 +1,101 @@
+#pragma once
+// field_layout.h - typed descriptors for fields of game objects we don't own.
+// A layout is declared once as an X-macro list of (name, type, offset):
+//
+//   #define MY_FIELDS(X) X(iClip, int, 0x15C) X(flIdle, float, 0x18C)
+//   FIELD_LAYOUT(MyF, MY_FIELDS)
+//
+// which yields MyF::iClip (a FieldDesc), MyF::fields[] (name/offset/size for
+// reports) and static_asserts that no two fields overlap and each offset is
+// aligned for its type. Fld<MyF::iClip>(obj) is an int&, so the compiler
+// sees a typed lvalue instead of a byte offset cast at every use.
+// Layouts built with FIELD_LAYOUT_EX can give each field a slot in
+// g_offsets[] (offset_db.h); Fld<> then reads the offset from there, one
+// load and an add, and the declared offset is only the default. The table
+// is a mutable global, so that load is repeated after every store or call;
+// code touching one field on many objects takes Fld_Offset<F>() once and
+// passes it to Fld<F>(obj, off).
+
+#include <cstdint>
+#include <type_traits>
+
+// Sizes as seen by the 32-bit game, whatever we're compiled as.
+template<typename T>
+constexpr int Fld_Size()  { return std::is_pointer<T>::value ? 4 : (int)sizeof(T); }
+template<typename T>
+constexpr int Fld_Align() { return std::is_pointer<T>::value ? 4 : (int)alignof(T); }
+
+// Runtime offsets, indexed by FieldDesc::id (defined in offset_db.cpp).
+extern int32_t g_offsets[];
+
+template<typename T, int Off, int Id = -1>
+struct FieldDesc
+{
+    using type = T;
+    static constexpr int offset = Off;
+    static constexpr int size   = Fld_Size<T>();
+    static constexpr int id     = Id;   // -1 = fixed at compile time
+};
+
+template<typename F>
+inline int Fld_Offset()
+{
+    if constexpr (F::id >= 0) return g_offsets[F::id];
+    else                      return F::offset;
+}
+
+template<typename F>
+inline typename F::type& Fld(void* obj, int off)
+{
+    return *reinterpret_cast<typename F::type*>(reinterpret_cast<uint8_t*>(obj) + off);
+}
+
+template<typename F>
+inline typename F::type& Fld(void* obj)
+{
+    return Fld<F>(obj, Fld_Offset<F>());
+}
+
+struct FieldInfo
+{
+    const char* name;
+    int         offset;
+    int         size;
+    int         align;
+};
+
+// Index of the first field that overlaps an earlier one, -1 if none.
+constexpr int Layout_FirstOverlap(const FieldInfo* f, int n)
+{
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < i; j++)
+            if (f[i].offset < f[j].offset + f[j].size && f[j].offset < f[i].offset + f[i].size)
+                return i;
+    return -1;
+}
+
+// Index of the first negative or misaligned field, -1 if none.
+constexpr int Layout_FirstMisaligned(const FieldInfo* f, int n)
+{
+    for (int i = 0; i < n; i++)
+        if (f[i].offset < 0 || f[i].offset % f[i].align) return i;
+    return -1;
+}
+
+#define FIELD_LAYOUT_DESC(name, type, off) using name = FieldDesc<type, off>;
+#define FIELD_LAYOUT_INFO(name, type, off) { #name, off, Fld_Size<type>(), Fld_Align<type>() },
+
+// DESC(name, type, off) declares the member alias, e.g. to attach an id.
+#define FIELD_LAYOUT(Layout, LIST) FIELD_LAYOUT_EX(Layout, LIST, FIELD_LAYOUT_DESC)
+
+#define FIELD_LAYOUT_EX(Layout, LIST, DESC)                                          \
+    struct Layout                                                                    \
+    {                                                                                \
+        LIST(DESC)                                                                   \
+        static constexpr FieldInfo fields[] = { LIST(FIELD_LAYOUT_INFO) };           \
+        static constexpr int       count    = (int)(sizeof(fields) / sizeof(fields[0])); \
+    };                                                                               \
+    static_assert(Layout_FirstOverlap(Layout::fields, Layout::count) < 0,           \
+                  #Layout ": fields overlap");                                       \
+    static_assert(Layout_FirstMisaligned(Layout::fields, Layout::count) < 0,        \
+                  #Layout ": misaligned field");
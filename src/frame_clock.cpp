@@ -0,0 +1,93 @@
+// frame_clock.cpp - StartFrame detour that snapshots gpGlobals
+#include "frame_clock.h"
+#include "game_api.h"
+#include "hooks.h"
+#include "logger.h"
+#include "platform/platform.h"
+#include "hlsdk/sdk.h"
+
+typedef void (__cdecl* StartFrameFn)();
+
+FrameClock g_frameClock;
+
+static uintptr_t            g_rvaStartFrame = 0;
+static volatile FrameHookFn g_frameHook     = nullptr;
+
+// g_pTime is &gpGlobals->time; frametime follows it (globalvars_t).
+static void Snapshot()
+{
+    float tf[2];
+    if (g_pTime && Plat_SafeRead(tf, (uintptr_t)g_pTime, sizeof(tf)))
+    {
+        g_frameClock.time      = tf[0];
+        g_frameClock.frametime = tf[1];
+        g_frameClock.frame++;
+    }
+}
+
+static void __cdecl Hook_StartFrame()
+{
+    // Snapshot first, so the frame hook reads this frame's time. The hook
+    // may be the install that resolves g_pTime; then snapshot once it has,
+    // so the rest of this frame doesn't fall back to live reads.
+    bool hadTime = g_pTime != nullptr;
+    Snapshot();
+    if (FrameHookFn fn = g_frameHook)
+    {
+        fn();
+        if (!hadTime) Snapshot();
+    }
+
+    auto orig = (StartFrameFn)GetOriginal(g_rvaStartFrame);
+    if (orig) orig();
+}
+
+bool FrameClock_Register(HMODULE hMp)
+{
+    if (g_rvaStartFrame) return true;
+
+    GameApi api;
+    if (!GameApi_Query(hMp, api) || !api.hasDll || !api.dll[DLLFN_StartFrame])
+    {
+        LOG_WARN(hooks, "frame clock disabled: no StartFrame, time reads stay live\n");
+        return false;
+    }
+    uintptr_t rva = (uintptr_t)api.dll[DLLFN_StartFrame] - (uintptr_t)hMp;
+    if (!RegisterDetour(hMp, "StartFrame", (void*)Hook_StartFrame, rva)) return false;
+    g_rvaStartFrame = rva;
+    return true;
+}
+
+bool FrameClock_Arm(HMODULE hMp)
+{
+    return FrameClock_Register(hMp) && Hooks_InstallOne(hMp, g_rvaStartFrame);
+}
+
+void FrameClock_SetFrameHook(FrameHookFn fn)
+{
+    g_frameHook = fn;
+}
+
+float FrameClock_ReadLive()
+{
+    if (!g_pTime) return 0.f;
+    float t = 0.f;
+    return Plat_SafeRead(&t, (uintptr_t)g_pTime, sizeof(t)) ? t : 0.f;
+}
+
+// Reads happen inside the frame the snapshot was taken in, so any gap
+// larger than one frame means StartFrame stopped reaching us.
+void FrameClock_Validate()
+{
+    static uint32_t warnedFrame = 0;
+    const FrameClock c = g_frameClock;
+    if (!c.frame || c.frame == warnedFrame) return;
+
+    float live = FrameClock_ReadLive();
+    float slack = c.frametime > 0.f ? c.frametime : 0.1f;
+    if (live - c.time > slack)
+    {
+        warnedFrame = c.frame;
+        LOG_WARN(hooks, "frame clock stale: snapshot %.3f (frame %u), live %.3f\n", c.time, c.frame, live);
+    }
+}
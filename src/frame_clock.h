@@ -0,0 +1,44 @@
+#pragma once
+// frame_clock.h - gpGlobals->time / frametime, captured once per server frame.
+// A StartFrame detour copies both into g_frameClock before the game's own
+// StartFrame runs, so everything during the frame reads one cache line: no
+// SEH frame, no trip into the engine's globals. Until the first frame (or
+// if the detour couldn't be installed) Clock_Time falls back to a guarded
+// live read.
+// Build with CSNZ_CLOCK_VALIDATE to compare every read against the live
+// value and log when the snapshot is stale.
+
+#include <windows.h>
+#include <cstdint>
+
+struct alignas(64) FrameClock
+{
+    float    time;
+    float    frametime;
+    uint32_t frame;       // StartFrame calls seen, 0 = not running
+};
+
+extern FrameClock g_frameClock;
+
+typedef void (*FrameHookFn)();
+
+// Must run before Hooks_Install. Safe to call again after a failed install.
+bool  FrameClock_Register(HMODULE hMp);
+// Register and patch the detour right away, before the server runs, so
+// the frame hook below sees the very first frame.
+bool  FrameClock_Arm(HMODULE hMp);
+// Called every StartFrame while set, after the snapshot (game thread).
+void  FrameClock_SetFrameHook(FrameHookFn fn);
+float FrameClock_ReadLive();          // guarded gpGlobals->time, 0 if unavailable
+void  FrameClock_Validate();
+
+inline float Clock_Time()
+{
+#ifdef CSNZ_CLOCK_VALIDATE
+    FrameClock_Validate();
+#endif
+    return g_frameClock.frame ? g_frameClock.time : FrameClock_ReadLive();
+}
+
+inline float    Clock_FrameTime() { return g_frameClock.frametime; }
+inline uint32_t Clock_Frame()     { return g_frameClock.frame; }
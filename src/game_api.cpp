@@ -0,0 +1,30 @@
+// game_api.cpp - GetEntityAPI(2) / GetNewDLLFunctions queries against mp.dll
+#include "game_api.h"
+#include <cstring>
+
+typedef int (__cdecl* GetEntityApiFn)(void** table, int version);
+typedef int (__cdecl* GetEntityApi2Fn)(void** table, int* version);
+typedef int (__cdecl* GetNewDllFunctionsFn)(void** table, int* version);
+
+static const int INTERFACE_VERSION_DLL = 140;
+static const int INTERFACE_VERSION_NEW = 1;
+
+bool GameApi_Query(HMODULE hMp, GameApi& out)
+{
+    memset(&out, 0, sizeof(out));
+    auto api2 = (GetEntityApi2Fn)GetProcAddress(hMp, "GetEntityAPI2");
+    auto api1 = (GetEntityApiFn)GetProcAddress(hMp, "GetEntityAPI");
+    auto api3 = (GetNewDllFunctionsFn)GetProcAddress(hMp, "GetNewDLLFunctions");
+
+    __try
+    {
+        int ver = INTERFACE_VERSION_DLL;
+        if (api2)      out.hasDll = api2(out.dll, &ver) != 0;
+        else if (api1) out.hasDll = api1(out.dll, INTERFACE_VERSION_DLL) != 0;
+
+        ver = INTERFACE_VERSION_NEW;
+        if (api3) out.hasNewDll = api3(out.newDll, &ver) != 0;
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {}
+    return out.hasDll || out.hasNewDll;
+}
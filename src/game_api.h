@@ -0,0 +1,28 @@
+#pragma once
+// game_api.h - mp.dll's exported engine interface tables.
+// Asks mp.dll for the same DLL_FUNCTIONS / NEW_DLL_FUNCTIONS tables the
+// engine got at load, so we learn where the game's callbacks live and can
+// detour them. Tables are kept as raw pointer arrays (eiface.h order):
+// we only need a few slots, and CSNZ may have appended to both.
+
+#include <windows.h>
+
+static const int GAMEAPI_SLOTS = 128;   // larger than either table
+
+// DLL_FUNCTIONS
+static const int DLLFN_ServerActivate   = 21;
+static const int DLLFN_ServerDeactivate = 22;
+static const int DLLFN_StartFrame       = 25;
+// NEW_DLL_FUNCTIONS
+static const int NEWDLLFN_OnFreeEntPrivateData = 0;
+
+struct GameApi
+{
+    void* dll[GAMEAPI_SLOTS];
+    void* newDll[GAMEAPI_SLOTS];
+    bool  hasDll;
+    bool  hasNewDll;
+};
+
+// Fills what mp.dll exports. False if neither table could be read.
+bool GameApi_Query(HMODULE hMp, GameApi& out);
@@ -0,0 +1,41 @@
+// hitscan.cpp - spread, batched traces, per-victim damage
+#include "hitscan.h"
+#include "damage_accum.h"
+#include "spread.h"
+
+static_assert(HS_MAX_PELLETS <= DMG_ACCUM_MAX, "a volley must fit the accumulator");
+
+int Hitscan_Fire(HitscanWorld& w, const HsVolley& v, HsHit* hits)
+{
+    int n = v.pellets < HS_MAX_PELLETS ? v.pellets : HS_MAX_PELLETS;
+    if (n <= 0) return 0;
+
+    SpreadParams sp = { v.forward.x, v.forward.y, v.forward.z, v.right.x, v.right.y, v.right.z,
+                        v.up.x, v.up.y, v.up.z, v.spreadX, v.spreadY, v.seed, 0 };
+    float dx[HS_MAX_PELLETS], dy[HS_MAX_PELLETS], dz[HS_MAX_PELLETS];
+    Spread_Directions(sp, n, dx, dy, dz);
+
+    HsRay rays[HS_MAX_PELLETS];
+    for (int i = 0; i < n; i++)
+    {
+        rays[i].start = v.src;
+        rays[i].end   = { v.src.x + dx[i] * v.range, v.src.y + dy[i] * v.range, v.src.z + dz[i] * v.range };
+    }
+
+    HsHit local[HS_MAX_PELLETS];
+    HsHit* out = hits ? hits : local;
+    w.TraceBatch(rays, n, v.shooter, out);
+
+    DamageAccum acc;
+    for (int i = 0; i < n; i++)
+    {
+        void* e = out[i].entity;
+        if (!e || out[i].fraction >= 1.0f) continue;
+        // n <= DMG_ACCUM_MAX, never full
+        acc.Add(e, v.damage * w.HitgroupScale(e, out[i].hitgroup), v.dmgBits);
+    }
+
+    int victims = acc.Count();
+    acc.Apply([&](const DamageEntry& e) { w.ApplyDamage(e.victim, e.damage, e.bits, e.hits); });
+    return victims;
+}
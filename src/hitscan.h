@@ -0,0 +1,74 @@
+#pragma once
+// hitscan.h - batched hitscan for multi-pellet and high-ROF weapons.
+// The SDK's FireBullets path does trace, AddMultiDamage, next pellet, and
+// flushes gMultiDamage every time the victim changes. Here a volley runs
+// in three passes:
+//   1. every pellet's direction, four at a time (spread.h)
+//   2. every trace, in one call to the world
+//   3. hits scaled by hitgroup and summed per victim (damage_accum.h), one
+//      ApplyDamage each
+// The world is an interface: the game process or a fake world for running
+// the pipeline off the engine. Portable.
+
+#include <cstdint>
+
+static const int HS_MAX_PELLETS = 32;   // <= DMG_ACCUM_MAX
+
+struct HsVec { float x, y, z; };
+
+// HITGROUP_* (hlsdk), what the trace reports in HsHit::hitgroup.
+enum HsHitgroup
+{
+    HS_HIT_GENERIC, HS_HIT_HEAD, HS_HIT_CHEST, HS_HIT_STOMACH,
+    HS_HIT_LEFTARM, HS_HIT_RIGHTARM, HS_HIT_LEFTLEG, HS_HIT_RIGHTLEG,
+    HS_HITGROUPS
+};
+// CBasePlayer::TraceAttack's damage multipliers, by hitgroup.
+static const float HS_PLAYER_SCALE[HS_HITGROUPS] = { 1.0f, 4.0f, 1.0f, 1.25f, 1.0f, 1.0f, 0.75f, 0.75f };
+
+struct HsRay
+{
+    HsVec start, end;
+};
+
+struct HsHit
+{
+    float fraction;       // 1 = nothing hit
+    HsVec endPos;
+    void* entity;         // null = world / nothing
+    int   hitgroup;
+};
+
+// Backend: the engine or a simulation.
+struct HitscanWorld
+{
+    virtual ~HitscanWorld() {}
+    // out[i] is the result for rays[i]; skip is never hit (the shooter).
+    virtual void TraceBatch(const HsRay* rays, int n, void* skip, HsHit* out) = 0;
+    // What a pellet's damage is multiplied by where it hit; TraceAttack's
+    // job in the SDK flow. Players by default, anything else overrides.
+    virtual float HitgroupScale(void* /*victim*/, int hitgroup)
+    {
+        return hitgroup >= 0 && hitgroup < HS_HITGROUPS ? HS_PLAYER_SCALE[hitgroup] : 1.0f;
+    }
+    // Once per victim per volley, with every pellet's damage summed, in
+    // the order the victims were first hit.
+    virtual void ApplyDamage(void* victim, float damage, int dmgBits, int hits) = 0;
+};
+
+struct HsVolley
+{
+    HsVec    src;
+    HsVec    forward, right, up;   // aim basis (MakeVectors)
+    float    spreadX, spreadY;     // VECTOR_CONE_* x / y
+    float    range;
+    float    damage;               // per pellet, before the hitgroup scale
+    int      dmgBits;
+    int      pellets;              // clamped to HS_MAX_PELLETS
+    uint32_t seed;                 // shared random seed of the shot
+    void*    shooter;
+};
+
+// Run one volley. hits (optional, HS_MAX_PELLETS long) receives the trace
+// results for decals and effects. Returns the number of victims damaged.
+int  Hitscan_Fire(HitscanWorld& w, const HsVolley& v, HsHit* hits);
@@ -0,0 +1,76 @@
+#pragma once
+// csnz_layout.h - CSNZ object field offsets (IDA), as typed descriptors.
+//   Fld<WpnF::iClip>(weapon) = 30;
+//   if (Fld<PlrF::frozen>(player)) ...
+// Portable (no windows.h) so host tools can report on the layouts.
+// WpnF/PlrF offsets are runtime-overridable (offset_db.h); ReconF is fixed.
+
+#include "../field_layout.h"
+#include "mp_offsets.h"
+
+class CBasePlayer;
+
+// CBasePlayerWeapon / CBasePlayerItem
+#define CSNZ_WEAPON_FIELDS(X)                                                 \
+    X(pev,              void*,        0x008)  /* edict ptr in CSNZ, set by factory */ \
+    X(pPlayer,          CBasePlayer*, 0x0D0)                                  \
+    X(iId,              int,          0x0E4)  /* weapon ID */                 \
+    X(flNextPrimary,    float,        0x13C)                                  \
+    X(flNextSecondary,  float,        0x140)                                  \
+    X(iPrimaryAmmoType, int,          0x14C)                                  \
+    X(iAmmo,            int,          0x154)  /* primary ammo */              \
+    X(iClip,            int,          0x15C)                                  \
+    X(flTimeIdle,       float,        0x18C)                                  \
+    X(iShotCount,       int,          0x194)                                  \
+    X(iConfigId,        int,          0x1D8)                                  \
+    X(usFireEvent,      uint16_t,     0x1E8)  /* PRECACHE_EVENT handle */     \
+    X(flChargeState,    float,        0x1FC)
+
+// CBasePlayer
+#define CSNZ_PLAYER_FIELDS(X)                                                 \
+    X(deadflag,         uint8_t,      0xEC4)                                  \
+    X(frozen,           uint8_t,      0x185D)
+
+// The ReGameDLL-based reconstruction in cso_baseweapon.h, same names where
+// a field has a counterpart above. Only used to report the differences
+// (csnz_layoutdiff); nothing should read objects through it.
+#define RECON_WEAPON_FIELDS(X)                                                \
+    X(pev,                void*,        0x04)                                 \
+    X(pPlayer,            CBasePlayer*, 0x2C)                                 \
+    X(iId,                int,          0x34)                                 \
+    X(flNextPrimary,      float,        0x40)                                 \
+    X(flNextSecondary,    float,        0x44)                                 \
+    X(flTimeIdle,         float,        0x48)                                 \
+    X(iPrimaryAmmoType,   int,          0x4C)                                 \
+    X(iSecondaryAmmoType, int,          0x50)                                 \
+    X(iClip,              int,          0x54)                                 \
+    X(fInReload,          int,          0x60)                                 \
+    X(iDefaultAmmo,       int,          0x68)                                 \
+    X(flAccuracy,         float,        0x80)                                 \
+    X(flLastFire,         float,        0x84)                                 \
+    X(iShotCount,         int,          0x88)  /* m_iShotsFired */            \
+    X(iWeaponState,       int,          0xB0)                                 \
+    X(usFireEvent,        uint16_t,     0xC8)  /* first byte after m_flLastFireTime */
+
+// One slot per overridable offset, in g_offsets[].
+#define OFS_ID_WPN(name, type, off) OFS_Wpn_##name,
+#define OFS_ID_PLR(name, type, off) OFS_Plr_##name,
+#define OFS_ID_RVA(name, rva)       OFS_Rva_##name,
+enum OffsetId
+{
+    CSNZ_WEAPON_FIELDS(OFS_ID_WPN)
+    CSNZ_PLAYER_FIELDS(OFS_ID_PLR)
+    MP_RVAS(OFS_ID_RVA)
+    OFS_COUNT
+};
+#undef OFS_ID_WPN
+#undef OFS_ID_PLR
+#undef OFS_ID_RVA
+
+#define WPN_DESC(name, type, off) using name = FieldDesc<type, off, OFS_Wpn_##name>;
+#define PLR_DESC(name, type, off) using name = FieldDesc<type, off, OFS_Plr_##name>;
+FIELD_LAYOUT_EX(WpnF, CSNZ_WEAPON_FIELDS, WPN_DESC)
+FIELD_LAYOUT_EX(PlrF, CSNZ_PLAYER_FIELDS, PLR_DESC)
+FIELD_LAYOUT(ReconF, RECON_WEAPON_FIELDS)
+#undef WPN_DESC
+#undef PLR_DESC
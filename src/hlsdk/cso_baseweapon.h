@@ -3,8 +3,11 @@
 // CBaseEntity → CBaseDelay → CBaseAnimating → CBasePlayerItem → CBasePlayerWeapon
 // Reconstructed from ReGameDLL source + IDA field offsets
 // This matches the real CSNZ server memory layout.
+// NOTE: the member offsets below disagree with the IDA offsets in
+// csnz_layout.h (run csnz_layoutdiff); access live objects through Fld<>.
 
 #include "sdk.h"
+#include <cstddef>
 
 // -----------------------------------------------------------------------
 // Forward declarations
@@ -14,60 +17,11 @@ class CBasePlayerItem;
 class CBasePlayerWeapon;
 class CBasePlayer;
 
-// -----------------------------------------------------------------------
-// ItemInfo — passed to GetItemInfo()
-// -----------------------------------------------------------------------
-struct ItemInfo
-{
-    int         iSlot;
-    int         iPosition;
-    const char* pszAmmo1;
-    int         iMaxAmmo1;
-    const char* pszAmmo2;
-    int         iMaxAmmo2;
-    const char* pszName;
-    int         iMaxClip;
-    int         iId;
-    int         iFlags;
-    int         iWeight;
-};
-
 // -----------------------------------------------------------------------
 // WEAPON_NOCLIP
 // -----------------------------------------------------------------------
 #define WEAPON_NOCLIP  -1
 
-// -----------------------------------------------------------------------
-// CSNZ edict helpers
-//
-// IDA CONFIRMED offsets (from disasm of weapon_janus1 factory):
-//   mov ecx, [esi+238h]       => edict* = *(pev + 0x238)
-//   cmp [ecx+80h], 0          => pvPrivateData at edict+0x80
-//
-// In CSNZ, pev is NOT inline inside edict_t; it's separately allocated.
-// The edict backpointer is stored at pev+0x238 (maps to entvars_t::gamestate
-// in the struct definition but is actually repurposed in CSNZ as edict ptr).
-// pvPrivateData (the C++ object) is at edict+0x80 (not standard GoldSrc 0x10).
-// -----------------------------------------------------------------------
-#define CSNZ_PEV_TO_EDICT_OFFSET  0x238   // edict* ptr stored at pev+0x238
-#define CSNZ_PVPRIVATE_OFFSET     0x80    // pvPrivateData in edict_t at +0x80
-
-inline edict_t* PEV_TO_EDICT(entvars_t* pev)
-{
-    if (!pev) return nullptr;
-    // Read edict pointer stored at pev+0x238 (IDA confirmed)
-    return *reinterpret_cast<edict_t**>(
-        reinterpret_cast<uint8_t*>(pev) + CSNZ_PEV_TO_EDICT_OFFSET);
-}
-
-inline void* EDICT_PRIVATE(edict_t* e)
-{
-    if (!e) return nullptr;
-    // pvPrivateData at edict+0x80 (IDA confirmed)
-    return *reinterpret_cast<void**>(
-        reinterpret_cast<uint8_t*>(e) + CSNZ_PVPRIVATE_OFFSET);
-}
-
 // -----------------------------------------------------------------------
 // CBaseEntity
 // -----------------------------------------------------------------------
@@ -82,7 +36,7 @@ public:
     // Virtual methods (subset — must match CSNZ's vtable order exactly)
     virtual void Spawn()        {}
     virtual void Precache()     {}
-    virtual void KeyValue(void* pkvd) {}
+    virtual void KeyValue(void* /*pkvd*/) {}
     virtual int  Save(void*)    { return 0; }
     virtual int  Restore(void*) { return 0; }
     virtual void SetObjectCollisionBox() {}
@@ -128,10 +82,11 @@ public:
     virtual CBaseEntity* Respawn() { return nullptr; }
     virtual void UpdateOnRemove() {}
     virtual BOOL FBecomeProne(CBaseEntity*) { return FALSE; }
-    virtual Vector Center() { return pev ? pev->origin : Vector(); }
-    virtual Vector EyePosition() { return pev ? pev->origin : Vector(); }
-    virtual Vector EarPosition() { return pev ? pev->origin : Vector(); }
-    virtual Vector BodyTarget(const Vector&) { return pev ? pev->origin : Vector(); }
+    // pev->origin in the SDK; entvars_t is opaque here (engine_types.h)
+    virtual Vector Center() { return Vector(); }
+    virtual Vector EyePosition() { return Vector(); }
+    virtual Vector EarPosition() { return Vector(); }
+    virtual Vector BodyTarget(const Vector&) { return Vector(); }
     virtual int  Illumination() { return 0; }
     virtual BOOL FVisible(CBaseEntity*) { return FALSE; }
     virtual BOOL FVisible(const Vector&) { return FALSE; }
@@ -175,7 +130,7 @@ public:
     virtual BOOL Deploy() { return TRUE; }
     virtual BOOL CanDeploy() { return TRUE; }
     virtual BOOL IsWeapon() { return FALSE; }
-    virtual void Holster(int skiplocal = 0) {}
+    virtual void Holster(int /*skiplocal*/ = 0) {}
     virtual void UpdateItemInfo() {}
     virtual void ItemPostFrame() {}
     virtual int  PrimaryAmmoIndex() { return -1; }
@@ -216,7 +171,7 @@ public:
     virtual int  AddWeapon() { ExtractAmmo(this); return 1; }
     virtual BOOL PlayEmptySound() { return TRUE; }
     virtual void ResetEmptySound() {}
-    virtual void SendWeaponAnim(int iAnim, int skiplocal = 0) {}
+    virtual void SendWeaponAnim(int /*iAnim*/, int /*skiplocal*/ = 0) {}
     virtual BOOL IsUseable() { return TRUE; }
     virtual void PrimaryAttack()   {}
     virtual void SecondaryAttack() {}
@@ -293,3 +248,32 @@ public:
     // byte offset (from IDA) and use Field<T>(this, offset) to access it.
     int m_rgAmmo[32];   // ammo array — needed by some weapon logic
 };
+
+// -----------------------------------------------------------------------
+// RECON_WEAPON_FIELDS (csnz_layout.h) is this class's layout as
+// csnz_layoutdiff reports it; the two must not drift. Only the 32-bit game
+// build has the real member offsets.
+// -----------------------------------------------------------------------
+#if defined(_WIN32) && !defined(_WIN64)
+#define RECON_CHECK(field, member)                                            \
+    static_assert(offsetof(CBasePlayerWeapon, member) == ReconF::field::offset, \
+                  "RECON_WEAPON_FIELDS " #field " is not at " #member);
+RECON_CHECK(pev,                pev)
+RECON_CHECK(pPlayer,            m_pPlayer)
+RECON_CHECK(iId,                m_iId)
+RECON_CHECK(flNextPrimary,      m_flNextPrimaryAttack)
+RECON_CHECK(flNextSecondary,    m_flNextSecondaryAttack)
+RECON_CHECK(flTimeIdle,         m_flTimeWeaponIdle)
+RECON_CHECK(iPrimaryAmmoType,   m_iPrimaryAmmoType)
+RECON_CHECK(iSecondaryAmmoType, m_iSecondaryAmmoType)
+RECON_CHECK(iClip,              m_iClip)
+RECON_CHECK(fInReload,          m_fInReload)
+RECON_CHECK(iDefaultAmmo,       m_iDefaultAmmo)
+RECON_CHECK(flAccuracy,         m_flAccuracy)
+RECON_CHECK(flLastFire,         m_flLastFire)
+RECON_CHECK(iShotCount,         m_iShotsFired)
+RECON_CHECK(iWeaponState,       m_iWeaponState)
+RECON_CHECK(usFireEvent,        m_usFireEvent)
+#undef RECON_CHECK
+static_assert(ReconF::count == 16, "new RECON_WEAPON_FIELDS entry: check it above");
+#endif
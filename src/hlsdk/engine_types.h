@@ -0,0 +1,106 @@
+#pragma once
+// engine_types.h - the engine structures we touch, without windows.h.
+// Shared by sdk.h (the injected DLL) and the mock engine the core tests
+// run against (tests/mock_engine.h).
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------
+// Engine types (from HL SDK eiface.h / progdefs.h)
+// -----------------------------------------------------------------------
+typedef float   vec_t;
+struct Vector { float x, y, z; };
+
+typedef int string_t;   // offset into the engine's string pool
+
+struct entvars_s
+{
+    // Only fields we actually use — full struct is 756 bytes
+    // We access most things via raw offsets anyway
+    char        classname[4]; // actually a string_t (int)
+    // ... (we won't use this struct directly)
+};
+typedef struct entvars_s entvars_t;
+
+struct edict_s
+{
+    int         free;
+    int         serialnumber;
+    // link_t, ... 
+    // We don't need the full layout; access via engfuncs
+};
+typedef struct edict_s edict_t;
+
+// -----------------------------------------------------------------------
+// CSNZ edict helpers
+//
+// IDA CONFIRMED offsets (from disasm of weapon_janus1 factory):
+//   mov ecx, [esi+238h]       => edict* = *(pev + 0x238)
+//   cmp [ecx+80h], 0          => pvPrivateData at edict+0x80
+//
+// In CSNZ, pev is NOT inline inside edict_t; it's separately allocated.
+// The edict backpointer is stored at pev+0x238 (maps to entvars_t::gamestate
+// in the struct definition but is actually repurposed in CSNZ as edict ptr).
+// pvPrivateData (the C++ object) is at edict+0x80 (not standard GoldSrc 0x10).
+// -----------------------------------------------------------------------
+#define CSNZ_PEV_TO_EDICT_OFFSET  0x238   // edict* ptr stored at pev+0x238
+#define CSNZ_PVPRIVATE_OFFSET     0x80    // pvPrivateData in edict_t at +0x80
+
+inline edict_t* PEV_TO_EDICT(entvars_t* pev)
+{
+    if (!pev) return nullptr;
+    // Read edict pointer stored at pev+0x238 (IDA confirmed)
+    return *reinterpret_cast<edict_t**>(
+        reinterpret_cast<uint8_t*>(pev) + CSNZ_PEV_TO_EDICT_OFFSET);
+}
+
+inline void* EDICT_PRIVATE(edict_t* e)
+{
+    if (!e) return nullptr;
+    // pvPrivateData at edict+0x80 (IDA confirmed)
+    return *reinterpret_cast<void**>(
+        reinterpret_cast<uint8_t*>(e) + CSNZ_PVPRIVATE_OFFSET);
+}
+
+// Head of globalvars_t; g_pTime points at time, frametime follows it.
+struct globalvars_head_t
+{
+    float       time;
+    float       frametime;
+    float       force_retouch;
+    int         mapname;      // string_t
+};
+
+// -----------------------------------------------------------------------
+// Engine function table (subset — only what our weapon uses). Slots we
+// don't call are padding, so the named ones keep eiface.h's indices.
+// -----------------------------------------------------------------------
+struct enginefuncs_t
+{
+    int   (*pfnPrecacheModel)(const char* s);           // [0]
+    int   (*pfnPrecacheSound)(const char* s);           // [1]
+    void  (*pfnSetModel)(edict_t* e, const char* m);    // [2]
+    void* unused3[63 - 3];
+    void* (*pfnPvAllocEntPrivateData)(edict_t* e, int32_t cb);       // [63]
+    void* unused64[122 - 64];
+    unsigned short (*pfnPrecacheEvent)(int type, const char* psz);  // [122]
+    // ... 218 total, we only need a few
+};
+
+// -----------------------------------------------------------------------
+// ItemInfo — passed to GetItemInfo() (game DLL, same layout in CSNZ)
+// -----------------------------------------------------------------------
+struct ItemInfo
+{
+    int         iSlot;
+    int         iPosition;
+    const char* pszAmmo1;
+    int         iMaxAmmo1;
+    const char* pszAmmo2;
+    int         iMaxAmmo2;
+    const char* pszName;
+    int         iMaxClip;
+    int         iId;
+    int         iFlags;
+    int         iWeight;
+};
@@ -1,29 +1,37 @@
 #pragma once
 #include <cstdint>
 
-// mp.dll RVAs (imagebase 0x10000000, confirmed from IDA)
-static const uintptr_t RVA_weapon_janus1       = 0x0E96640; // factory entry point we hook
-static const uintptr_t RVA_weapon_m79          = 0x0F29F30; // M79 factory (reference impl)
-static const uintptr_t RVA_pGlobals            = 0x1E51BCC; // ptr to globalvars_t
-static const uintptr_t RVA_UTIL_WeaponTimeBase = 0x058A0B0;
-static const uintptr_t RVA_GetWeaponConfig     = 0x0576870;
-static const uintptr_t RVA_BaseAddToPlayer     = 0x0576FB0;
+// mp.dll RVAs (imagebase 0x10000000, confirmed from IDA). These are the
+// compiled-in defaults; csnz_offsets.txt can override any of them per mp.dll
+// build (offset_db.h). Names match the signature / address cache names.
+#define MP_RVAS(X)                                                           \
+    X(weapon_janus1,       0x0E96640)  /* factory entry point we hook */   \
+    X(weapon_m79,          0x0F29F30)  /* M79 factory (reference impl) */  \
+    X(pGlobals,            0x1E51BCC)  /* ptr to globalvars_t */           \
+    X(UTIL_WeaponTimeBase, 0x058A0B0)                                      \
+    X(GetWeaponConfig,     0x0576870)                                      \
+    X(BaseAddToPlayer,     0x0576FB0)                                      \
+    X(CJanus1_vtable,      0x1649034)  /* see note below */
+
+#define MP_RVA_CONST(name, rva) static const uintptr_t RVA_##name = rva;
+MP_RVAS(MP_RVA_CONST)
+#undef MP_RVA_CONST
+
 static const uintptr_t RVA_PrecacheModel       = 0x0000000; // from engfuncs — set at runtime
 static const uintptr_t RVA_PrecacheSound       = 0x0000001; // from engfuncs — set at runtime
 
-// Janus-1 weapon ID
-static const int WEAPON_JANUS1 = 570; // from game data (adjust if needed)
-
-// Janus-1 assets (from IDA Precache dump)
-#define JANUS1_MODEL_V  "models/v_janus1.mdl"
-#define JANUS1_MODEL_P  "models/p_janus1.mdl"
-#define JANUS1_MODEL_W  "models/w_janus1.mdl"
-#define JANUS1_SOUND_FIRE  "weapons/janus1-1.wav"
-#define JANUS1_SOUND_RELOAD "weapons/janus1_reload.wav"
-#define JANUS1_EVENT    "events/janus1.sc"
+// CBasePlayerWeapon vtable slots, shared by every weapon class
+static const int SLOT_Precache    = 1;    // CBaseEntity: Spawn, Precache, ...
+static const int SLOT_AddToPlayer = 95;
+static const int SLOT_GetItemInfo = 97;   // ReGameDLL order from AddToPlayer; not yet checked in game
+static const int SLOT_Deploy      = 102;
+static const int SLOT_WeaponIdle  = 142;
+static const int SLOT_Holster     = 168;
+// Highest slot + 1 that hook tables may touch. Keep it tight so a typo in a
+// slot number fails to compile instead of patching past the table.
+static const int WEAPON_VTABLE_SLOTS = 176;
 
-// Janus1 original vtable - from log: orig_vtable=0x24689034, mp=0x235E0000
+// Janus1 original vtable (CJanus1_vtable above) - from log: orig_vtable=0x24689034, mp=0x235E0000
 // RVA = 0x24689034 - 0x235E0000 = 0x10A9034
 // Cross-check: also seen as 0x24B89034 - 0x23540000 = 0x1649034
 // Use the one from latest log (mp=0x235E0000): 0x10A9034
-static const uintptr_t RVA_Janus1_vtable = 0x1649034;
@@ -0,0 +1,19 @@
+#pragma once
+// mp_signatures.h - compiled-in signatures for mp.dll. Kept apart from
+// mp_offsets.h, which the host tools and every layout user include, so
+// only the hook engine pulls in the scanner.
+#include "../sigscan.h"
+
+// Signatures for the MP_RVAS entries, resolved once per mp.dll build and
+// signature set (results go to the address cache under the same names). A
+// null pattern keeps the compiled-in RVA; capture patterns from IDA for the
+// current build, or drop them into csnz_weapons.sig without rebuilding.
+static const SigDef MP_SIGNATURES[] = {
+    { "pGlobals",            nullptr, SIG_ABS32, 0 },
+    { "weapon_janus1",       nullptr, SIG_MATCH, 0 },
+    { "weapon_m79",          nullptr, SIG_MATCH, 0 },
+    { "UTIL_WeaponTimeBase", nullptr, SIG_MATCH, 0 },
+    { "GetWeaponConfig",     nullptr, SIG_MATCH, 0 },
+    { "BaseAddToPlayer",     nullptr, SIG_MATCH, 0 },
+    { "CJanus1_vtable",      nullptr, SIG_ABS32, 0 },
+};
@@ -0,0 +1,121 @@
+// hook_registry.cpp - growable hook table + flat hash indices
+#include "hook_registry.h"
+#include <cstring>
+#include <vector>
+
+static std::vector<HookEntry> g_hooks;
+static std::vector<int32_t>   g_byRva;    // slot -> entry index, -1 = empty
+static std::vector<int32_t>   g_byName;
+static uint32_t               g_mask   = 0;
+static bool                   g_sealed = false;
+
+static inline uint32_t HashRva(uintptr_t rva)
+{
+    return (uint32_t)rva * 0x9E3779B1u;   // Fibonacci hashing; RVAs share low zero bits
+}
+
+static inline uint32_t HashName(const char* s)
+{
+    uint32_t h = 2166136261u;             // FNV-1a
+    while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+    return h;
+}
+
+static inline uint32_t Spread(uint32_t h)
+{
+    return h ^ (h >> 16);
+}
+
+HookRegResult HookReg_Add(const char* name, void* hookFn, uintptr_t origRVA)
+{
+    if (g_sealed) return HOOKREG_SEALED;
+    if (!name || !hookFn) return HOOKREG_BAD_ARGS;
+    // Startup-only path; a linear duplicate check keeps the indices simple.
+    for (const HookEntry& h : g_hooks)
+    {
+        if (h.origRVA == origRVA)  return HOOKREG_DUPLICATE_RVA;
+        if (!strcmp(h.name, name)) return HOOKREG_DUPLICATE_NAME;
+    }
+    g_hooks.push_back({ name, hookFn, origRVA, false, {0,0,0,0,0}, nullptr, false });
+    return HOOKREG_OK;
+}
+
+const char* HookReg_ResultStr(HookRegResult r)
+{
+    switch (r)
+    {
+    case HOOKREG_OK:             return "ok";
+    case HOOKREG_BAD_ARGS:       return "null name or hook";
+    case HOOKREG_DUPLICATE_RVA:  return "rva already hooked";
+    case HOOKREG_DUPLICATE_NAME: return "classname already hooked";
+    case HOOKREG_SEALED:         return "registry sealed (hooks already installed)";
+    }
+    return "?";
+}
+
+void HookReg_Seal()
+{
+    if (g_sealed) return;
+    g_sealed = true;
+
+    // Load factor <= 0.5 keeps probe chains short.
+    uint32_t cap = 8;
+    while (cap < g_hooks.size() * 2) cap <<= 1;
+    g_mask = cap - 1;
+    g_byRva.assign(cap, -1);
+    g_byName.assign(cap, -1);
+
+    for (int32_t i = 0; i < (int32_t)g_hooks.size(); i++)
+    {
+        uint32_t s = Spread(HashRva(g_hooks[i].origRVA)) & g_mask;
+        while (g_byRva[s] >= 0) s = (s + 1) & g_mask;
+        g_byRva[s] = i;
+
+        s = Spread(HashName(g_hooks[i].name)) & g_mask;
+        while (g_byName[s] >= 0) s = (s + 1) & g_mask;
+        g_byName[s] = i;
+    }
+}
+
+void HookReg_Reset()
+{
+    g_hooks.clear();
+    g_byRva.clear();
+    g_byName.clear();
+    g_mask   = 0;
+    g_sealed = false;
+}
+
+int HookReg_Count()
+{
+    return (int)g_hooks.size();
+}
+
+HookEntry& HookReg_At(int i)
+{
+    return g_hooks[i];
+}
+
+HookEntry* HookReg_FindRva(uintptr_t origRVA)
+{
+    if (!g_sealed)
+    {
+        for (HookEntry& h : g_hooks) if (h.origRVA == origRVA) return &h;
+        return nullptr;
+    }
+    for (uint32_t s = Spread(HashRva(origRVA)) & g_mask; g_byRva[s] >= 0; s = (s + 1) & g_mask)
+        if (g_hooks[g_byRva[s]].origRVA == origRVA) return &g_hooks[g_byRva[s]];
+    return nullptr;
+}
+
+HookEntry* HookReg_FindName(const char* name)
+{
+    if (!g_sealed)
+    {
+        for (HookEntry& h : g_hooks) if (!strcmp(h.name, name)) return &h;
+        return nullptr;
+    }
+    for (uint32_t s = Spread(HashName(name)) & g_mask; g_byName[s] >= 0; s = (s + 1) & g_mask)
+        if (!strcmp(g_hooks[g_byName[s]].name, name)) return &g_hooks[g_byName[s]];
+    return nullptr;
+}
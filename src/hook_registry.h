@@ -0,0 +1,37 @@
+#pragma once
+// hook_registry.h - registered entry-point hooks.
+// Entries are appended without a cap during startup; HookReg_Seal() then
+// builds two open-addressing indices (by RVA and by classname) so lookups
+// from trampolines are O(1). Registration is closed once sealed.
+
+#include <cstdint>
+
+struct HookEntry
+{
+    const char* name;
+    void*       hookFn;
+    uintptr_t   origRVA;
+    bool        done;
+    uint8_t     origBytes[5]; // saved before patching
+    void*       trampoline;   // relocated prologue + jmp back, null = full replacement
+    bool        callThrough;  // must have a trampoline to be installed
+};
+
+enum HookRegResult
+{
+    HOOKREG_OK,
+    HOOKREG_BAD_ARGS,       // null name or hook function
+    HOOKREG_DUPLICATE_RVA,
+    HOOKREG_DUPLICATE_NAME,
+    HOOKREG_SEALED,         // registration after install
+};
+
+HookRegResult HookReg_Add(const char* name, void* hookFn, uintptr_t origRVA);
+const char*   HookReg_ResultStr(HookRegResult r);
+void          HookReg_Seal();
+// Empty and open for registration again.
+void          HookReg_Reset();
+int           HookReg_Count();
+HookEntry&    HookReg_At(int i);
+HookEntry*    HookReg_FindRva(uintptr_t origRVA);
+HookEntry*    HookReg_FindName(const char* name);
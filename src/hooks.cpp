@@ -1,51 +1,58 @@
 // hooks.cpp - weapon entry point hooking engine
 #include "hooks.h"
+#include "frame_clock.h"
 #include "logger.h"
+#include "offset_db.h"
+#include "pe_scan.h"
+#include "addr_cache.h"
+#include "hook_registry.h"
+#include "patch.h"
+#include "stub_arena.h"
+#include "thunk.h"
+#include "trampoline.h"
+#include "platform/platform.h"
 #include "hlsdk/mp_offsets.h"
+#include "hlsdk/mp_signatures.h"
 #include "hlsdk/sdk.h"
+#include <cstdio>
 #include <cstring>
 
 // Globals used by sdk.h helpers
 enginefuncs_t* g_engfuncs = nullptr;
 float*         g_pTime    = nullptr;
 
-static uintptr_t g_mpBase = 0;
-uintptr_t GetMpBase() { return g_mpBase; }
+static uintptr_t      g_mpBase = 0;
+static enginefuncs_t* g_mpEngfuncs = nullptr;   // mp.dll's own table, live
+uintptr_t      GetMpBase()     { return g_mpBase; }
+enginefuncs_t* GetMpEngfuncs() { return g_mpEngfuncs; }
 
 float GetTime()
 {
-    if (!g_pTime) return 0.f;
-    float t = 0.f;
-    __try { t = *g_pTime; } __except(EXCEPTION_EXECUTE_HANDLER) {}
-    return t;
+    return Clock_Time();
 }
 
 // -------------------------------------------------------------------------
-// Registration table
+// Registration
 // -------------------------------------------------------------------------
-struct HookEntry
+bool RegisterWeaponHook(const char* name, void* fn, uintptr_t rva)
 {
-    const char* name;
-    void*       hookFn;
-    uintptr_t   origRVA;
-    bool        done;
-    uint8_t     origBytes[5]; // saved before patching
-};
-static HookEntry g_hooks[32];
-static int       g_hookCount = 0;
+    HookRegResult r = HookReg_Add(name, fn, rva);
+    if (r != HOOKREG_OK)
+        LOG_ERROR(hooks, "register %s @ rva 0x%zX rejected: %s\n",
+                  name ? name : "(null)", rva, HookReg_ResultStr(r));
+    return r == HOOKREG_OK;
+}
 
-void RegisterWeaponHook(const char* name, void* fn, uintptr_t rva)
+const uint8_t* GetSavedBytes(uintptr_t origRVA)
 {
-    if (g_hookCount >= 32) return;
-    g_hooks[g_hookCount++] = { name, fn, rva, false, {0,0,0,0,0} };
+    const HookEntry* h = HookReg_FindRva(origRVA);
+    return h && h->done ? h->origBytes : nullptr;
 }
 
-const uint8_t* GetSavedBytes(uintptr_t origRVA)
+void* GetOriginal(uintptr_t origRVA)
 {
-    for (int i = 0; i < g_hookCount; i++)
-        if (g_hooks[i].origRVA == origRVA && g_hooks[i].done)
-            return g_hooks[i].origBytes;
-    return nullptr;
+    const HookEntry* h = HookReg_FindRva(origRVA);
+    return h && h->done ? h->trampoline : nullptr;
 }
 
 // -------------------------------------------------------------------------
@@ -53,108 +60,315 @@ const uint8_t* GetSavedBytes(uintptr_t origRVA)
 // -------------------------------------------------------------------------
 static bool SafeRead32(uintptr_t addr, uint32_t& out)
 {
-    __try { out = *reinterpret_cast<uint32_t*>(addr); return true; }
+    return Plat_SafeRead(&out, addr, sizeof(out));
+}
+
+static bool SafeFindPointerRun(const PeImage& img, uint32_t lo, uint32_t hi, PtrRun& out)
+{
+    __try { out = Pe_FindPointerRun(img, lo, hi); return true; }
     __except(EXCEPTION_EXECUTE_HANDLER) { return false; }
 }
 
+static bool SafeCopy(void* dst, uintptr_t src, size_t len)
+{
+    return Plat_SafeRead(dst, src, len);
+}
+
 bool WriteJmp5(uintptr_t from, uintptr_t to, uint8_t* outOrig)
 {
-    DWORD old = 0;
-    if (!VirtualProtect((void*)from, 5, PAGE_EXECUTE_READWRITE, &old))
-        return false;
-    if (outOrig)
+    PatchBatch b;
+    return b.AddJmp5(from, to, outOrig) && b.Commit(Patch_ProcessMemory());
+}
+
+// -------------------------------------------------------------------------
+// Trampolines live in stub regions within rel32 reach of mp.dll
+// -------------------------------------------------------------------------
+static StubArena g_stubs(Stub_ProcessPages());
+static uint32_t  g_mpSize = 0;
+
+// Relocate the prologue at addr into a fresh stub. Returns null (and the
+// hook degrades to a full replacement) if it can't be done safely.
+static void* BuildTrampoline(const char* name, uintptr_t addr)
+{
+    uint8_t code[TRAMP_MAX_STOLEN];
+    if (!SafeCopy(code, addr, sizeof(code))) return nullptr;
+
+    uint8_t* stub = (uint8_t*)g_stubs.Alloc(TRAMP_MAX_SIZE, g_mpBase, g_mpBase + g_mpSize);
+    if (!stub)
     {
-        __try { memcpy(outOrig, (void*)from, 5); }
-        __except(EXCEPTION_EXECUTE_HANDLER) {}
+        LOG_WARN(hooks, "%s: no stub memory near mp.dll, no trampoline\n", name);
+        return nullptr;
     }
-    uint8_t jmp[5] = { 0xE9 };
-    *reinterpret_cast<int32_t*>(jmp+1) = (int32_t)(to - from - 5);
-    __try { memcpy((void*)from, jmp, 5); }
-    __except(EXCEPTION_EXECUTE_HANDLER)
+    size_t stolen = 0, size = 0;
+    TrampResult r = Tramp_Build(code, sizeof(code), addr, 5, stub, TRAMP_MAX_SIZE,
+                                (uintptr_t)stub, stolen, size);
+    if (r != TRAMP_OK)
     {
-        VirtualProtect((void*)from, 5, old, &old);
+        LOG_WARN(hooks, "%s: no trampoline (%s), hook replaces the original\n",
+                 name, Tramp_ResultStr(r));
+        g_stubs.Free(stub);
+        return nullptr;
+    }
+    g_stubs.Flush(stub, size);
+    LOG_DEBUG(hooks, "%s: trampoline @ %p (%zu stolen, %zu bytes)\n", name, stub, stolen, size);
+    return stub;
+}
+
+bool RegisterDetour(HMODULE hMp, const char* name, void* fn, uintptr_t rva)
+{
+    uint8_t code[TRAMP_MAX_STOLEN], scratch[TRAMP_MAX_SIZE];
+    uintptr_t addr = (uintptr_t)hMp + rva;
+    size_t stolen = 0, size = 0;
+    TrampResult r = SafeCopy(code, addr, sizeof(code))
+        ? Tramp_Build(code, sizeof(code), addr, 5, scratch, sizeof(scratch), (uintptr_t)scratch, stolen, size)
+        : TRAMP_DECODE;
+    if (r != TRAMP_OK)
+    {
+        LOG_ERROR(hooks, "detour %s @ rva 0x%zX refused: %s\n", name, rva, Tramp_ResultStr(r));
         return false;
     }
-    VirtualProtect((void*)from, 5, old, &old);
+    if (!RegisterWeaponHook(name, fn, rva)) return false;
+    HookReg_FindRva(rva)->callThrough = true;
     return true;
 }
 
 // -------------------------------------------------------------------------
 // Find gpGlobals->time and engfuncs in mp.dll
 // -------------------------------------------------------------------------
+static const char* ADDR_CACHE_FILE  = "csnz_weapons.cache";
+static const char* SIG_FILE         = "csnz_weapons.sig";
+static const int   ENGFUNCS_MIN_RUN = 20;
+
+// A cached engfuncs offset is only trusted if it still points at a run of
+// hw.dll pointers; a cheap check compared to the full scan.
+static bool EngfuncsLooksValid(const PeImage& mp, uint32_t rva, uint32_t lo, uint32_t hi)
+{
+    if (rva + ENGFUNCS_MIN_RUN * 4 > mp.size) return false;
+    PtrRun r = FindPointerRun(mp.data + rva, ENGFUNCS_MIN_RUN * 4, rva, lo, hi);
+    return r.count == ENGFUNCS_MIN_RUN;
+}
+
+// MP_SIGNATURES plus csnz_weapons.sig; strings from the file live in pool.
+struct SigSet
+{
+    SigDef defs[SIG_MAX_PATTERNS];
+    int    n;
+    char   pool[16384];
+};
+
+static void LoadSignatures(SigSet& set)
+{
+    set.n = (int)(sizeof(MP_SIGNATURES) / sizeof(MP_SIGNATURES[0]));
+    memcpy(set.defs, MP_SIGNATURES, sizeof(MP_SIGNATURES));
+    set.n += Sig_LoadFile(SIG_FILE, set.defs + set.n, SIG_MAX_PATTERNS - set.n,
+                          set.pool, sizeof(set.pool));
+}
+
+// Part of the cache key, so adding or editing a signature forces a rescan.
+static uint32_t SigSetHash(const SigSet& set)
+{
+    uint32_t h = ADDR_CACHE_HASH0;
+    for (int i = 0; i < set.n; i++)
+    {
+        const SigDef& d = set.defs[i];
+        const char* pat = d.pattern ? d.pattern : "";
+        int32_t v[2] = { (int32_t)d.operand, d.opOffset };
+        h = AddrCache_Hash(h, d.name, strlen(d.name) + 1);
+        h = AddrCache_Hash(h, pat, strlen(pat) + 1);
+        h = AddrCache_Hash(h, v, sizeof(v));
+    }
+    return h;
+}
+
+// Cold start only: match every signature in one pass over mp.dll's code and
+// store unique hits in the address cache, where GetCachedRva picks them up.
+static void ResolveSignatures(const PeImage& mp, const SigSet& set)
+{
+    SigResult res[SIG_MAX_PATTERNS];
+    memset(res, 0, sizeof(res));
+
+    DWORD t0 = GetTickCount();
+    __try { Sig_ScanImage(mp, set.defs, set.n, res); }
+    __except(EXCEPTION_EXECUTE_HANDLER) { LOG_ERROR(hooks, "signature scan faulted\n"); return; }
+
+    int found = 0;
+    for (int i = 0; i < set.n; i++)
+    {
+        const SigDef& d = set.defs[i];
+        if (!d.pattern) continue;
+        if (res[i].matches == 1) { AddrCache_Put(d.name, res[i].rva); found++; }
+        else LOG_WARN(hooks, "sig %-20s %s (%d matches)\n", d.name,
+                      res[i].matches ? "ambiguous" : "not found", res[i].matches);
+    }
+    LOG_INFO(hooks, "signatures: %d resolved in %u ms\n", found, (unsigned)(GetTickCount() - t0));
+}
+
 static bool ResolveGlobals(HMODULE hMp)
 {
     uintptr_t base = (uintptr_t)hMp;
 
-    uint32_t pGlobals = 0;
-    if (!SafeRead32(base + RVA_pGlobals, pGlobals) || !pGlobals)
+    HMODULE hHw = GetModuleHandleA("hw.dll");
+    if (!hHw) { LOG_ERROR(hooks, "hw.dll not found\n"); return false; }
+
+    PeImage mp, hw;
+    if (!Pe_ParseModule(hMp, mp) || !Pe_ParseModule(hHw, hw))
     {
-        Log("[hooks] gpGlobals ptr is null\n");
+        LOG_ERROR(hooks, "bad PE headers (mp=%p hw=%p)\n", hMp, hHw);
         return false;
     }
-    g_pTime = reinterpret_cast<float*>((uintptr_t)pGlobals);
-    Log("[hooks] gpGlobals @ 0x%08X  time=%.3f\n", pGlobals, *g_pTime);
+    uint8_t* mpData = (uint8_t*)base;
+    g_mpSize = mp.sizeOfImage;
+    uint32_t hwBase = (uint32_t)(uintptr_t)hHw;
+    uint32_t hwEnd  = hwBase + hw.sizeOfImage;
 
-    HMODULE hHw = GetModuleHandleA("hw.dll");
-    if (!hHw) { Log("[hooks] hw.dll not found\n"); return false; }
+    // Entries derived from other compiled-in defaults or another signature
+    // set are stale.
+    static SigSet sigs;
+    LoadSignatures(sigs);
+    char build[32];
+    snprintf(build, sizeof(build), "ofs-%08X sig-%08X", OffsetDb_DefaultsHash(), SigSetHash(sigs));
+    bool warm = AddrCache_Open(ADDR_CACHE_FILE, build, PeKey_From(mp), PeKey_From(hw));
+    LOG_INFO(hooks, "address cache: %s\n", warm ? "warm" : "cold, rescanning");
+    if (!warm) ResolveSignatures(mp, sigs);
 
-    IMAGE_DOS_HEADER* dos = (IMAGE_DOS_HEADER*)hMp;
-    IMAGE_NT_HEADERS* nt  = (IMAGE_NT_HEADERS*)((uint8_t*)hMp + dos->e_lfanew);
-    DWORD mpSize = nt->OptionalHeader.SizeOfImage;
-    uint8_t* mpData = (uint8_t*)base;
+    // csnz_offsets.txt entries are explicit for this build; they beat
+    // signature hits, including ones cached on an earlier run. In memory
+    // only: the file isn't part of the cache key.
+    for (int i = 0; i < OFS_COUNT; i++)
+        if (OFFSET_DB_ENTRIES[i].group == OFSG_RVA && OffsetDb_Overridden((OffsetId)i))
+            AddrCache_Override(OFFSET_DB_ENTRIES[i].name, (uint32_t)g_offsets[i]);
 
-    IMAGE_DOS_HEADER* hdos = (IMAGE_DOS_HEADER*)hHw;
-    IMAGE_NT_HEADERS* hnt  = (IMAGE_NT_HEADERS*)((uint8_t*)hHw + hdos->e_lfanew);
-    uintptr_t hwBase = (uintptr_t)hHw;
-    uintptr_t hwEnd  = hwBase + hnt->OptionalHeader.SizeOfImage;
+    uint32_t rvaGlobals = AddrCache_GetOr("pGlobals", Ofs_Rva(OFS_Rva_pGlobals));
 
-    size_t bestOff = 0; int bestRun = 0;
-    int curRun = 0; size_t runStart = 0;
-    for (size_t off = 0; off+4 <= mpSize; off += 4)
+    uint32_t pGlobals = 0;
+    if (!SafeRead32(base + rvaGlobals, pGlobals) || !pGlobals)
     {
-        uint32_t v = 0;
-        __try { v = *reinterpret_cast<uint32_t*>(mpData+off); }
-        __except(EXCEPTION_EXECUTE_HANDLER) { curRun=0; continue; }
-        if (v >= hwBase && v < hwEnd) { if (!curRun) runStart=off; curRun++; }
-        else { if (curRun > bestRun) { bestRun=curRun; bestOff=runStart; } curRun=0; }
+        LOG_ERROR(hooks, "gpGlobals ptr is null\n");
+        return false;
+    }
+    g_pTime = reinterpret_cast<float*>((uintptr_t)pGlobals);
+    LOG_DEBUG(hooks, "gpGlobals @ 0x%08X  time=%.3f\n", pGlobals, *g_pTime);
+
+    uint32_t bestOff = 0;
+    if (!AddrCache_Get("engfuncs", bestOff) || !EngfuncsLooksValid(mp, bestOff, hwBase, hwEnd))
+    {
+        // Only .data/.rdata can hold the table; code and resources are skipped.
+        PtrRun run = { 0, 0 };
+        if (!SafeFindPointerRun(mp, hwBase, hwEnd, run) || run.count < ENGFUNCS_MIN_RUN)
+        {
+            LOG_ERROR(hooks, "engfuncs not found\n");
+            return false;
+        }
+        bestOff = run.rva;
+        AddrCache_Put("engfuncs", bestOff);
     }
-    if (bestRun < 20) { Log("[hooks] engfuncs not found\n"); return false; }
 
     static enginefuncs_t ef;
     memcpy(&ef, mpData+bestOff, sizeof(ef));
     g_engfuncs = &ef;
-    Log("[hooks] engfuncs @ mp+0x%zX  pfnPrecacheModel=0x%08X\n",
-        bestOff, (uint32_t)(uintptr_t)ef.pfnPrecacheModel);
+    g_mpEngfuncs = reinterpret_cast<enginefuncs_t*>(mpData + bestOff);
+    LOG_DEBUG(hooks, "engfuncs @ mp+0x%X  pfnPrecacheModel=0x%08X\n",
+              bestOff, (uint32_t)(uintptr_t)ef.pfnPrecacheModel);
     return true;
 }
 
+uintptr_t GetCachedRva(const char* name, uintptr_t fallback)
+{
+    return AddrCache_GetOr(name, (uint32_t)fallback);
+}
+
+void Hooks_SaveCache()
+{
+    if (!AddrCache_Save()) LOG_WARN(hooks, "failed to write %s\n", ADDR_CACHE_FILE);
+}
+
 // -------------------------------------------------------------------------
-bool Hooks_Install(HMODULE hMp)
+// Install one registered hook ahead of the rest, before the server runs
+// (e.g. the first-frame hook). Hooks_Install later counts it as done.
+bool Hooks_InstallOne(HMODULE hMp, uintptr_t origRVA)
 {
+    HookEntry* h = HookReg_FindRva(origRVA);
+    if (!h) return false;
+    if (h->done) return true;
+
+    PeImage mp;
+    if (!Pe_ParseModule(hMp, mp)) { LOG_ERROR(hooks, "bad PE headers (mp=%p)\n", hMp); return false; }
     g_mpBase = (uintptr_t)hMp;
-    Log("[hooks] Hooks_Install mp=0x%08zX\n", g_mpBase);
+    g_mpSize = mp.sizeOfImage;
 
-    if (!ResolveGlobals(hMp)) return false;
+    if (!h->trampoline) h->trampoline = BuildTrampoline(h->name, g_mpBase + h->origRVA);
+    if (!h->trampoline && h->callThrough) return false;
 
-    int n = 0;
-    for (int i = 0; i < g_hookCount; i++)
+    PatchBatch batch;
+    if (!batch.AddJmp5(g_mpBase + h->origRVA, (uintptr_t)h->hookFn, h->origBytes)
+        || !batch.Commit(Patch_ProcessMemory()))
     {
-        HookEntry& h = g_hooks[i];
-        uintptr_t target = g_mpBase + h.origRVA;
-        // Save original bytes BEFORE patching
-        __try { memcpy(h.origBytes, (void*)target, 5); }
-        __except(EXCEPTION_EXECUTE_HANDLER) {}
+        LOG_ERROR(hooks, "FAILED: %s (%s)\n", h->name, batch.Error());
+        if (h->trampoline) { g_stubs.Free(h->trampoline); h->trampoline = nullptr; }
+        return false;
+    }
+    h->done = true;
+    LOG_DEBUG(hooks, "%-20s patched early 0x%08zX -> 0x%08zX\n", h->name, g_mpBase + h->origRVA, (uintptr_t)h->hookFn);
+    return true;
+}
+
+HooksResult Hooks_Install(HMODULE hMp)
+{
+    g_mpBase = (uintptr_t)hMp;
+    LOG_INFO(hooks, "Hooks_Install mp=0x%08zX\n", g_mpBase);
+
+    if (!ResolveGlobals(hMp)) return HOOKS_FAILED;
+    Thunk_SetArena(&g_stubs, g_mpBase, g_mpBase + g_mpSize);
+    Log_Flush();   // get everything on disk before we start patching code
 
-        if (WriteJmp5(target, (uintptr_t)h.hookFn, nullptr))
+    HookReg_Seal();
+
+    // One transaction for every pending hook: each code page is flipped
+    // once, and a failure anywhere leaves mp.dll untouched.
+    PatchBatch batch;
+    int n = 0, skipped = 0, count = HookReg_Count();
+    for (int i = 0; i < count; i++)
+    {
+        HookEntry& h = HookReg_At(i);
+        if (h.done) { n++; continue; }   // patched by an earlier attempt
+        if (!h.trampoline) h.trampoline = BuildTrampoline(h.name, g_mpBase + h.origRVA);
+        if (!h.trampoline && h.callThrough)
+        {
+            // A detour that can't reach the original would break the game.
+            LOG_ERROR(hooks, "%s: detour skipped, no trampoline\n", h.name);
+            skipped++;
+            continue;
+        }
+        if (!batch.AddJmp5(g_mpBase + h.origRVA, (uintptr_t)h.hookFn, h.origBytes))
+        {
+            LOG_ERROR(hooks, "FAILED: %s (%s)\n", h.name, batch.Error());
+            return HOOKS_FAILED;
+        }
+    }
+    if (!batch.Commit(Patch_ProcessMemory()))
+    {
+        LOG_ERROR(hooks, "patch batch failed at 0x%08zX: %s, rolled back\n",
+                  batch.ErrorAddr(), batch.Error());
+        for (int i = 0; i < count; i++)
         {
-            h.done = true; n++;
-            Log("[hooks] %-20s patched 0x%08zX -> 0x%08zX  orig: %02X %02X %02X %02X %02X\n",
-                h.name, target, (uintptr_t)h.hookFn,
-                h.origBytes[0], h.origBytes[1], h.origBytes[2],
-                h.origBytes[3], h.origBytes[4]);
+            HookEntry& h = HookReg_At(i);
+            if (!h.done && h.trampoline) { g_stubs.Free(h.trampoline); h.trampoline = nullptr; }
         }
-        else Log("[hooks] FAILED: %s\n", h.name);
+        return HOOKS_FAILED;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        HookEntry& h = HookReg_At(i);
+        if (h.done || (h.callThrough && !h.trampoline)) continue;
+        h.done = true; n++;
+        LOG_DEBUG(hooks, "%-20s patched 0x%08zX -> 0x%08zX  orig: %02X %02X %02X %02X %02X\n",
+                  h.name, g_mpBase + h.origRVA, (uintptr_t)h.hookFn,
+                  h.origBytes[0], h.origBytes[1], h.origBytes[2],
+                  h.origBytes[3], h.origBytes[4]);
     }
-    Log("[hooks] %d/%d installed\n", n, g_hookCount);
-    return n == g_hookCount;
+    LOG_INFO(hooks, "%d/%d installed, %d skipped\n", n, count, skipped);
+    // A prologue that can't be relocated won't change on a retry, so a
+    // skipped detour is reported rather than failing the whole install.
+    if (n == count) return HOOKS_OK;
+    return n + skipped == count ? HOOKS_PARTIAL : HOOKS_FAILED;
 }
@@ -2,9 +2,28 @@
 #include <windows.h>
 #include <cstdint>
 
-void           RegisterWeaponHook(const char* classname, void* hookFn, uintptr_t origRVA);
-bool           Hooks_Install(HMODULE hMp);
+struct enginefuncs_t;
+
+enum HooksResult
+{
+    HOOKS_FAILED,    // nothing new patched; the install can be retried
+    HOOKS_PARTIAL,   // patched, but detours with no trampoline were left out
+    HOOKS_OK,
+};
+
+bool           RegisterWeaponHook(const char* classname, void* hookFn, uintptr_t origRVA);
+// For hooks that must call through: refuses targets whose prologue can't be
+// relocated, so GetOriginal() is non-null once installed.
+bool           RegisterDetour(HMODULE hMp, const char* name, void* hookFn, uintptr_t origRVA);
+HooksResult    Hooks_Install(HMODULE hMp);
+bool           Hooks_InstallOne(HMODULE hMp, uintptr_t origRVA);
 const uint8_t* GetSavedBytes(uintptr_t origRVA);
+void*          GetOriginal(uintptr_t origRVA);
 uintptr_t      GetMpBase();
+// mp.dll's copy of the engine table, the one its code calls through (null
+// before Hooks_Install). g_engfuncs is a snapshot taken at install.
+enginefuncs_t* GetMpEngfuncs();
 float          GetTime();
 bool           WriteJmp5(uintptr_t from, uintptr_t to, uint8_t* outOrig);
+uintptr_t      GetCachedRva(const char* name, uintptr_t fallback);
+void           Hooks_SaveCache();
@@ -0,0 +1,12 @@
+#pragma once
+// loader_notify.h - tell us when one DLL is loaded or unloaded.
+// Wraps ntdll's LdrRegisterDllNotification. The callback runs on the
+// loading thread with the loader lock held, before the DLL's own DllMain:
+// record and signal, nothing else.
+
+typedef void (*LoaderNotifyFn)(bool loaded, void* base, void* ctx);
+
+// Watch one module by file name (case-insensitive). False if the loader
+// doesn't support notifications; poll instead.
+bool LoaderNotify_Watch(const wchar_t* baseName, LoaderNotifyFn fn, void* ctx);
+void LoaderNotify_Stop();
@@ -0,0 +1,162 @@
+#pragma once
+// log_bin.h - deferred-format binary log records.
+// A call site is a LogSite holding its format string. The argument type
+// signature is built at compile time from the C++ argument types, so the
+// hot path only copies raw argument bytes; the format string is written
+// once per site (a DEF record) and tools/logdecode turns the .bin back into
+// text offline. Shared by the encoder (logger) and the decoder.
+//
+// File: LOGBIN_MAGIC, then records { u8 tag, u16 id, u16 len, len bytes }.
+//   DEF payload: u8 nargs, nargs type codes, format string (no NUL)
+//   MSG payload: arguments in order, little-endian
+//     'i' i32  'u' u32  'l' i64  'q' u64  'd' f64  'p' u64  's' u16 len + bytes
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+static const char   LOGBIN_MAGIC[8] = { 'C','S','N','Z','L','O','G','1' };
+static const size_t LOGBIN_HDR      = 5;
+
+enum LogBinTag : uint8_t
+{
+    LOGBIN_DEF = 1,
+    LOGBIN_MSG = 2,
+};
+
+struct LogSite
+{
+    const char*           fmt;
+    std::atomic<uint32_t> id;       // 0 = not assigned yet
+    std::atomic<bool>     defined;  // DEF record made it into the log
+};
+
+// -------------------------------------------------------------------------
+// Compile-time argument type codes
+// -------------------------------------------------------------------------
+template<typename T, typename = void>
+struct LogArg;
+
+// Enums travel as their underlying type (is_signed is false for any enum).
+template<typename T, bool = std::is_enum<T>::value>
+struct LogArgInt { typedef T type; };
+template<typename T>
+struct LogArgInt<T, true> { typedef typename std::underlying_type<T>::type type; };
+
+template<typename T>
+struct LogArg<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    // Like printf, anything up to 32 bits travels as a 32-bit value.
+    typedef typename LogArgInt<T>::type I;
+    static constexpr char code = sizeof(I) <= 4 ? (std::is_signed<I>::value ? 'i' : 'u')
+                                                : (std::is_signed<I>::value ? 'l' : 'q');
+};
+template<typename T>
+struct LogArg<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static constexpr char code = 'd';
+};
+template<typename T>
+struct LogArg<T*, void>
+{
+    static constexpr char code = std::is_same<typename std::remove_cv<T>::type, char>::value ? 's' : 'p';
+};
+
+template<typename... Args>
+struct LogArgTypes
+{
+    static constexpr char str[] = { LogArg<typename std::decay<Args>::type>::code..., 0 };
+    static constexpr int  count = (int)sizeof...(Args);
+};
+template<typename... Args>
+constexpr char LogArgTypes<Args...>::str[];
+
+// -------------------------------------------------------------------------
+// Encoding. Each writer returns the new cursor, or nullptr when out of room.
+// -------------------------------------------------------------------------
+template<typename T>
+inline uint8_t* LogBin_Raw(uint8_t* p, uint8_t* end, T v)
+{
+    if (!p || end - p < (ptrdiff_t)sizeof(T)) return nullptr;
+    memcpy(p, &v, sizeof(T));
+    return p + sizeof(T);
+}
+
+inline uint8_t* LogBin_Str(uint8_t* p, uint8_t* end, const char* s)
+{
+    if (!s) s = "(null)";
+    if (!p || end - p < 2) return nullptr;
+    size_t n = strlen(s), room = (size_t)(end - p) - 2;
+    if (n > room)   n = room;     // truncate rather than lose the record
+    if (n > 0xFFFF) n = 0xFFFF;
+    p = LogBin_Raw<uint16_t>(p, end, (uint16_t)n);
+    memcpy(p, s, n);
+    return p + n;
+}
+
+template<typename T>
+inline uint8_t* LogBin_Arg(uint8_t* p, uint8_t* end, const T& v)
+{
+    switch (LogArg<T>::code)
+    {
+    case 'i': return LogBin_Raw<int32_t> (p, end, (int32_t)(int64_t)v);
+    case 'u': return LogBin_Raw<uint32_t>(p, end, (uint32_t)(uint64_t)v);
+    case 'l': return LogBin_Raw<int64_t> (p, end, (int64_t)v);
+    case 'q': return LogBin_Raw<uint64_t>(p, end, (uint64_t)v);
+    }
+    return nullptr;
+}
+inline uint8_t* LogBin_Arg(uint8_t* p, uint8_t* end, float v)  { return LogBin_Raw<double>(p, end, v); }
+inline uint8_t* LogBin_Arg(uint8_t* p, uint8_t* end, double v) { return LogBin_Raw<double>(p, end, v); }
+inline uint8_t* LogBin_Arg(uint8_t* p, uint8_t* end, const char* s) { return LogBin_Str(p, end, s); }
+inline uint8_t* LogBin_Arg(uint8_t* p, uint8_t* end, char* s)       { return LogBin_Str(p, end, s); }
+template<typename T>
+inline uint8_t* LogBin_Arg(uint8_t* p, uint8_t* end, T* v)
+{
+    return LogBin_Raw<uint64_t>(p, end, (uint64_t)(uintptr_t)v);
+}
+
+inline uint8_t* LogBin_Header(uint8_t* p, uint8_t* end, LogBinTag tag, uint32_t id)
+{
+    p = LogBin_Raw<uint8_t>(p, end, tag);
+    p = LogBin_Raw<uint16_t>(p, end, (uint16_t)id);
+    return LogBin_Raw<uint16_t>(p, end, 0);   // length patched by LogBin_Finish
+}
+
+inline size_t LogBin_Finish(uint8_t* rec, uint8_t* p)
+{
+    if (!p) return 0;
+    uint16_t len = (uint16_t)(p - rec - LOGBIN_HDR);
+    memcpy(rec + 3, &len, 2);
+    return (size_t)(p - rec);
+}
+
+// Returns the record size, 0 if it did not fit.
+inline size_t LogBin_EncodeDef(uint8_t* buf, size_t room, uint32_t id, const char* types,
+                               int nargs, const char* fmt)
+{
+    uint8_t* end = buf + room;
+    uint8_t* p = LogBin_Header(buf, end, LOGBIN_DEF, id);
+    p = LogBin_Raw<uint8_t>(p, end, (uint8_t)nargs);
+    size_t fl = strlen(fmt);
+    if (!p || (size_t)(end - p) < (size_t)nargs + fl) return 0;
+    memcpy(p, types, nargs); p += nargs;
+    memcpy(p, fmt, fl);      p += fl;
+    return LogBin_Finish(buf, p);
+}
+
+inline uint8_t* LogBin_Args(uint8_t* p, uint8_t*) { return p; }
+template<typename T, typename... Rest>
+inline uint8_t* LogBin_Args(uint8_t* p, uint8_t* end, const T& v, const Rest&... rest)
+{
+    return LogBin_Args(LogBin_Arg(p, end, v), end, rest...);
+}
+
+template<typename... Args>
+inline size_t LogBin_EncodeMsg(uint8_t* buf, size_t room, uint32_t id, const Args&... args)
+{
+    uint8_t* end = buf + room;
+    return LogBin_Finish(buf, LogBin_Args(LogBin_Header(buf, end, LOGBIN_MSG, id), end, args...));
+}
@@ -0,0 +1,133 @@
+// log_decode.cpp - two-pass decoder for the binary log
+#include "log_decode.h"
+#include "log_bin.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct SiteDef
+{
+    bool        known = false;
+    std::string types;
+    std::string fmt;
+};
+
+struct Reader
+{
+    const uint8_t* p;
+    const uint8_t* end;
+
+    template<typename T>
+    bool Get(T& v)
+    {
+        if (end - p < (ptrdiff_t)sizeof(T)) return false;
+        memcpy(&v, p, sizeof(T)); p += sizeof(T);
+        return true;
+    }
+};
+
+static bool FormatInt(char* buf, size_t n, std::string spec, char conv, uint64_t bits, bool isSigned)
+{
+    if (strchr("feEgGaAs", conv)) return false;
+    if (conv == 'c') { spec += 'c'; snprintf(buf, n, spec.c_str(), (int)bits); return true; }
+    spec += "ll"; spec += conv;
+    if (isSigned) snprintf(buf, n, spec.c_str(), (long long)bits);
+    else          snprintf(buf, n, spec.c_str(), (unsigned long long)bits);
+    return true;
+}
+
+// Format one conversion spec (flags/width/precision, no length modifier)
+// against the next argument of the given type code.
+static bool FormatArg(FILE* out, std::string spec, char conv, char type, Reader& r)
+{
+    char buf[1024];
+    bool ok = false;
+    switch (type)
+    {
+    case 'i': { int32_t v;  ok = r.Get(v) && FormatInt(buf, sizeof(buf), spec, conv, (uint64_t)(int64_t)v, true); break; }
+    case 'u': { uint32_t v; ok = r.Get(v) && FormatInt(buf, sizeof(buf), spec, conv, v, false); break; }
+    case 'l': { int64_t v;  ok = r.Get(v) && FormatInt(buf, sizeof(buf), spec, conv, (uint64_t)v, true); break; }
+    case 'q': { uint64_t v; ok = r.Get(v) && FormatInt(buf, sizeof(buf), spec, conv, v, false); break; }
+    case 'd': { double v;   ok = r.Get(v);
+                spec += conv;
+                if (ok) snprintf(buf, sizeof(buf), spec.c_str(), v);
+                break; }
+    case 'p': { uint64_t v; ok = r.Get(v);
+                // the game's pointers are 32-bit; print them the same on any host
+                if (ok) snprintf(buf, sizeof(buf), "%08llX", (unsigned long long)v);
+                break; }
+    case 's': { uint16_t n;
+                ok = r.Get(n) && r.end - r.p >= n && conv == 's';
+                if (!ok) break;
+                std::string s((const char*)r.p, n); r.p += n;
+                spec += 's';
+                snprintf(buf, sizeof(buf), spec.c_str(), s.c_str()); break; }
+    }
+    if (ok) fputs(buf, out);
+    return ok;
+}
+
+static void FormatMessage(FILE* out, const SiteDef& d, Reader r)
+{
+    size_t arg = 0;
+    for (const char* f = d.fmt.c_str(); *f; f++)
+    {
+        if (*f != '%') { fputc(*f, out); continue; }
+        if (f[1] == '%') { fputc('%', out); f++; continue; }
+
+        std::string spec = "%";
+        const char* q = f + 1;
+        while (*q && strchr("-+ #0123456789.", *q)) spec += *q++;
+        while (*q && strchr("hlLzjtI", *q)) q++;           // length comes from the type code
+        char conv = *q;
+        if (!conv || arg >= d.types.size() || !FormatArg(out, spec, conv, d.types[arg++], r))
+        {
+            fprintf(out, "<bad arg %zu in \"%s\">\n", arg, d.fmt.c_str());
+            return;
+        }
+        f = q;
+    }
+}
+
+bool LogBin_Decode(const uint8_t* data, size_t size, FILE* out, FILE* err)
+{
+    if (size < sizeof(LOGBIN_MAGIC) || memcmp(data, LOGBIN_MAGIC, sizeof(LOGBIN_MAGIC)))
+        return false;
+
+    // Records from different threads can land out of order, so collect every
+    // DEF before decoding any MSG.
+    std::vector<SiteDef> sites(65536);
+    const uint8_t* begin = data + sizeof(LOGBIN_MAGIC);
+    const uint8_t* end   = data + size;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Reader r = { begin, end };
+        uint8_t tag; uint16_t id, len;
+        while (r.Get(tag) && r.Get(id) && r.Get(len))
+        {
+            if (r.end - r.p < len)
+            {
+                if (pass == 0) fprintf(err, "truncated record at end of file\n");
+                break;
+            }
+            Reader body = { r.p, r.p + len };
+            r.p += len;
+
+            if (pass == 0 && tag == LOGBIN_DEF && !sites[id].known)
+            {
+                uint8_t nargs;
+                if (!body.Get(nargs) || body.end - body.p < nargs) continue;
+                SiteDef& d = sites[id];
+                d.types.assign((const char*)body.p, nargs);
+                d.fmt.assign((const char*)body.p + nargs, (const char*)body.end);
+                d.known = true;
+            }
+            else if (pass == 1 && tag == LOGBIN_MSG && len)
+            {
+                if (sites[id].known) FormatMessage(out, sites[id], body);
+                else fprintf(out, "<message for unknown site %u>\n", id);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,13 @@
+#pragma once
+// log_decode.h - csnz_weapons.bin (log_bin.h records) back to text.
+// Used by tools/logdecode and the round-trip tests.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Decode a whole binary log, LOGBIN_MAGIC included, into out. Problems
+// (a truncated tail, a message for a site with no DEF) are reported
+// inline or to err and decoding carries on. False if data isn't a
+// binary log.
+bool LogBin_Decode(const uint8_t* data, size_t size, FILE* out, FILE* err);
@@ -0,0 +1,86 @@
+#pragma once
+// log_ring.h - bounded lock-free MPSC ring of fixed-size log records.
+// Any thread may claim/publish; exactly one thread drains. Producers never
+// block: when the ring is full the record is dropped and counted.
+// Sequence-numbered cells after D. Vyukov's bounded queue.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+static const int    LOG_RING_SLOTS     = 1024;  // power of two
+static const size_t LOG_RING_SLOT_SIZE = 512;
+
+struct LogSlot
+{
+    std::atomic<uint32_t> seq;
+    uint16_t              len;
+    uint16_t              kind;  // caller-defined record type
+    char                  data[LOG_RING_SLOT_SIZE - 8];
+};
+
+struct LogRing
+{
+    alignas(64) std::atomic<uint32_t> head;     // next slot to claim (producers)
+    alignas(64) uint32_t              tail;     // next slot to drain (consumer)
+    alignas(64) std::atomic<uint32_t> dropped;
+    LogSlot                           slots[LOG_RING_SLOTS];
+};
+
+static const size_t LOG_SLOT_PAYLOAD = sizeof(LogSlot::data);
+
+inline void LogRing_Init(LogRing& r)
+{
+    r.head.store(0, std::memory_order_relaxed);
+    r.tail = 0;
+    r.dropped.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < (uint32_t)LOG_RING_SLOTS; i++)
+        r.slots[i].seq.store(i, std::memory_order_relaxed);
+}
+
+// Reserve a slot for writing, or nullptr (and count a drop) if full.
+inline LogSlot* LogRing_Claim(LogRing& r)
+{
+    uint32_t pos = r.head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        LogSlot& s = r.slots[pos & (LOG_RING_SLOTS - 1)];
+        int32_t diff = (int32_t)(s.seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+            if (r.head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return &s;
+        }
+        else if (diff < 0)
+        {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else pos = r.head.load(std::memory_order_relaxed);
+    }
+}
+
+// Hand a claimed slot to the consumer. The slot's sequence equals its claim
+// position, so publishing is seq+1; the position is returned to the caller.
+inline uint32_t LogRing_Publish(LogSlot* s, uint32_t len, uint16_t kind = 0)
+{
+    uint32_t pos = s->seq.load(std::memory_order_relaxed);
+    s->len  = (uint16_t)len;
+    s->kind = kind;
+    s->seq.store(pos + 1, std::memory_order_release);
+    return pos;
+}
+
+// Consumer side: next published slot or nullptr, then Release it.
+inline LogSlot* LogRing_Peek(LogRing& r)
+{
+    LogSlot& s = r.slots[r.tail & (LOG_RING_SLOTS - 1)];
+    return s.seq.load(std::memory_order_acquire) == r.tail + 1 ? &s : nullptr;
+}
+
+inline void LogRing_Release(LogRing& r, LogSlot* s)
+{
+    s->seq.store(r.tail + LOG_RING_SLOTS, std::memory_order_release);
+    r.tail++;
+}
+
@@ -1,20 +1,292 @@
+// logger.cpp - async file logger.
+// Log() formats straight into a slot of a lock-free ring and returns; a
+// background thread batches the slots into WriteFile calls and flushes on
+// a timer or once enough unflushed bytes pile up, so game threads never
+// wait on the disk. LOG_FAST records in binary mode go through the same
+// ring to a second file.
 #include "logger.h"
-#include <windows.h>
+#include "log_ring.h"
+#include "platform/platform.h"
+#include <atomic>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
 
-static HANDLE g_hLog = INVALID_HANDLE_VALUE;
+static const uint32_t LOG_FLUSH_MS    = 250;                // writer period, flushes on timeout
+static const size_t   LOG_FLUSH_BYTES = 64 * 1024;          // flush early past this much
+static const uint32_t LOG_WAKE_EVERY  = LOG_RING_SLOTS / 4; // producer kicks the writer
+
+enum : uint16_t { SLOT_TEXT = 0, SLOT_BIN = 1 };
+
+struct LogSink
+{
+    void*  h;
+    size_t len;
+    size_t unflushed;
+    char   batch[64 * 1024];
+};
+
+static void*             g_hWake = nullptr;
+static bool              g_sync  = false;  // no writer thread: drain inline
+static std::atomic<int>  g_state{0};       // 0 = uninit, 1 = initializing, 2 = ready
+static std::atomic<bool> g_binary{false};
+static std::atomic<uint32_t> g_nextSiteId{0};
+static std::atomic_flag  g_draining = ATOMIC_FLAG_INIT;
+static LogRing           g_ring;
+
+uint8_t g_logLevel[LOGSUB_COUNT];
+
+// Writer-side state, only touched while holding g_draining
+static LogSink  g_text = {};
+static LogSink  g_bin  = {};
+static uint32_t g_reportedDrops = 0;
+
+static void WriteBatch(LogSink& k)
+{
+    if (!k.len) return;
+    if (k.h) Plat_FileWrite(k.h, k.batch, k.len);
+    k.unflushed += k.len;
+    k.len = 0;
+}
+
+static void Append(LogSink& k, const char* p, size_t n)
+{
+    if (k.len + n > sizeof(k.batch)) WriteBatch(k);
+    memcpy(k.batch + k.len, p, n);
+    k.len += n;
+}
+
+static void FlushSink(LogSink& k, bool force)
+{
+    WriteBatch(k);
+    if (k.unflushed && (force || k.unflushed >= LOG_FLUSH_BYTES))
+    {
+        if (k.h) Plat_FileFlush(k.h);
+        k.unflushed = 0;
+    }
+}
+
+// Caller holds g_draining.
+static void DrainLocked(bool flush, uint32_t upto)
+{
+    uint32_t t0 = Plat_TickMs();
+    for (;;)
+    {
+        while (LogSlot* s = LogRing_Peek(g_ring))
+        {
+            Append(s->kind == SLOT_BIN ? g_bin : g_text, s->data, s->len);
+            LogRing_Release(g_ring, s);
+        }
+        // Stopped at a slot another thread has claimed but not published
+        // yet; worth waiting for only if it is one the caller needs.
+        if ((int32_t)(g_ring.tail - upto) >= 0 || Plat_TickMs() - t0 > LOG_FLUSH_MS) break;
+        Plat_Yield();
+    }
+    uint32_t drops = g_ring.dropped.load(std::memory_order_relaxed);
+    if (drops != g_reportedDrops)
+    {
+        char msg[64];
+        int n = snprintf(msg, sizeof(msg), "[log] %u lines dropped (ring full)\n",
+                         drops - g_reportedDrops);
+        Append(g_text, msg, (size_t)n);
+        g_reportedDrops = drops;
+    }
+    FlushSink(g_text, flush);
+    FlushSink(g_bin, flush);
+}
+
+// Move everything published so far to the files. Only one thread drains at
+// a time; a concurrent caller just returns.
+static void Drain(bool flush)
+{
+    if (g_draining.test_and_set(std::memory_order_acquire)) return;
+    DrainLocked(flush, g_ring.tail);
+    g_draining.clear(std::memory_order_release);
+}
+
+static void WriterThread(void*)
+{
+    for (;;)
+    {
+        bool woken = Plat_EventWait(g_hWake, LOG_FLUSH_MS);
+        Drain(!woken);
+    }
+}
+
+static void InitOnce()
+{
+    int expect = 0;
+    if (!g_state.compare_exchange_strong(expect, 1))
+    {
+        while (g_state.load(std::memory_order_acquire) != 2) Plat_Yield();
+        return;
+    }
+    LogRing_Init(g_ring);
+    g_text.h = Plat_FileCreate("csnz_weapons.log");
+    g_hWake = Plat_EventCreate();
+    if (!g_hWake || !Plat_StartThread(WriterThread, nullptr)) g_sync = true;
+    g_state.store(2, std::memory_order_release);
+
+    char spec[256];
+    if (Plat_GetEnv("CSNZ_LOG", spec, sizeof(spec)) && !Log_Configure(spec))
+        Log("[log] bad CSNZ_LOG entry in \"%s\"\n", spec);
+#ifdef CSNZ_LOG_BINARY
+    Log_SetBinary(true);
+#endif
+}
+
+static void Publish(LogSlot* s, size_t len, uint16_t kind)
+{
+    uint32_t pos = LogRing_Publish(s, (uint32_t)len, kind);
+    if (g_sync) Drain(true);
+    else if (pos % LOG_WAKE_EVERY == LOG_WAKE_EVERY - 1) Plat_EventSet(g_hWake);
+}
 
 void Log(const char* fmt, ...)
 {
-    if (g_hLog == INVALID_HANDLE_VALUE)
-        g_hLog = CreateFileA("csnz_weapons.log", GENERIC_WRITE,
-                             FILE_SHARE_READ, nullptr,
-                             CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
-    char buf[2048];
+    if (g_state.load(std::memory_order_acquire) != 2) InitOnce();
+
+    LogSlot* s = LogRing_Claim(g_ring);
+    if (!s) return;   // ring full: counted, reported by the writer
+
     va_list va; va_start(va, fmt);
-    int n = vsnprintf(buf, sizeof(buf), fmt, va);
+    int n = vsnprintf(s->data, LOG_SLOT_PAYLOAD, fmt, va);
     va_end(va);
-    if (n > 0 && g_hLog != INVALID_HANDLE_VALUE)
-    { DWORD w; WriteFile(g_hLog, buf, n, &w, nullptr); FlushFileBuffers(g_hLog); }
+    if (n < 0) n = 0;
+    if ((size_t)n >= LOG_SLOT_PAYLOAD)
+    {
+        n = (int)LOG_SLOT_PAYLOAD - 1;
+        s->data[n - 1] = '\n';   // truncated line still ends the record
+    }
+    Publish(s, (size_t)n, SLOT_TEXT);
+}
+
+void Log_Flush()
+{
+    if (g_state.load(std::memory_order_acquire) != 2) return;
+    // Everything claimed before this call goes to disk: wait out a drain in
+    // progress (the writer may be holding a batch), then empty the ring up
+    // to here, lines still being formatted on other threads included. The
+    // wait is bounded: a writer killed mid-drain never lets go.
+    uint32_t upto = g_ring.head.load(std::memory_order_acquire);
+    for (uint32_t t0 = Plat_TickMs(); g_draining.test_and_set(std::memory_order_acquire); Plat_Yield())
+        if (Plat_TickMs() - t0 > LOG_FLUSH_MS) return;
+    DrainLocked(true, upto);
+    g_draining.clear(std::memory_order_release);
+}
+
+void Log_FlushAtExit(bool terminating)
+{
+    if (g_state.load(std::memory_order_acquire) != 2) return;
+    if (!terminating) { Log_Flush(); return; }
+    // ExitProcess has already killed every other thread, the writer
+    // possibly while it held g_draining: take what was published and don't
+    // wait for slots nobody will finish.
+    DrainLocked(true, g_ring.tail);
+}
+
+// -------------------------------------------------------------------------
+// Binary mode
+// -------------------------------------------------------------------------
+void Log_SetBinary(bool on)
+{
+    if (g_state.load(std::memory_order_acquire) != 2) InitOnce();
+    if (on && !g_bin.h)
+    {
+        void* h = Plat_FileCreate("csnz_weapons.bin");
+        if (!h) { Log("[log] cannot create csnz_weapons.bin\n"); return; }
+        Plat_FileWrite(h, LOGBIN_MAGIC, sizeof(LOGBIN_MAGIC));
+        g_bin.h = h;
+    }
+    g_binary.store(on, std::memory_order_release);
+    Log("[log] binary mode %s\n", on ? "on" : "off");
+}
+
+bool Log_Binary()
+{
+    return g_binary.load(std::memory_order_acquire);
+}
+
+uint8_t* Log_BinClaim(void*& slot, size_t& room)
+{
+    LogSlot* s = LogRing_Claim(g_ring);
+    slot = s;
+    room = LOG_SLOT_PAYLOAD;
+    return s ? reinterpret_cast<uint8_t*>(s->data) : nullptr;
+}
+
+void Log_BinCommit(void* slot, size_t len)
+{
+    // len == 0 means the record did not fit; publish it empty so the slot recycles.
+    Publish(static_cast<LogSlot*>(slot), len, SLOT_BIN);
+}
+
+void Log_BinDefine(LogSite& site, const char* types, int nargs)
+{
+    uint32_t id = site.id.load(std::memory_order_acquire);
+    if (!id)
+    {
+        uint32_t fresh = g_nextSiteId.fetch_add(1, std::memory_order_relaxed) + 1;
+        id = site.id.compare_exchange_strong(id, fresh) ? fresh : id;
+    }
+
+    // Racing threads may both emit a DEF; the decoder keeps the first.
+    void*  slot = nullptr;
+    size_t room = 0;
+    uint8_t* p = Log_BinClaim(slot, room);
+    if (!p) return;   // dropped: retried on the next call from this site
+    size_t len = LogBin_EncodeDef(p, room, id, types, nargs, site.fmt);
+    Log_BinCommit(slot, len);
+    if (len) site.defined.store(true, std::memory_order_release);
+}
+
+// -------------------------------------------------------------------------
+// Levels
+// -------------------------------------------------------------------------
+static const char* const g_subNames[LOGSUB_COUNT] = {
+#define LOG_SUB_NAME(name) #name,
+    LOG_SUBSYSTEMS(LOG_SUB_NAME)
+#undef LOG_SUB_NAME
+};
+
+static const char* const g_levelNames[] = { "trace", "debug", "info", "warn", "error", "off" };
+
+static int ParseLevel(const char* s, size_t n)
+{
+    for (int i = 0; i <= LOG_LVL_OFF; i++)
+        if (strlen(g_levelNames[i]) == n && !strncmp(g_levelNames[i], s, n)) return i;
+    return -1;
+}
+
+void Log_SetLevel(LogSub sub, int level)
+{
+    if (sub >= 0 && sub < LOGSUB_COUNT) g_logLevel[sub] = (uint8_t)level;
+}
+
+bool Log_Configure(const char* spec)
+{
+    bool ok = true;
+    for (const char* p = spec; *p; )
+    {
+        size_t len = strcspn(p, ",");
+        const char* eq = (const char*)memchr(p, '=', len);
+        if (!eq)
+        {
+            int lvl = ParseLevel(p, len);
+            if (lvl < 0) ok = false;
+            else for (int i = 0; i < LOGSUB_COUNT; i++) g_logLevel[i] = (uint8_t)lvl;
+        }
+        else
+        {
+            int lvl = ParseLevel(eq + 1, len - (size_t)(eq + 1 - p));
+            int sub = -1;
+            for (int i = 0; i < LOGSUB_COUNT; i++)
+                if (strlen(g_subNames[i]) == (size_t)(eq - p) && !strncmp(g_subNames[i], p, eq - p)) sub = i;
+            if (lvl < 0 || sub < 0) ok = false;
+            else g_logLevel[sub] = (uint8_t)lvl;
+        }
+        p += len;
+        if (*p == ',') p++;
+    }
+    return ok;
 }
@@ -1,2 +1,97 @@
 #pragma once
+#include "log_bin.h"
+
 void Log(const char* fmt, ...);
+void Log_Flush();   // drain pending lines and flush now (shutdown / before a risky step)
+// From DLL_PROCESS_DETACH. terminating (lpReserved != NULL): the other
+// threads are gone, so drain without the writer's lock.
+void Log_FlushAtExit(bool terminating);
+
+// Binary mode: LOG_FAST sites record raw arguments to csnz_weapons.bin
+// instead of formatting (decode with tools/logdecode). Defaults to the
+// CSNZ_LOG_BINARY build option; plain Log() is always text.
+void     Log_SetBinary(bool on);
+bool     Log_Binary();
+uint8_t* Log_BinClaim(void*& slot, size_t& room);
+void     Log_BinCommit(void* slot, size_t len);
+void     Log_BinDefine(LogSite& site, const char* types, int nargs);
+
+template<typename... Args>
+inline void Log_Fast(LogSite& site, const Args&... args)
+{
+    if (!Log_Binary()) { Log(site.fmt, args...); return; }
+
+    typedef LogArgTypes<Args...> Types;
+    if (!site.defined.load(std::memory_order_acquire))
+        Log_BinDefine(site, Types::str, Types::count);
+
+    void*  slot = nullptr;
+    size_t room = 0;
+    uint8_t* p = Log_BinClaim(slot, room);
+    if (p) Log_BinCommit(slot, LogBin_EncodeMsg(p, room, site.id.load(std::memory_order_relaxed), args...));
+}
+
+#define LOG_FAST(fmt, ...) \
+    do { static LogSite s_logSite = { fmt, {0}, {false} }; Log_Fast(s_logSite, ##__VA_ARGS__); } while (0)
+
+// -------------------------------------------------------------------------
+// Levelled, per-subsystem logging:  LOG_INFO(hooks, "installed %d\n", n);
+// prints "[hooks] installed 3". Levels below CSNZ_LOG_MIN_LEVEL are removed
+// by the preprocessor; the rest are checked against a per-subsystem runtime
+// level, set with Log_SetLevel or the CSNZ_LOG environment variable
+// ("info", "hooks=trace,janus1=off", ...).
+// -------------------------------------------------------------------------
+#define LOG_LVL_TRACE 0
+#define LOG_LVL_DEBUG 1
+#define LOG_LVL_INFO  2
+#define LOG_LVL_WARN  3
+#define LOG_LVL_ERROR 4
+#define LOG_LVL_OFF   5
+
+#ifndef CSNZ_LOG_MIN_LEVEL
+#define CSNZ_LOG_MIN_LEVEL LOG_LVL_INFO
+#endif
+
+// Subsystem tags; the enumerators are named after the tag text.
+#define LOG_SUBSYSTEMS(X) \
+    X(main)               \
+    X(hooks)              \
+    X(janus1)
+
+enum LogSub
+{
+#define LOG_SUB_ENUM(name) LOGSUB_##name,
+    LOG_SUBSYSTEMS(LOG_SUB_ENUM)
+#undef LOG_SUB_ENUM
+    LOGSUB_COUNT
+};
+
+extern uint8_t g_logLevel[LOGSUB_COUNT];   // runtime minimum per subsystem (0 = all)
+
+void Log_SetLevel(LogSub sub, int level);
+bool Log_Configure(const char* spec);   // "level" or "sub=level,..."; false on a bad entry
+
+#define LOG_AT(lvl, sub, fmt, ...) \
+    do { if ((lvl) >= g_logLevel[LOGSUB_##sub]) LOG_FAST("[" #sub "] " fmt, ##__VA_ARGS__); } while (0)
+
+#if CSNZ_LOG_MIN_LEVEL <= LOG_LVL_TRACE
+#define LOG_TRACE(sub, fmt, ...) LOG_AT(LOG_LVL_TRACE, sub, fmt, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(sub, fmt, ...) ((void)0)
+#endif
+#if CSNZ_LOG_MIN_LEVEL <= LOG_LVL_DEBUG
+#define LOG_DEBUG(sub, fmt, ...) LOG_AT(LOG_LVL_DEBUG, sub, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(sub, fmt, ...) ((void)0)
+#endif
+#if CSNZ_LOG_MIN_LEVEL <= LOG_LVL_INFO
+#define LOG_INFO(sub, fmt, ...)  LOG_AT(LOG_LVL_INFO, sub, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(sub, fmt, ...)  ((void)0)
+#endif
+#if CSNZ_LOG_MIN_LEVEL <= LOG_LVL_WARN
+#define LOG_WARN(sub, fmt, ...)  LOG_AT(LOG_LVL_WARN, sub, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(sub, fmt, ...)  ((void)0)
+#endif
+#define LOG_ERROR(sub, fmt, ...) LOG_AT(LOG_LVL_ERROR, sub, fmt, ##__VA_ARGS__)
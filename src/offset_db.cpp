@@ -0,0 +1,184 @@
+// offset_db.cpp - csnz_offsets.txt parser and the g_offsets table
+#include "offset_db.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define OFS_ENTRY_WPN(name, type, off) { OFSG_WPN, #name, off, Fld_Size<type>(), Fld_Align<type>() },
+#define OFS_ENTRY_PLR(name, type, off) { OFSG_PLR, #name, off, Fld_Size<type>(), Fld_Align<type>() },
+#define OFS_ENTRY_RVA(name, rva)       { OFSG_RVA, #name, rva, 0, 1 },
+const OfsDbEntry OFFSET_DB_ENTRIES[OFS_COUNT] = {
+    CSNZ_WEAPON_FIELDS(OFS_ENTRY_WPN)
+    CSNZ_PLAYER_FIELDS(OFS_ENTRY_PLR)
+    MP_RVAS(OFS_ENTRY_RVA)
+};
+
+#define OFS_DEF_FIELD(name, type, off) off,
+#define OFS_DEF_RVA(name, rva)         rva,
+int32_t g_offsets[OFS_COUNT] = {
+    CSNZ_WEAPON_FIELDS(OFS_DEF_FIELD)
+    CSNZ_PLAYER_FIELDS(OFS_DEF_FIELD)
+    MP_RVAS(OFS_DEF_RVA)
+};
+
+static bool g_overridden[OFS_COUNT];
+
+static const char* const GROUP_PREFIX[] = { "wpn", "plr", "rva" };
+
+static int FindKey(const char* key)
+{
+    const char* dot = strchr(key, '.');
+    if (!dot) return -1;
+    for (int i = 0; i < OFS_COUNT; i++)
+    {
+        const OfsDbEntry& e = OFFSET_DB_ENTRIES[i];
+        const char* g = GROUP_PREFIX[e.group];
+        if ((size_t)(dot - key) == strlen(g) && !strncmp(key, g, dot - key) && !strcmp(dot + 1, e.name))
+            return i;
+    }
+    return -1;
+}
+
+static void Report(OfsDbErrorFn err, void* ctx, int line, const char* fmt, const char* arg)
+{
+    if (!err) return;
+    char msg[160];
+    snprintf(msg, sizeof(msg), fmt, arg);
+    err(ctx, line, msg);
+}
+
+bool OffsetDb_Parse(const char* path, std::vector<OfsDbSection>& out, OfsDbErrorFn err, void* ctx)
+{
+    out.clear();
+    FILE* f = fopen(path, "r");
+    if (!f) { Report(err, ctx, 0, "can't open %s", path); return false; }
+
+    char line[256];
+    int  ln = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), f))
+    {
+        ln++;
+        if (char* h = strchr(line, '#')) *h = 0;
+        char key[64], val[32], extra[2];
+        unsigned a, b, c;
+        if (sscanf(line, " %1s", extra) != 1) continue;   // blank
+
+        if (sscanf(line, " [mp %x %x %x ] %1s", &a, &b, &c, extra) == 3 && strchr(line, ']'))
+        {
+            OfsDbSection s;
+            memset(&s, 0, sizeof(s));
+            s.key  = { a, b, c };
+            s.line = ln;
+            for (const OfsDbSection& o : out)
+                if (o.key.timeDateStamp == a && o.key.checkSum == b && o.key.sizeOfImage == c)
+                {
+                    Report(err, ctx, ln, "%s", "duplicate section for this mp.dll build");
+                    ok = false;
+                }
+            out.push_back(s);
+            continue;
+        }
+        if (sscanf(line, " %63s %31s %1s", key, val, extra) != 2)
+        {
+            Report(err, ctx, ln, "%s", line[0] == '[' ? "bad section header" : "expected '<group>.<name> <value>'");
+            ok = false;
+            continue;
+        }
+        if (out.empty()) { Report(err, ctx, ln, "%s outside a [mp ...] section", key); ok = false; continue; }
+
+        int id = FindKey(key);
+        if (id < 0) { Report(err, ctx, ln, "unknown key '%s'", key); ok = false; continue; }
+
+        char* end = nullptr;
+        long v = strtol(val, &end, 0);
+        if (*end || v < 0 || v > 0x7FFFFFFF) { Report(err, ctx, ln, "bad value '%s'", val); ok = false; continue; }
+
+        OfsDbSection& s = out.back();
+        if (s.set[id]) { Report(err, ctx, ln, "'%s' set twice in this section", key); ok = false; continue; }
+        s.value[id] = (int32_t)v;
+        s.set[id]   = true;
+    }
+    fclose(f);
+    return ok;
+}
+
+int OffsetDb_CheckLayout(const OfsDbSection& s)
+{
+    for (int g = OFSG_WPN; g <= OFSG_PLR; g++)
+    {
+        FieldInfo fi[OFS_COUNT];
+        int       ids[OFS_COUNT];
+        int       n = 0;
+        for (int i = 0; i < OFS_COUNT; i++)
+        {
+            const OfsDbEntry& e = OFFSET_DB_ENTRIES[i];
+            if (e.group != g) continue;
+            fi[n]  = { e.name, s.set[i] ? s.value[i] : e.def, e.size, e.align };
+            ids[n] = i;
+            n++;
+        }
+        int bad = Layout_FirstMisaligned(fi, n);
+        if (bad < 0) bad = Layout_FirstOverlap(fi, n);
+        if (bad >= 0) return ids[bad];
+    }
+    return -1;
+}
+
+int OffsetDb_Load(const char* path, const PeKey& mp, OfsDbErrorFn err, void* ctx)
+{
+    FILE* probe = fopen(path, "r");
+    if (!probe) return 0;
+    fclose(probe);
+
+    std::vector<OfsDbSection> secs;
+    if (!OffsetDb_Parse(path, secs, err, ctx)) return -1;
+
+    for (const OfsDbSection& s : secs)
+    {
+        if (s.key.timeDateStamp != mp.timeDateStamp || s.key.checkSum != mp.checkSum
+            || s.key.sizeOfImage != mp.sizeOfImage)
+            continue;
+
+        int bad = OffsetDb_CheckLayout(s);
+        if (bad >= 0)
+        {
+            Report(err, ctx, s.line, "section puts '%s' on top of another field or misaligns it",
+                   OFFSET_DB_ENTRIES[bad].name);
+            return -1;
+        }
+        int n = 0;
+        for (int i = 0; i < OFS_COUNT; i++)
+        {
+            if (!s.set[i]) continue;
+            g_offsets[i]    = s.value[i];
+            g_overridden[i] = true;
+            n++;
+        }
+        return n;
+    }
+    return 0;
+}
+
+bool OffsetDb_Overridden(OffsetId id)
+{
+    return g_overridden[id];
+}
+
+void OffsetDb_Reset()
+{
+    for (int i = 0; i < OFS_COUNT; i++) g_offsets[i] = OFFSET_DB_ENTRIES[i].def;
+    memset(g_overridden, 0, sizeof(g_overridden));
+}
+
+uint32_t OffsetDb_DefaultsHash()
+{
+    uint32_t h = ADDR_CACHE_HASH0;
+    for (const OfsDbEntry& e : OFFSET_DB_ENTRIES)
+    {
+        int32_t v[3] = { (int32_t)e.group, e.def, e.size };
+        h = AddrCache_Hash(h, e.name, strlen(e.name) + 1);
+        h = AddrCache_Hash(h, v, sizeof(v));
+    }
+    return h;
+}
@@ -0,0 +1,65 @@
+#pragma once
+// offset_db.h - runtime offset database (csnz_offsets.txt).
+// Every field offset in csnz_layout.h (WpnF, PlrF) and every RVA in
+// mp_offsets.h (MP_RVAS) has a slot in g_offsets[], indexed by OffsetId and
+// preset to the compiled-in value. At attach, the file's section for the
+// running mp.dll overrides any of them, so a game patch that only moves
+// things needs a new text file instead of a new DLL. Validate a file with
+// csnz_offsetcheck before shipping it.
+//
+//   # comment
+//   [mp 5F3A1B2C 01E2D4A1 01F4A000]    TimeDateStamp CheckSum SizeOfImage (hex)
+//   wpn.iClip     0x160
+//   plr.frozen    0x1861
+//   rva.pGlobals  0x1E52BCC
+//
+// Keys are <group>.<name> with groups wpn, plr and rva. Unlisted keys keep
+// their defaults; sections for other builds are ignored.
+
+#include "addr_cache.h"
+#include "hlsdk/csnz_layout.h"
+#include <cstdint>
+#include <vector>
+
+enum OfsGroup { OFSG_WPN, OFSG_PLR, OFSG_RVA };
+
+struct OfsDbEntry
+{
+    OfsGroup    group;
+    const char* name;     // without the group prefix
+    int32_t     def;      // compiled-in value
+    int         size;     // field size, 0 for RVAs
+    int         align;
+};
+
+extern const OfsDbEntry OFFSET_DB_ENTRIES[OFS_COUNT];
+
+struct OfsDbSection
+{
+    PeKey   key;
+    int     line;
+    int32_t value[OFS_COUNT];
+    bool    set[OFS_COUNT];
+};
+
+// Called once per problem found while parsing; line 0 = whole file.
+typedef void (*OfsDbErrorFn)(void* ctx, int line, const char* msg);
+
+// Parse every section of the file. False (after reporting) on any bad line,
+// unknown key or duplicate; out then holds what did parse.
+bool OffsetDb_Parse(const char* path, std::vector<OfsDbSection>& out, OfsDbErrorFn err, void* ctx);
+// Fields of a section (defaults filled in) that overlap another field of
+// the same object or are misaligned; -1 if the layout is sound.
+int  OffsetDb_CheckLayout(const OfsDbSection& s);
+// Apply the section matching mp to g_offsets. Returns the number of values
+// applied: 0 if the file or section is missing, -1 if the file is invalid
+// (nothing applied).
+int  OffsetDb_Load(const char* path, const PeKey& mp, OfsDbErrorFn err, void* ctx);
+bool OffsetDb_Overridden(OffsetId id);
+// Back to the compiled-in values.
+void OffsetDb_Reset();
+// Hash of every compiled-in default (OFFSET_DB_ENTRIES, so MP_RVAS too).
+// Part of the address cache key: new defaults invalidate old entries.
+uint32_t OffsetDb_DefaultsHash();
+
+inline uint32_t Ofs_Rva(OffsetId id) { return (uint32_t)g_offsets[id]; }
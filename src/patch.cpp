@@ -0,0 +1,113 @@
+// patch.cpp - page-grouped patch transactions with rollback
+#include "patch.h"
+#include <algorithm>
+#include <cstring>
+
+bool PatchBatch::Fail(const char* what, uintptr_t addr)
+{
+    m_error = what;
+    m_errorAddr = addr;
+    return false;
+}
+
+bool PatchBatch::Add(uintptr_t addr, const void* bytes, size_t len, void* saveOrig)
+{
+    if (m_committed)                             return Fail("batch already committed", addr);
+    if (!bytes || !len || len > PATCH_MAX_BYTES) return Fail("bad write size", addr);
+    PatchWrite w = {};
+    w.addr = addr;
+    w.len  = (uint32_t)len;
+    w.saveOrig = saveOrig;
+    memcpy(w.bytes, bytes, len);
+    m_writes.push_back(w);
+    return true;
+}
+
+bool PatchBatch::AddJmp5(uintptr_t from, uintptr_t to, void* saveOrig)
+{
+    uint8_t jmp[5] = { 0xE9 };
+    int32_t rel = (int32_t)(to - from - 5);
+    memcpy(jmp + 1, &rel, 4);
+    return Add(from, jmp, 5, saveOrig);
+}
+
+bool PatchBatch::AddPointer(void** slot, void* value, void** saveOrig)
+{
+    return Add((uintptr_t)slot, &value, sizeof(value), saveOrig);
+}
+
+bool PatchBatch::Plan(size_t pageSize, std::vector<uintptr_t>& pages)
+{
+    std::sort(m_writes.begin(), m_writes.end(),
+              [](const PatchWrite& a, const PatchWrite& b) { return a.addr < b.addr; });
+
+    pages.clear();
+    uintptr_t mask = ~(uintptr_t)(pageSize - 1);
+    for (size_t i = 0; i < m_writes.size(); i++)
+    {
+        const PatchWrite& w = m_writes[i];
+        if (i && m_writes[i-1].addr + m_writes[i-1].len > w.addr)
+            return Fail("overlapping writes", w.addr);
+        // A write may straddle a page boundary; it then needs both pages.
+        for (uintptr_t p = w.addr & mask; p <= ((w.addr + w.len - 1) & mask); p += pageSize)
+            if (pages.empty() || pages.back() < p) pages.push_back(p);
+    }
+    return true;
+}
+
+bool PatchBatch::Commit(PatchMemory& mem)
+{
+    if (m_committed) return Fail("batch already committed", 0);
+    if (m_writes.empty()) return true;
+
+    std::vector<uintptr_t> pages;
+    if (!Plan(mem.PageSize(), pages)) return false;
+    std::vector<uint32_t> saved(pages.size());
+
+    // 1. one protection flip per page
+    size_t unprotected = 0;
+    for (; unprotected < pages.size(); unprotected++)
+        if (!mem.Unprotect(pages[unprotected], saved[unprotected])) break;
+
+    // 2. capture every original before anything changes, so callers can
+    //    publish them (e.g. "call original" pointers) ahead of the writes
+    bool ok = unprotected == pages.size();
+    if (!ok) Fail("unprotect failed", pages[unprotected]);
+    for (size_t i = 0; ok && i < m_writes.size(); i++)
+        if (!mem.Read(m_writes[i].addr, m_writes[i].orig, m_writes[i].len))
+            ok = Fail("read failed", m_writes[i].addr);
+    if (ok)
+        for (const PatchWrite& w : m_writes)
+            if (w.saveOrig) memcpy(w.saveOrig, w.orig, w.len);
+
+    // 3. apply; on a failed write undo everything attempted, newest first
+    //    (including the failed one, in case it landed partially)
+    size_t attempted = 0;
+    while (ok && attempted < m_writes.size())
+    {
+        const PatchWrite& w = m_writes[attempted++];
+        if (!mem.Write(w.addr, w.bytes, w.len)) ok = Fail("write failed", w.addr);
+    }
+    if (!ok)
+        for (size_t i = attempted; i-- > 0; )
+            mem.Write(m_writes[i].addr, m_writes[i].orig, m_writes[i].len);
+
+    // 4. restore protections and make new code visible
+    for (size_t i = 0; i < unprotected; i++)
+        mem.Restore(pages[i], saved[i]);
+    if (ok)
+        for (const PatchWrite& w : m_writes) mem.FlushCode(w.addr, w.len);
+
+    m_committed = ok;
+    return ok;
+}
+
+bool PatchBatch::Revert(PatchMemory& mem)
+{
+    if (!m_committed) return Fail("nothing committed", 0);
+    PatchBatch undo;
+    for (const PatchWrite& w : m_writes) undo.Add(w.addr, w.orig, w.len);
+    if (!undo.Commit(mem)) return Fail(undo.Error(), undo.ErrorAddr());
+    m_committed = false;
+    return true;
+}
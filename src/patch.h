@@ -0,0 +1,64 @@
+#pragma once
+// patch.h - batched memory patch transactions.
+// Collect every byte write first, then Commit(): each touched page is made
+// writable exactly once, all originals are captured, everything is written,
+// and protections are restored. Any failure rolls the whole batch back.
+// The page planner only talks to a PatchMemory backend, so it runs against
+// a fake memory model as well as the live process.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const size_t PATCH_MAX_BYTES = 16;
+
+// Backend: the live process (Patch_ProcessMemory) or a test double.
+struct PatchMemory
+{
+    virtual ~PatchMemory() {}
+    virtual size_t PageSize() = 0;
+    // Make [page, page+PageSize) writable, returning an opaque token for Restore.
+    virtual bool   Unprotect(uintptr_t page, uint32_t& saved) = 0;
+    virtual bool   Restore(uintptr_t page, uint32_t saved) = 0;
+    virtual bool   Read(uintptr_t addr, void* dst, size_t len) = 0;
+    virtual bool   Write(uintptr_t addr, const void* src, size_t len) = 0;
+    virtual void   FlushCode(uintptr_t /*addr*/, size_t /*len*/) {}
+};
+
+PatchMemory& Patch_ProcessMemory();
+
+struct PatchWrite
+{
+    uintptr_t addr;
+    uint32_t  len;
+    uint8_t   bytes[PATCH_MAX_BYTES];
+    uint8_t   orig[PATCH_MAX_BYTES];  // filled by Commit
+    void*     saveOrig;               // optional: receives orig before anything is written
+};
+
+class PatchBatch
+{
+public:
+    bool Add(uintptr_t addr, const void* bytes, size_t len, void* saveOrig = nullptr);
+    bool AddJmp5(uintptr_t from, uintptr_t to, void* saveOrig = nullptr);
+    bool AddPointer(void** slot, void* value, void** saveOrig = nullptr);
+
+    // Distinct pages touched, ascending. Fails on overlapping writes.
+    bool Plan(size_t pageSize, std::vector<uintptr_t>& pages);
+    // All-or-nothing apply. On failure memory and protections are unchanged.
+    bool Commit(PatchMemory& mem);
+    // Put back the bytes captured by a successful Commit, as one batch.
+    bool Revert(PatchMemory& mem);
+
+    int         Count() const        { return (int)m_writes.size(); }
+    const char* Error() const        { return m_error; }
+    uintptr_t   ErrorAddr() const    { return m_errorAddr; }
+
+private:
+    bool Fail(const char* what, uintptr_t addr);
+
+    std::vector<PatchWrite> m_writes;
+    bool                    m_committed = false;
+    const char*             m_error     = nullptr;
+    uintptr_t               m_errorAddr = 0;
+};
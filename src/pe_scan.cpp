@@ -0,0 +1,203 @@
+// pe_scan.cpp - PE section parsing + SSE2/AVX2 pointer-run scanner
+#include "pe_scan.h"
+#include "cpu_features.h"
+#include <cstring>
+
+#ifdef CPU_X86
+#  define PE_SCAN_X86 1
+#endif
+
+// IMAGE_SCN_* characteristics we care about
+static const uint32_t SCN_CNT_INITIALIZED_DATA = 0x00000040;
+static const uint32_t SCN_MEM_EXECUTE          = 0x20000000;
+static const uint32_t SCN_MEM_READ             = 0x40000000;
+
+template<typename T>
+static inline T ReadLE(const uint8_t* p)
+{
+    T v; memcpy(&v, p, sizeof(T)); return v;
+}
+
+// -------------------------------------------------------------------------
+// Headers
+// -------------------------------------------------------------------------
+bool Pe_Parse(const uint8_t* data, size_t size, bool mapped, PeImage& out)
+{
+    memset(&out, 0, sizeof(out));
+    if (!data || size < 0x40 || data[0] != 'M' || data[1] != 'Z') return false;
+
+    uint32_t lfanew = ReadLE<uint32_t>(data + 0x3C);
+    if ((size_t)lfanew + 24 + 96 > size) return false;
+    const uint8_t* nt = data + lfanew;
+    if (ReadLE<uint32_t>(nt) != 0x00004550) return false;      // "PE\0\0"
+
+    uint16_t nsec   = ReadLE<uint16_t>(nt + 6);
+    uint16_t optLen = ReadLE<uint16_t>(nt + 20);
+    const uint8_t* opt = nt + 24;
+    if (ReadLE<uint16_t>(opt) != 0x10B) return false;          // PE32 only
+
+    out.data          = data;
+    out.size          = size;
+    out.mapped        = mapped;
+    out.timeDateStamp = ReadLE<uint32_t>(nt + 8);
+    out.imageBase     = ReadLE<uint32_t>(opt + 28);
+    out.sizeOfImage   = ReadLE<uint32_t>(opt + 56);
+    out.checkSum      = ReadLE<uint32_t>(opt + 64);
+
+    size_t secOff = (size_t)lfanew + 24 + optLen;
+    if (nsec > PE_MAX_SECTIONS || secOff + (size_t)nsec * 40 > size) return false;
+    for (int i = 0; i < nsec; i++)
+    {
+        const uint8_t* sh = data + secOff + (size_t)i * 40;
+        PeSection& s = out.sections[i];
+        memcpy(s.name, sh, 8); s.name[8] = 0;
+        s.vsize   = ReadLE<uint32_t>(sh + 8);
+        s.rva     = ReadLE<uint32_t>(sh + 12);
+        s.rawSize = ReadLE<uint32_t>(sh + 16);
+        s.rawOff  = ReadLE<uint32_t>(sh + 20);
+        s.flags   = ReadLE<uint32_t>(sh + 36);
+    }
+    out.numSections = nsec;
+    return true;
+}
+
+bool Pe_ParseModule(const void* base, PeImage& out)
+{
+    // Headers of a loaded module are always mapped; read SizeOfImage first.
+    const uint8_t* p = static_cast<const uint8_t*>(base);
+    if (!Pe_Parse(p, 0x1000, true, out)) return false;
+    return Pe_Parse(p, out.sizeOfImage, true, out);
+}
+
+const uint8_t* Pe_SectionData(const PeImage& img, const PeSection& s, size_t& outLen)
+{
+    size_t off = img.mapped ? s.rva : s.rawOff;
+    size_t len = img.mapped ? (s.vsize ? s.vsize : s.rawSize)
+                            : (s.vsize && s.vsize < s.rawSize ? s.vsize : s.rawSize);
+    if (off >= img.size) { outLen = 0; return nullptr; }
+    if (len > img.size - off) len = img.size - off;
+    outLen = len;
+    return img.data + off;
+}
+
+bool Pe_IsDataSection(const PeSection& s)
+{
+    return (s.flags & SCN_CNT_INITIALIZED_DATA) && (s.flags & SCN_MEM_READ)
+        && !(s.flags & SCN_MEM_EXECUTE);
+}
+
+// -------------------------------------------------------------------------
+// Run tracking. Indices are dword indices into the scanned buffer.
+// -------------------------------------------------------------------------
+struct RunState
+{
+    size_t cur, curStart;
+    size_t best, bestStart;
+};
+
+static inline void RunClose(RunState& s)
+{
+    if (s.cur > s.best) { s.best = s.cur; s.bestStart = s.curStart; }
+    s.cur = 0;
+}
+
+static inline void RunPush(RunState& s, size_t i, bool in)
+{
+    if (in) { if (!s.cur) s.curStart = i; s.cur++; }
+    else if (s.cur) RunClose(s);
+}
+
+// Apply a W-lane in-range mask for the block starting at dword index i.
+static inline void RunBlock(RunState& s, size_t i, unsigned mask, int w)
+{
+    unsigned full = (1u << w) - 1;
+    if (mask == full) { if (!s.cur) s.curStart = i; s.cur += w; }
+    else if (mask == 0) { if (s.cur) RunClose(s); }
+    else for (int k = 0; k < w; k++) RunPush(s, i + k, (mask >> k) & 1);
+}
+
+// (v - lo) < span as an unsigned compare covers v in [lo, lo+span).
+static size_t ScanScalar(const uint8_t* p, size_t n, size_t i,
+                         uint32_t lo, uint32_t span, RunState& s)
+{
+    for (; i < n; i++) RunPush(s, i, ReadLE<uint32_t>(p + i*4) - lo < span);
+    return i;
+}
+
+#ifdef PE_SCAN_X86
+// SSE2 has only signed compares: bias both sides by 0x80000000.
+CPU_TARGET_SSE2
+static size_t ScanSse2(const uint8_t* p, size_t n, uint32_t lo, uint32_t span, RunState& s)
+{
+    const __m128i vlo   = _mm_set1_epi32((int)lo);
+    const __m128i bias  = _mm_set1_epi32((int)0x80000000u);
+    const __m128i vspan = _mm_xor_si128(_mm_set1_epi32((int)span), bias);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i*4));
+        __m128i d  = _mm_xor_si128(_mm_sub_epi32(v, vlo), bias);
+        __m128i in = _mm_cmplt_epi32(d, vspan);
+        RunBlock(s, i, (unsigned)_mm_movemask_ps(_mm_castsi128_ps(in)), 4);
+    }
+    return i;
+}
+
+CPU_TARGET_AVX2
+static size_t ScanAvx2(const uint8_t* p, size_t n, uint32_t lo, uint32_t span, RunState& s)
+{
+    const __m256i vlo   = _mm256_set1_epi32((int)lo);
+    const __m256i bias  = _mm256_set1_epi32((int)0x80000000u);
+    const __m256i vspan = _mm256_xor_si256(_mm256_set1_epi32((int)span), bias);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i*4));
+        __m256i d  = _mm256_xor_si256(_mm256_sub_epi32(v, vlo), bias);
+        __m256i in = _mm256_cmpgt_epi32(vspan, d);
+        RunBlock(s, i, (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(in)), 8);
+    }
+    return i;
+}
+
+#endif
+
+PtrRun FindPointerRun(const uint8_t* p, size_t len, uint32_t rva0, uint32_t lo, uint32_t hi)
+{
+    PtrRun r = { 0, 0 };
+    if (!p || hi <= lo) return r;
+
+    size_t n = len / 4;
+    uint32_t span = hi - lo;
+    RunState s = { 0, 0, 0, 0 };
+    size_t i = 0;
+#ifdef PE_SCAN_X86
+    static const bool avx2 = Cpu_HasAvx2();
+    i = avx2 ? ScanAvx2(p, n, lo, span, s) : ScanSse2(p, n, lo, span, s);
+#endif
+    ScanScalar(p, n, i, lo, span, s);
+    RunClose(s);
+
+    if (s.best)
+    {
+        r.rva   = rva0 + (uint32_t)(s.bestStart * 4);
+        r.count = (int)s.best;
+    }
+    return r;
+}
+
+PtrRun Pe_FindPointerRun(const PeImage& img, uint32_t lo, uint32_t hi)
+{
+    PtrRun best = { 0, 0 };
+    for (int i = 0; i < img.numSections; i++)
+    {
+        const PeSection& s = img.sections[i];
+        if (!Pe_IsDataSection(s)) continue;
+        size_t len = 0;
+        const uint8_t* p = Pe_SectionData(img, s, len);
+        if (!p) continue;
+        PtrRun r = FindPointerRun(p, len, s.rva, lo, hi);
+        if (r.count > best.count) best = r;
+    }
+    return best;
+}
@@ -0,0 +1,54 @@
+#pragma once
+// pe_scan.h - PE32 section table parsing and pointer-run scanning.
+// Works on plain byte buffers (no windows.h) so the same code runs on a
+// module mapped by the loader and on an image captured to disk.
+
+#include <cstddef>
+#include <cstdint>
+
+static const int PE_MAX_SECTIONS = 96;
+
+struct PeSection
+{
+    char     name[9];   // NUL-terminated copy of the 8-byte section name
+    uint32_t rva;       // VirtualAddress
+    uint32_t vsize;     // VirtualSize
+    uint32_t rawOff;    // PointerToRawData
+    uint32_t rawSize;   // SizeOfRawData
+    uint32_t flags;     // Characteristics (IMAGE_SCN_*)
+};
+
+struct PeImage
+{
+    const uint8_t* data;
+    size_t         size;
+    bool           mapped;        // true: sections at rva, false: at rawOff
+    uint32_t       imageBase;
+    uint32_t       sizeOfImage;
+    uint32_t       timeDateStamp;
+    uint32_t       checkSum;
+    int            numSections;
+    PeSection      sections[PE_MAX_SECTIONS];
+};
+
+// Longest run of consecutive dwords whose value lies in [lo, hi).
+struct PtrRun
+{
+    uint32_t rva;   // rva of the first dword of the run
+    int      count; // run length in dwords (0 = none)
+};
+
+// Parse the headers of a PE32 image held in [data, data+size).
+bool Pe_Parse(const uint8_t* data, size_t size, bool mapped, PeImage& out);
+// Same, for a module mapped by the loader (size taken from SizeOfImage).
+bool Pe_ParseModule(const void* base, PeImage& out);
+
+// Bytes backing a section (clamped to the buffer), nullptr if none.
+const uint8_t* Pe_SectionData(const PeImage& img, const PeSection& s, size_t& outLen);
+// Initialized, readable, non-executable sections (.data, .rdata, ...).
+bool Pe_IsDataSection(const PeSection& s);
+
+// Scan a dword-aligned buffer; rva0 is the rva of p[0].
+PtrRun FindPointerRun(const uint8_t* p, size_t len, uint32_t rva0, uint32_t lo, uint32_t hi);
+// Scan every data section of img and return the longest run overall.
+PtrRun Pe_FindPointerRun(const PeImage& img, uint32_t lo, uint32_t hi);
@@ -0,0 +1,67 @@
+// loader_notify_win32.cpp - LdrRegisterDllNotification (Vista+)
+#include "../loader_notify.h"
+#include <windows.h>
+#include <cwchar>
+
+// Not in the SDK headers.
+struct LdrUnicodeString
+{
+    USHORT length;           // bytes
+    USHORT maximumLength;
+    PWSTR  buffer;
+};
+
+struct LdrDllNotificationData
+{
+    ULONG                   flags;
+    const LdrUnicodeString* fullDllName;
+    const LdrUnicodeString* baseDllName;
+    PVOID                   dllBase;
+    ULONG                   sizeOfImage;
+};
+
+typedef VOID (CALLBACK* LdrDllNotificationFn)(ULONG reason, const LdrDllNotificationData* data, PVOID ctx);
+typedef LONG (NTAPI* LdrRegisterDllNotificationFn)(ULONG flags, LdrDllNotificationFn fn, PVOID ctx, PVOID* cookie);
+typedef LONG (NTAPI* LdrUnregisterDllNotificationFn)(PVOID cookie);
+
+static const ULONG LDR_REASON_LOADED   = 1;
+static const ULONG LDR_REASON_UNLOADED = 2;
+
+static const wchar_t* g_name   = nullptr;
+static LoaderNotifyFn g_fn     = nullptr;
+static void*          g_ctx    = nullptr;
+static PVOID          g_cookie = nullptr;
+
+static VOID CALLBACK OnDllNotification(ULONG reason, const LdrDllNotificationData* data, PVOID)
+{
+    const LdrUnicodeString* n = data ? data->baseDllName : nullptr;
+    if (!n || !n->buffer || !g_fn) return;
+    size_t len = n->length / sizeof(wchar_t);
+    if (len != wcslen(g_name) || _wcsnicmp(n->buffer, g_name, len)) return;
+
+    if (reason == LDR_REASON_LOADED)        g_fn(true, data->dllBase, g_ctx);
+    else if (reason == LDR_REASON_UNLOADED) g_fn(false, data->dllBase, g_ctx);
+}
+
+bool LoaderNotify_Watch(const wchar_t* baseName, LoaderNotifyFn fn, void* ctx)
+{
+    if (g_cookie || !baseName || !fn) return false;
+    auto reg = (LdrRegisterDllNotificationFn)GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrRegisterDllNotification");
+    if (!reg) return false;
+
+    g_name = baseName; g_fn = fn; g_ctx = ctx;
+    if (reg(0, OnDllNotification, nullptr, &g_cookie) < 0)
+    {
+        g_cookie = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void LoaderNotify_Stop()
+{
+    if (!g_cookie) return;
+    auto unreg = (LdrUnregisterDllNotificationFn)GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrUnregisterDllNotification");
+    if (unreg) unreg(g_cookie);
+    g_cookie = nullptr;
+}
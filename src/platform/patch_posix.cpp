@@ -0,0 +1,74 @@
+// patch_posix.cpp - PatchMemory backend for the running process (Linux)
+#include "../patch.h"
+#include "platform.h"
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Linux has no VirtualQuery: a page's protection comes from the mapping
+// that holds it in /proc/self/maps. One read per page per batch.
+static bool QueryProt(uintptr_t addr, int& prot)
+{
+    FILE* f = fopen("/proc/self/maps", "r");
+    if (!f) return false;
+    char line[4096];
+    bool found = false, lineStart = true;
+    while (!found && fgets(line, sizeof(line), f))
+    {
+        // Only the head of a line holds the range; skip the rest of a long path.
+        bool head = lineStart;
+        lineStart = strchr(line, '\n') != nullptr;
+        unsigned long lo, hi;
+        char perms[8];
+        if (!head || sscanf(line, "%lx-%lx %7s", &lo, &hi, perms) != 3) continue;
+        if (addr < lo || addr >= hi) continue;
+        prot = (perms[0] == 'r' ? PROT_READ : 0) | (perms[1] == 'w' ? PROT_WRITE : 0)
+             | (perms[2] == 'x' ? PROT_EXEC : 0);
+        found = true;
+    }
+    fclose(f);
+    return found;
+}
+
+struct ProcessMemory : PatchMemory
+{
+    size_t PageSize() override
+    {
+        return (size_t)sysconf(_SC_PAGESIZE);
+    }
+
+    bool Unprotect(uintptr_t page, uint32_t& saved) override
+    {
+        int prot = 0;
+        if (!QueryProt(page, prot)) return false;
+        saved = (uint32_t)prot;
+        return mprotect((void*)page, PageSize(), PROT_READ | PROT_WRITE | PROT_EXEC) == 0;
+    }
+
+    bool Restore(uintptr_t page, uint32_t saved) override
+    {
+        return mprotect((void*)page, PageSize(), (int)saved) == 0;
+    }
+
+    bool Read(uintptr_t addr, void* dst, size_t len) override
+    {
+        return Plat_SafeRead(dst, addr, len);
+    }
+
+    bool Write(uintptr_t addr, const void* src, size_t len) override
+    {
+        return Plat_SafeWrite(addr, src, len);
+    }
+
+    void FlushCode(uintptr_t addr, size_t len) override
+    {
+        __builtin___clear_cache((char*)addr, (char*)addr + len);
+    }
+};
+
+PatchMemory& Patch_ProcessMemory()
+{
+    static ProcessMemory mem;
+    return mem;
+}
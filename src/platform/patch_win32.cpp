@@ -0,0 +1,50 @@
+// patch_win32.cpp - PatchMemory backend for the running process
+#include "../patch.h"
+#include "platform.h"
+#include <windows.h>
+
+struct ProcessMemory : PatchMemory
+{
+    size_t m_page = 0;
+
+    size_t PageSize() override
+    {
+        if (!m_page) { SYSTEM_INFO si; GetSystemInfo(&si); m_page = si.dwPageSize; }
+        return m_page;
+    }
+
+    bool Unprotect(uintptr_t page, uint32_t& saved) override
+    {
+        DWORD old = 0;
+        if (!VirtualProtect((void*)page, PageSize(), PAGE_EXECUTE_READWRITE, &old)) return false;
+        saved = old;
+        return true;
+    }
+
+    bool Restore(uintptr_t page, uint32_t saved) override
+    {
+        DWORD old = 0;
+        return VirtualProtect((void*)page, PageSize(), saved, &old) != 0;
+    }
+
+    bool Read(uintptr_t addr, void* dst, size_t len) override
+    {
+        return Plat_SafeRead(dst, addr, len);
+    }
+
+    bool Write(uintptr_t addr, const void* src, size_t len) override
+    {
+        return Plat_SafeWrite(addr, src, len);
+    }
+
+    void FlushCode(uintptr_t addr, size_t len) override
+    {
+        FlushInstructionCache(GetCurrentProcess(), (const void*)addr, len);
+    }
+};
+
+PatchMemory& Patch_ProcessMemory()
+{
+    static ProcessMemory mem;
+    return mem;
+}
@@ -0,0 +1,36 @@
+#pragma once
+// platform.h - the few OS services csnz_core needs.
+// One implementation per OS (platform_win32.cpp, platform_posix.cpp), so
+// the scanners, registry, logger and weapon code build and run anywhere.
+// Memory backends for patching and stubs follow the same split
+// (patch_*.cpp, stub_arena_*.cpp). Handles are opaque; null = failure.
+
+#include <cstddef>
+#include <cstdint>
+
+// Write-only file, truncated on open, readable by others while we write.
+void*    Plat_FileCreate(const char* path);
+bool     Plat_FileWrite(void* f, const void* data, size_t len);
+void     Plat_FileFlush(void* f);
+void     Plat_FileClose(void* f);
+
+// Read-only mapping of a whole file. Null for a missing or empty file.
+const void* Plat_MapFile(const char* path, size_t& size, void*& handle);
+void        Plat_UnmapFile(void* handle);
+
+// Detached background thread.
+bool     Plat_StartThread(void (*fn)(void* arg), void* arg);
+// Auto-reset event. Wait returns false on timeout.
+void*    Plat_EventCreate();
+void     Plat_EventSet(void* ev);
+bool     Plat_EventWait(void* ev, uint32_t ms);
+void     Plat_Yield();
+void     Plat_SleepMs(uint32_t ms);
+uint32_t Plat_TickMs();
+
+// False if unset or longer than size - 1.
+bool     Plat_GetEnv(const char* name, char* buf, size_t size);
+
+// Copy that reports a bad address instead of faulting.
+bool     Plat_SafeRead(void* dst, uintptr_t src, size_t len);
+bool     Plat_SafeWrite(uintptr_t dst, const void* src, size_t len);
@@ -0,0 +1,134 @@
+// platform_posix.cpp - platform.h on Linux
+#include "platform.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+void* Plat_FileCreate(const char* path)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    return fd < 0 ? nullptr : (void*)(intptr_t)(fd + 1);   // +1 keeps fd 0 non-null
+}
+
+static int Fd(void* f) { return (int)(intptr_t)f - 1; }
+
+bool Plat_FileWrite(void* f, const void* data, size_t len)
+{
+    const char* p = (const char*)data;
+    while (len)
+    {
+        ssize_t n = write(Fd(f), p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n; len -= (size_t)n;
+    }
+    return true;
+}
+
+void Plat_FileFlush(void* f) { fdatasync(Fd(f)); }
+void Plat_FileClose(void* f) { close(Fd(f)); }
+
+struct Mapping
+{
+    void*  data;
+    size_t size;
+};
+
+const void* Plat_MapFile(const char* path, size_t& size, void*& handle)
+{
+    size = 0;
+    handle = nullptr;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    void* data = fstat(fd, &st) == 0 && st.st_size > 0
+               ? mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    handle = new Mapping{ data, (size_t)st.st_size };
+    size = (size_t)st.st_size;
+    return data;
+}
+
+void Plat_UnmapFile(void* handle)
+{
+    Mapping* m = (Mapping*)handle;
+    if (!m) return;
+    munmap(m->data, m->size);
+    delete m;
+}
+
+bool Plat_StartThread(void (*fn)(void* arg), void* arg)
+{
+    try { std::thread(fn, arg).detach(); }
+    catch (...) { return false; }
+    return true;
+}
+
+struct Event
+{
+    std::mutex              mu;
+    std::condition_variable cv;
+    bool                    set = false;
+};
+
+void* Plat_EventCreate() { return new Event; }
+
+void Plat_EventSet(void* ev)
+{
+    Event* e = (Event*)ev;
+    { std::lock_guard<std::mutex> lock(e->mu); e->set = true; }
+    e->cv.notify_one();
+}
+
+bool Plat_EventWait(void* ev, uint32_t ms)
+{
+    Event* e = (Event*)ev;
+    std::unique_lock<std::mutex> lock(e->mu);
+    if (!e->cv.wait_for(lock, std::chrono::milliseconds(ms), [e] { return e->set; })) return false;
+    e->set = false;
+    return true;
+}
+
+void Plat_Yield()               { sched_yield(); }
+void Plat_SleepMs(uint32_t ms)  { usleep((useconds_t)ms * 1000); }
+
+uint32_t Plat_TickMs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+bool Plat_GetEnv(const char* name, char* buf, size_t size)
+{
+    const char* v = getenv(name);
+    if (!v || strlen(v) >= size) return false;
+    memcpy(buf, v, strlen(v) + 1);
+    return true;
+}
+
+// process_vm_* on ourselves fails with EFAULT where memcpy would fault.
+bool Plat_SafeRead(void* dst, uintptr_t src, size_t len)
+{
+    iovec local  = { dst, len };
+    iovec remote = { (void*)src, len };
+    return process_vm_readv(getpid(), &local, 1, &remote, 1, 0) == (ssize_t)len;
+}
+
+bool Plat_SafeWrite(uintptr_t dst, const void* src, size_t len)
+{
+    iovec local  = { (void*)src, len };
+    iovec remote = { (void*)dst, len };
+    return process_vm_writev(getpid(), &local, 1, &remote, 1, 0) == (ssize_t)len;
+}
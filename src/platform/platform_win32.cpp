@@ -0,0 +1,108 @@
+// platform_win32.cpp - platform.h on Win32
+#include "platform.h"
+#include <windows.h>
+#include <cstring>
+
+void* Plat_FileCreate(const char* path)
+{
+    HANDLE h = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return h == INVALID_HANDLE_VALUE ? nullptr : h;
+}
+
+bool Plat_FileWrite(void* f, const void* data, size_t len)
+{
+    DWORD w = 0;
+    return WriteFile((HANDLE)f, data, (DWORD)len, &w, nullptr) && w == len;
+}
+
+void Plat_FileFlush(void* f) { FlushFileBuffers((HANDLE)f); }
+void Plat_FileClose(void* f) { CloseHandle((HANDLE)f); }
+
+struct Mapping
+{
+    HANDLE file;
+    HANDLE map;
+    void*  data;
+};
+
+const void* Plat_MapFile(const char* path, size_t& size, void*& handle)
+{
+    size = 0;
+    handle = nullptr;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+    DWORD len = GetFileSize(file, nullptr);
+    HANDLE map = len != INVALID_FILE_SIZE && len
+               ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    void* data = map ? MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        if (map) CloseHandle(map);
+        CloseHandle(file);
+        return nullptr;
+    }
+    handle = new Mapping{ file, map, data };
+    size = len;
+    return data;
+}
+
+void Plat_UnmapFile(void* handle)
+{
+    Mapping* m = (Mapping*)handle;
+    if (!m) return;
+    UnmapViewOfFile(m->data);
+    CloseHandle(m->map);
+    CloseHandle(m->file);
+    delete m;
+}
+
+struct ThreadStart
+{
+    void (*fn)(void*);
+    void* arg;
+};
+
+static DWORD WINAPI ThreadMain(LPVOID p)
+{
+    ThreadStart s = *(ThreadStart*)p;
+    delete (ThreadStart*)p;
+    s.fn(s.arg);
+    return 0;
+}
+
+bool Plat_StartThread(void (*fn)(void* arg), void* arg)
+{
+    ThreadStart* s = new ThreadStart{ fn, arg };
+    HANDLE h = CreateThread(nullptr, 0, ThreadMain, s, 0, nullptr);
+    if (!h) { delete s; return false; }
+    CloseHandle(h);
+    return true;
+}
+
+void* Plat_EventCreate()                { return CreateEventA(nullptr, FALSE, FALSE, nullptr); }
+void  Plat_EventSet(void* ev)           { SetEvent((HANDLE)ev); }
+bool  Plat_EventWait(void* ev, uint32_t ms) { return WaitForSingleObject((HANDLE)ev, ms) == WAIT_OBJECT_0; }
+void  Plat_Yield()                      { Sleep(0); }
+void  Plat_SleepMs(uint32_t ms)         { Sleep(ms); }
+uint32_t Plat_TickMs()                  { return GetTickCount(); }
+
+bool Plat_GetEnv(const char* name, char* buf, size_t size)
+{
+    DWORD n = GetEnvironmentVariableA(name, buf, (DWORD)size);
+    return n && n < size;
+}
+
+bool Plat_SafeRead(void* dst, uintptr_t src, size_t len)
+{
+    __try { memcpy(dst, (const void*)src, len); return true; }
+    __except(EXCEPTION_EXECUTE_HANDLER) { return false; }
+}
+
+bool Plat_SafeWrite(uintptr_t dst, const void* src, size_t len)
+{
+    __try { memcpy((void*)dst, src, len); return true; }
+    __except(EXCEPTION_EXECUTE_HANDLER) { return false; }
+}
@@ -0,0 +1,65 @@
+// stub_arena_posix.cpp - StubPages backend: mmap with placement hints
+#include "../stub_arena.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+static const size_t STUB_REGION_SIZE = 64 * 1024;   // match the Windows granule
+static const int    MAX_PROBES       = 4096;        // per direction
+
+struct ProcessPages : StubPages
+{
+    size_t Granularity() override
+    {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        return page > STUB_REGION_SIZE ? page : STUB_REGION_SIZE;
+    }
+
+    // Returns the mapping if the kernel put it inside [lo, hi].
+    static uintptr_t TryAt(uintptr_t at, size_t size, uintptr_t lo, uintptr_t hi)
+    {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_FIXED_NOREPLACE
+        if (at) flags |= MAP_FIXED_NOREPLACE;
+#endif
+        void* p = mmap((void*)at, size, PROT_READ | PROT_WRITE | PROT_EXEC, flags, -1, 0);
+        if (p == MAP_FAILED) return 0;
+        uintptr_t got = (uintptr_t)p;
+        if (got >= lo && got <= hi) return got;
+        munmap(p, size);
+        return 0;
+    }
+
+    uintptr_t ReserveNear(uintptr_t lo, uintptr_t hi, uintptr_t pref, size_t size) override
+    {
+        size_t gran = Granularity();
+        if (uintptr_t p = TryAt(0, size, lo, hi)) return p;   // the kernel's pick may already do
+
+        // No cheap free-list query here; probe granule by granule outward.
+        uintptr_t start = pref & ~(uintptr_t)(gran - 1);
+        for (int i = 0; i < MAX_PROBES; i++)
+        {
+            uintptr_t d = (uintptr_t)i * gran;
+            if (hi >= d && start <= hi - d && start + d >= lo)
+                if (uintptr_t p = TryAt(start + d, size, lo, hi)) return p;
+            if (i && start >= d && start - d >= lo && start - d <= hi)
+                if (uintptr_t p = TryAt(start - d, size, lo, hi)) return p;
+        }
+        return 0;
+    }
+
+    void Release(uintptr_t base, size_t size) override
+    {
+        munmap((void*)base, size);
+    }
+
+    void FlushCode(uintptr_t addr, size_t len) override
+    {
+        __builtin___clear_cache((char*)addr, (char*)(addr + len));
+    }
+};
+
+StubPages& Stub_ProcessPages()
+{
+    static ProcessPages pages;
+    return pages;
+}
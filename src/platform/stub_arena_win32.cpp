@@ -0,0 +1,78 @@
+// stub_arena_win32.cpp - StubPages backend: VirtualQuery/VirtualAlloc
+#include "../stub_arena.h"
+#include <windows.h>
+
+static uintptr_t AlignUp(uintptr_t v, size_t a)   { return (v + a - 1) & ~(uintptr_t)(a - 1); }
+static uintptr_t AlignDown(uintptr_t v, size_t a) { return v & ~(uintptr_t)(a - 1); }
+
+struct ProcessPages : StubPages
+{
+    SYSTEM_INFO m_si = {};
+
+    const SYSTEM_INFO& Info()
+    {
+        if (!m_si.dwAllocationGranularity) GetSystemInfo(&m_si);
+        return m_si;
+    }
+
+    size_t Granularity() override { return Info().dwAllocationGranularity; }
+
+    static uintptr_t TryAt(uintptr_t at, size_t size)
+    {
+        return (uintptr_t)VirtualAlloc((void*)at, size, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+    }
+
+    uintptr_t ReserveNear(uintptr_t lo, uintptr_t hi, uintptr_t pref, size_t size) override
+    {
+        size_t    gran  = Granularity();
+        uintptr_t minVa = (uintptr_t)Info().lpMinimumApplicationAddress;
+        uintptr_t maxVa = (uintptr_t)Info().lpMaximumApplicationAddress;
+        if (lo < minVa) lo = AlignUp(minVa, gran);
+        if (hi > maxVa - size) hi = AlignDown(maxVa - size, gran);
+        if (lo > hi) return 0;
+        if (pref < lo) pref = lo;
+        if (pref > hi) pref = hi;
+
+        // Walk the free blocks upward from pref, then downward.
+        MEMORY_BASIC_INFORMATION mbi;
+        for (uintptr_t a = pref; a <= hi && VirtualQuery((void*)a, &mbi, sizeof(mbi)); )
+        {
+            uintptr_t blk = (uintptr_t)mbi.BaseAddress, end = blk + mbi.RegionSize;
+            uintptr_t at  = AlignUp(a, gran);
+            if (mbi.State == MEM_FREE && at <= hi && at + size <= end)
+                if (uintptr_t p = TryAt(at, size)) return p;
+            if (end <= a) break;
+            a = end;
+        }
+        for (uintptr_t a = pref; a >= lo && VirtualQuery((void*)a, &mbi, sizeof(mbi)); )
+        {
+            uintptr_t blk = (uintptr_t)mbi.BaseAddress, end = blk + mbi.RegionSize;
+            if (mbi.State == MEM_FREE && end >= size)
+            {
+                uintptr_t at = AlignDown(end - size, gran);
+                if (at > hi) at = hi;
+                if (at >= blk && at >= lo)
+                    if (uintptr_t p = TryAt(at, size)) return p;
+            }
+            if (blk == 0 || blk <= lo) break;
+            a = blk - 1;
+        }
+        return 0;
+    }
+
+    void Release(uintptr_t base, size_t) override
+    {
+        VirtualFree((void*)base, 0, MEM_RELEASE);
+    }
+
+    void FlushCode(uintptr_t addr, size_t len) override
+    {
+        FlushInstructionCache(GetCurrentProcess(), (const void*)addr, len);
+    }
+};
+
+StubPages& Stub_ProcessPages()
+{
+    static ProcessPages pages;
+    return pages;
+}
@@ -0,0 +1,241 @@
+// sigscan.cpp - one-pass multi-pattern scanner with SSE2 anchor filtering
+#include "sigscan.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#  define SIG_X86 1
+#  include <emmintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define SIG_TARGET_SSE2
+#  else
+#    define SIG_TARGET_SSE2 __attribute__((target("sse2")))
+#  endif
+#endif
+
+static const uint32_t SCN_MEM_EXECUTE = 0x20000000;
+static const int      SIG_SIMD_ANCHORS = 8;  // above this, fall back to a byte table
+static const size_t   SIG_FREQ_STRIDE  = 7;
+static const size_t   SIG_FREQ_MIN_LEN = 64 * 1024;   // below this, count every byte
+
+struct CompiledSig
+{
+    uint8_t bytes[SIG_MAX_LEN];
+    uint8_t mask[SIG_MAX_LEN];
+    int     len;
+    int     anchor;  // index of the byte used to find candidates
+    int     next;    // next sig sharing the same anchor byte, -1 = end
+};
+
+// Byte histogram of the code being scanned, one byte in SIG_FREQ_STRIDE
+// (odd, so 16-byte function alignment doesn't bias it). A full count
+// costs as much as the scan; the sample ranks bytes just as well.
+static void SampleFreq(const uint8_t* code, size_t len, uint32_t* freq)
+{
+    memset(freq, 0, 256 * sizeof(uint32_t));
+    size_t step = len < SIG_FREQ_MIN_LEN ? 1 : SIG_FREQ_STRIDE;
+    for (size_t i = 0; i < len; i += step) freq[code[i]]++;
+}
+
+int Sig_PickAnchor(const uint8_t* bytes, const uint8_t* mask, int len, const uint32_t* freq)
+{
+    int best = -1;
+    for (int j = 0; j < len; j++)
+        if (mask[j] && (best < 0 || freq[bytes[j]] < freq[bytes[best]])) best = j;
+    return best;
+}
+
+static int HexNibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool Sig_Parse(const char* text, uint8_t* bytes, uint8_t* mask, int& outLen)
+{
+    int n = 0;
+    bool anyFixed = false;
+    for (const char* p = text; p && *p; )
+    {
+        if (*p == ' ' || *p == '\t') { p++; continue; }
+        if (n >= SIG_MAX_LEN) return false;
+        if (*p == '?')
+        {
+            bytes[n] = 0; mask[n] = 0; n++;
+            p += (p[1] == '?') ? 2 : 1;
+            continue;
+        }
+        int hi = HexNibble(p[0]), lo = hi < 0 ? -1 : HexNibble(p[1]);
+        if (lo < 0) return false;
+        bytes[n] = (uint8_t)(hi << 4 | lo); mask[n] = 0xFF; n++;
+        anyFixed = true;
+        p += 2;
+    }
+    outLen = n;
+    return anyFixed;
+}
+
+static inline int LowestBit(unsigned m)
+{
+#if defined(_MSC_VER)
+    unsigned long i; _BitScanForward(&i, m); return (int)i;
+#else
+    return __builtin_ctz(m);
+#endif
+}
+
+static inline bool MatchAt(const uint8_t* p, const CompiledSig& s)
+{
+    for (int j = 0; j < s.len; j++)
+        if ((p[j] & s.mask[j]) != s.bytes[j]) return false;
+    return true;
+}
+
+struct ScanCtx
+{
+    const uint8_t*     code;
+    size_t             len;
+    uint32_t           rva0;
+    uint32_t           loadBase;
+    const SigDef*      defs;
+    const CompiledSig* sigs;
+    const int*         head;   // [256] first sig per anchor byte
+    SigResult*         out;
+};
+
+static uint32_t ResolveOperand(const ScanCtx& c, const SigDef& d, size_t start)
+{
+    uint32_t matchRva = c.rva0 + (uint32_t)start;
+    if (d.operand == SIG_MATCH) return matchRva + d.opOffset;
+
+    size_t at = start + d.opOffset;
+    if (d.opOffset < 0 || at + 4 > c.len) return 0;
+    uint32_t v; memcpy(&v, c.code + at, 4);
+    if (d.operand == SIG_ABS32) return v - c.loadBase;
+    return matchRva + d.opOffset + 4 + (uint32_t)(int32_t)v;   // SIG_REL32
+}
+
+static inline void Candidate(const ScanCtx& c, size_t pos)
+{
+    for (int i = c.head[c.code[pos]]; i >= 0; i = c.sigs[i].next)
+    {
+        const CompiledSig& s = c.sigs[i];
+        if (pos < (size_t)s.anchor) continue;
+        size_t start = pos - s.anchor;
+        if (start + s.len > c.len || !MatchAt(c.code + start, s)) continue;
+        SigResult& r = c.out[i];
+        if (r.matches++ == 0) r.rva = ResolveOperand(c, c.defs[i], start);
+    }
+}
+
+#ifdef SIG_X86
+SIG_TARGET_SSE2
+static size_t FilterSse2(const ScanCtx& c, const uint8_t* anchors, int nAnch)
+{
+    __m128i va[SIG_SIMD_ANCHORS];
+    for (int k = 0; k < nAnch; k++) va[k] = _mm_set1_epi8((char)anchors[k]);
+
+    size_t i = 0;
+    for (; i + 16 <= c.len; i += 16)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.code + i));
+        __m128i eq = _mm_cmpeq_epi8(v, va[0]);
+        for (int k = 1; k < nAnch; k++) eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, va[k]));
+        unsigned m = (unsigned)_mm_movemask_epi8(eq);
+        while (m) { Candidate(c, i + LowestBit(m)); m &= m - 1; }
+    }
+    return i;
+}
+#endif
+
+bool Sig_ScanAll(const uint8_t* code, size_t len, uint32_t rva0, uint32_t loadBase,
+                 const SigDef* defs, int n, SigResult* out)
+{
+    if (!code || n <= 0 || n > SIG_MAX_PATTERNS) return false;
+
+    static CompiledSig sigs[SIG_MAX_PATTERNS];
+    int      head[256];
+    uint8_t  anchors[256];
+    uint32_t freq[256];
+    int      nAnch = 0;
+    memset(head, -1, sizeof(head));
+    SampleFreq(code, len, freq);
+
+    // Push in reverse so each bucket lists sigs in definition order.
+    for (int i = n - 1; i >= 0; i--)
+    {
+        CompiledSig& s = sigs[i];
+        s.len = 0; s.next = -1; s.anchor = -1;
+        if (!defs[i].pattern || !Sig_Parse(defs[i].pattern, s.bytes, s.mask, s.len)) continue;
+
+        s.anchor = Sig_PickAnchor(s.bytes, s.mask, s.len, freq);
+
+        uint8_t b = s.bytes[s.anchor];
+        if (head[b] < 0) anchors[nAnch++] = b;
+        s.next = head[b];
+        head[b] = i;
+    }
+    if (!nAnch) return true;
+
+    ScanCtx c = { code, len, rva0, loadBase, defs, sigs, head, out };
+    size_t i = 0;
+#ifdef SIG_X86
+    if (nAnch <= SIG_SIMD_ANCHORS) i = FilterSse2(c, anchors, nAnch);
+#endif
+    for (; i < len; i++)
+        if (head[code[i]] >= 0) Candidate(c, i);
+    return true;
+}
+
+bool Sig_ScanImage(const PeImage& img, const SigDef* defs, int n, SigResult* out)
+{
+    uint32_t loadBase = img.mapped ? (uint32_t)(uintptr_t)img.data : img.imageBase;
+    bool any = false;
+    for (int i = 0; i < img.numSections; i++)
+    {
+        const PeSection& s = img.sections[i];
+        if (!(s.flags & SCN_MEM_EXECUTE)) continue;
+        size_t len = 0;
+        const uint8_t* p = Pe_SectionData(img, s, len);
+        if (p && Sig_ScanAll(p, len, s.rva, loadBase, defs, n, out)) any = true;
+    }
+    return any;
+}
+
+int Sig_LoadFile(const char* path, SigDef* defs, int maxDefs, char* pool, size_t poolSize)
+{
+    size_t used = 0;
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+
+    int n = 0;
+    char line[512];
+    while (n < maxDefs && fgets(line, sizeof(line), f))
+    {
+        char name[64], kind[16];
+        int  opOffset = 0, consumed = 0;
+        if (line[0] == '#' || sscanf(line, "%63s %15s %d %n", name, kind, &opOffset, &consumed) != 3)
+            continue;
+
+        SigOperand op;
+        if      (!strcmp(kind, "match")) op = SIG_MATCH;
+        else if (!strcmp(kind, "abs32")) op = SIG_ABS32;
+        else if (!strcmp(kind, "rel32")) op = SIG_REL32;
+        else continue;
+
+        char* pat = line + consumed;
+        pat[strcspn(pat, "\r\n")] = 0;
+        size_t nl = strlen(name) + 1, pl = strlen(pat) + 1;
+        if (used + nl + pl > poolSize) break;
+
+        char* ns = pool + used; memcpy(ns, name, nl); used += nl;
+        char* ps = pool + used; memcpy(ps, pat, pl);  used += pl;
+        defs[n++] = { ns, ps, op, opOffset };
+    }
+    fclose(f);
+    return n;
+}
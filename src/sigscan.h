@@ -0,0 +1,56 @@
+#pragma once
+// sigscan.h - multi-pattern AOB signature scanner.
+// All patterns are matched in one pass over the code sections; each
+// pattern is anchored on its fixed byte that is rarest in the code being
+// scanned (by a sampled histogram), and candidate positions are found 16
+// bytes at a time with SSE2 compares.
+
+#include "pe_scan.h"
+#include <cstddef>
+#include <cstdint>
+
+static const int SIG_MAX_LEN      = 64;
+static const int SIG_MAX_PATTERNS = 128;
+
+enum SigOperand
+{
+    SIG_MATCH,  // rva of the match (+ opOffset)
+    SIG_ABS32,  // absolute VA stored at match+opOffset, converted to an rva
+    SIG_REL32,  // rel32 displacement at match+opOffset (call/jmp/jcc target)
+};
+
+struct SigDef
+{
+    const char* name;
+    const char* pattern;   // IDA style: "8B 0D ?? ?? ?? ?? 85 C9" (? or ?? = any)
+    SigOperand  operand;
+    int         opOffset;
+};
+
+struct SigResult
+{
+    uint32_t rva;      // resolved rva from the first match
+    int      matches;  // 0 = not found, >1 = ambiguous pattern
+};
+
+// Parse an IDA-style pattern. mask[i] is 0 for wildcard bytes.
+bool Sig_Parse(const char* text, uint8_t* bytes, uint8_t* mask, int& outLen);
+
+// Scan [code, code+len) for every def in one pass. rva0 is the rva of
+// code[0]; loadBase is subtracted from SIG_ABS32 operands. Results are
+// accumulated into out[0..n), which the caller zeroes before the first call.
+bool Sig_ScanAll(const uint8_t* code, size_t len, uint32_t rva0, uint32_t loadBase,
+                 const SigDef* defs, int n, SigResult* out);
+
+// Scan every executable section of img.
+bool Sig_ScanImage(const PeImage& img, const SigDef* defs, int n, SigResult* out);
+
+// Index of the fixed byte with the lowest freq[] count (the first on a
+// tie), -1 if every byte is a wildcard.
+int Sig_PickAnchor(const uint8_t* bytes, const uint8_t* mask, int len, const uint32_t* freq);
+
+// Load extra signatures from a text file, one per line:
+//   <name> <match|abs32|rel32> <opOffset> <pattern...>
+// Names and patterns are copied into pool, which must outlive defs; each
+// call starts at the beginning of pool. Returns the number of defs written.
+int Sig_LoadFile(const char* path, SigDef* defs, int maxDefs, char* pool, size_t poolSize);
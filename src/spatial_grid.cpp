@@ -0,0 +1,131 @@
+// spatial_grid.cpp - hashed column grid with incremental relinking
+#include "spatial_grid.h"
+#include <cmath>
+
+// Clamped so a stray origin can't overflow the cast; far beyond any map.
+static inline int32_t Cell(float v)
+{
+    v = fminf(fmaxf(v, -1.0e7f), 1.0e7f);
+    return (int32_t)floorf(v * (1.0f / SGRID_CELL));
+}
+
+static inline uint32_t Bucket(int32_t cx, int32_t cy)
+{
+    uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cy * 0x85EBCA77u;
+    return h >> (32 - SGRID_BITS);
+}
+
+SpatialGrid::SpatialGrid(int maxEnts)
+    : m_ents(maxEnts > 0 ? maxEnts : 0), m_head(SGRID_BUCKETS, -1)
+{
+    for (Ent& e : m_ents) e.stamp = 0;
+}
+
+void SpatialGrid::Link(int id)
+{
+    Ent& e = m_ents[id];
+    int32_t& head = m_head[Bucket(e.cx, e.cy)];
+    e.prev = -1;
+    e.next = head;
+    if (head >= 0) m_ents[head].prev = id;
+    head = id;
+}
+
+void SpatialGrid::Unlink(int id)
+{
+    Ent& e = m_ents[id];
+    if (e.prev >= 0) m_ents[e.prev].next = e.next;
+    else             m_head[Bucket(e.cx, e.cy)] = e.next;
+    if (e.next >= 0) m_ents[e.next].prev = e.prev;
+}
+
+void SpatialGrid::BeginFrame()
+{
+    // Stamp 0 means absent, so skip it on wraparound.
+    if (++m_frame == 0) m_frame = 1;
+}
+
+void SpatialGrid::Update(int id, float x, float y, float z)
+{
+    if (id < 0 || id >= (int)m_ents.size()) return;
+    Ent& e = m_ents[id];
+    int32_t cx = Cell(x), cy = Cell(y);
+    bool present = e.stamp != 0;
+    if (present && (cx != e.cx || cy != e.cy)) Unlink(id);
+    e.x = x; e.y = y; e.z = z;
+    if (!present || cx != e.cx || cy != e.cy)
+    {
+        e.cx = cx;
+        e.cy = cy;
+        Link(id);
+    }
+    if (!present) m_count++;
+    e.stamp = m_frame;
+}
+
+void SpatialGrid::Remove(int id)
+{
+    if (id < 0 || id >= (int)m_ents.size() || !m_ents[id].stamp) return;
+    Unlink(id);
+    m_ents[id].stamp = 0;
+    m_count--;
+}
+
+void SpatialGrid::EndFrame()
+{
+    if (!m_count) return;
+    for (int i = 0; i < (int)m_ents.size(); i++)
+        if (m_ents[i].stamp && m_ents[i].stamp != m_frame) Remove(i);
+}
+
+void SpatialGrid::Clear()
+{
+    for (Ent& e : m_ents) e.stamp = 0;
+    for (int32_t& h : m_head) h = -1;
+    m_count = 0;
+}
+
+// Columns overlapping [x0, x1] x [y0, y1]. Several columns can share a
+// bucket, so an entity only counts in its own column; a shape spanning more
+// columns than there are buckets is cheaper as a plain scan.
+template<typename Test>
+int SpatialGrid::Query(float x0, float y0, float x1, float y1, Test test, int* out, int max) const
+{
+    int32_t cx0 = Cell(x0), cy0 = Cell(y0), cx1 = Cell(x1), cy1 = Cell(y1);
+    int n = 0;
+    auto hit = [&](int id) { if (n < max) out[n] = id; n++; };
+
+    if (((int64_t)cx1 - cx0 + 1) * ((int64_t)cy1 - cy0 + 1) > SGRID_BUCKETS)
+    {
+        for (int i = 0; i < (int)m_ents.size(); i++)
+            if (m_ents[i].stamp && test(m_ents[i])) hit(i);
+        return n;
+    }
+    for (int32_t cy = cy0; cy <= cy1; cy++)
+        for (int32_t cx = cx0; cx <= cx1; cx++)
+            for (int32_t i = m_head[Bucket(cx, cy)]; i >= 0; i = m_ents[i].next)
+            {
+                const Ent& e = m_ents[i];
+                if (e.cx == cx && e.cy == cy && test(e)) hit(i);
+            }
+    return n;
+}
+
+int SpatialGrid::QueryRadius(float x, float y, float z, float r, int* out, int max) const
+{
+    float r2 = r * r;
+    return Query(x - r, y - r, x + r, y + r, [&](const Ent& e)
+    {
+        float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+        return dx * dx + dy * dy + dz * dz <= r2;
+    }, out, max);
+}
+
+int SpatialGrid::QueryBox(const float mins[3], const float maxs[3], int* out, int max) const
+{
+    return Query(mins[0], mins[1], maxs[0], maxs[1], [&](const Ent& e)
+    {
+        return e.x >= mins[0] && e.x <= maxs[0] && e.y >= mins[1] && e.y <= maxs[1]
+            && e.z >= mins[2] && e.z <= maxs[2];
+    }, out, max);
+}
@@ -0,0 +1,61 @@
+#pragma once
+// spatial_grid.h - uniform grid over entity origins for radius/box queries.
+// RadiusDamage and UTIL_FindEntityInSphere walk every edict; with 32
+// players and hundreds of zombies each explosion pays for all of them.
+// Here entities sit in square columns of SGRID_CELL units (x/y; z is
+// filtered per entity, maps are wide rather than tall), hashed into
+// SGRID_BUCKETS lists. Each frame the caller walks the edict list:
+//
+//   grid.BeginFrame();
+//   for each live edict: grid.Update(index, origin);   // relinks only on a cell change
+//   grid.EndFrame();                                    // drops whoever wasn't updated
+//
+// Queries visit only the columns the shape overlaps and write entity
+// indices to a caller buffer. Not thread-safe; game thread. Portable.
+
+#include <cstdint>
+#include <vector>
+
+static const float SGRID_CELL    = 256.0f;
+static const int   SGRID_BITS    = 10;
+static const int   SGRID_BUCKETS = 1 << SGRID_BITS;
+
+class SpatialGrid
+{
+public:
+    // Entity indices are [0, maxEnts), e.g. edict numbers.
+    explicit SpatialGrid(int maxEnts);
+
+    void BeginFrame();
+    void Update(int id, float x, float y, float z);
+    void Remove(int id);
+    void EndFrame();
+    void Clear();
+
+    // Entities within r of (x, y, z) / inside [mins, maxs], in no
+    // particular order. At most max are written; the return value is the
+    // full count, so a larger buffer can be retried.
+    int  QueryRadius(float x, float y, float z, float r, int* out, int max) const;
+    int  QueryBox(const float mins[3], const float maxs[3], int* out, int max) const;
+
+    int  Count() const { return m_count; }
+
+private:
+    struct Ent
+    {
+        float    x, y, z;
+        int32_t  cx, cy;
+        int32_t  prev, next;   // bucket list, -1 = end
+        uint32_t stamp;        // frame last updated, 0 = not in the grid
+    };
+
+    template<typename Test>
+    int Query(float x0, float y0, float x1, float y1, Test test, int* out, int max) const;
+    void Link(int id);
+    void Unlink(int id);
+
+    std::vector<Ent>     m_ents;
+    std::vector<int32_t> m_head;
+    uint32_t             m_frame = 1;
+    int                  m_count = 0;
+};
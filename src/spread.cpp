@@ -0,0 +1,236 @@
+// spread.cpp - Philox4x32-10 spread offsets, AVX2/SSE2 and scalar
+#include "spread.h"
+#include "cpu_features.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPREAD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef CPU_X86
+#define SPREAD_AVX2 1
+#endif
+
+static const uint32_t PHILOX_M0 = 0xD2511F53, PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9, PHILOX_W1 = 0xBB67AE85;
+static const int      PHILOX_ROUNDS = 10;
+
+static const float U24 = 1.0f / 16777216.0f;
+
+// Top 24 bits to [-0.5, 0.5). Exact in float, so both paths agree.
+static inline float Unit(uint32_t h) { return (float)(int32_t)(h >> 8) * U24 - 0.5f; }
+
+void Spread_Philox(uint32_t c[4], uint32_t k0, uint32_t k1)
+{
+    for (int r = 0; r < PHILOX_ROUNDS; r++)
+    {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+        c[1] = (uint32_t)p1;
+        c[3] = (uint32_t)p0;
+        c[0] = n0;
+        c[2] = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+static inline void OffsetScalar(uint32_t seed, uint32_t stream, uint32_t i, float& x, float& y)
+{
+    uint32_t c[4] = { i, stream, 0, 0 };
+    Spread_Philox(c, seed, SPREAD_KEY_HI);
+    x = Unit(c[0]) + Unit(c[1]);
+    y = Unit(c[2]) + Unit(c[3]);
+}
+
+void Spread_OffsetsScalar(uint32_t seed, uint32_t stream, int n, float* x, float* y)
+{
+    for (int i = 0; i < n; i++) OffsetScalar(seed, stream, (uint32_t)i, x[i], y[i]);
+}
+
+#ifdef SPREAD_SSE2
+// Four 32x32->64 products; _mm_mul_epu32 covers the even lanes, the odd
+// ones go through a shift.
+static inline void MulHiLo(__m128i a, __m128i m, __m128i& hi, __m128i& lo)
+{
+    __m128i ev = _mm_mul_epu32(a, m);
+    __m128i od = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(ev, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(od, _MM_SHUFFLE(0, 0, 2, 0)));
+    hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(ev, _MM_SHUFFLE(0, 0, 3, 1)),
+                            _mm_shuffle_epi32(od, _MM_SHUFFLE(0, 0, 3, 1)));
+}
+
+static inline __m128 Unit4(__m128i h)
+{
+    __m128 f = _mm_cvtepi32_ps(_mm_srli_epi32(h, 8));
+    return _mm_sub_ps(_mm_mul_ps(f, _mm_set1_ps(U24)), _mm_set1_ps(0.5f));
+}
+
+// Pellets i..i+3, one per lane.
+static inline void Offset4(uint32_t seed, uint32_t stream, uint32_t i, __m128& x, __m128& y)
+{
+    __m128i c0 = _mm_add_epi32(_mm_set1_epi32((int)i), _mm_set_epi32(3, 2, 1, 0));
+    __m128i c1 = _mm_set1_epi32((int)stream);
+    __m128i c2 = _mm_setzero_si128();
+    __m128i c3 = _mm_setzero_si128();
+    const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0), m1 = _mm_set1_epi32((int)PHILOX_M1);
+    uint32_t k0 = seed, k1 = SPREAD_KEY_HI;
+    for (int r = 0; r < PHILOX_ROUNDS; r++)
+    {
+        __m128i hi0, lo0, hi1, lo1;
+        MulHiLo(c0, m0, hi0, lo0);
+        MulHiLo(c2, m1, hi1, lo1);
+        c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int)k0));
+        c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int)k1));
+        c1 = lo1;
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    x = _mm_add_ps(Unit4(c0), Unit4(c1));
+    y = _mm_add_ps(Unit4(c2), Unit4(c3));
+}
+#endif
+
+#ifdef SPREAD_AVX2
+// Eight lanes of the same round. _mm256_mul_epu32 again takes the even
+// lanes; the blends put each product's halves back in its own lane.
+CPU_TARGET_AVX2
+static inline void MulHiLo8(__m256i a, __m256i m, __m256i& hi, __m256i& lo)
+{
+    __m256i ev = _mm256_mul_epu32(a, m);
+    __m256i od = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    lo = _mm256_blend_epi32(ev, _mm256_slli_epi64(od, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(ev, 32), od, 0xAA);
+}
+
+CPU_TARGET_AVX2
+static inline __m256 Unit8(__m256i h)
+{
+    __m256 f = _mm256_cvtepi32_ps(_mm256_srli_epi32(h, 8));
+    return _mm256_sub_ps(_mm256_mul_ps(f, _mm256_set1_ps(U24)), _mm256_set1_ps(0.5f));
+}
+
+// Pellets i..i+7, one per lane.
+CPU_TARGET_AVX2
+static inline void Offset8(uint32_t seed, uint32_t stream, uint32_t i, __m256& x, __m256& y)
+{
+    __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int)i),
+                                  _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    __m256i c1 = _mm256_set1_epi32((int)stream);
+    __m256i c2 = _mm256_setzero_si256();
+    __m256i c3 = _mm256_setzero_si256();
+    const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0), m1 = _mm256_set1_epi32((int)PHILOX_M1);
+    uint32_t k0 = seed, k1 = SPREAD_KEY_HI;
+    for (int r = 0; r < PHILOX_ROUNDS; r++)
+    {
+        __m256i hi0, lo0, hi1, lo1;
+        MulHiLo8(c0, m0, hi0, lo0);
+        MulHiLo8(c2, m1, hi1, lo1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32((int)k0));
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32((int)k1));
+        c1 = lo1;
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    x = _mm256_add_ps(Unit8(c0), Unit8(c1));
+    y = _mm256_add_ps(Unit8(c2), Unit8(c3));
+}
+
+// Whole groups of eight; returns how many pellets it wrote.
+CPU_TARGET_AVX2
+static int OffsetsAvx2(uint32_t seed, uint32_t stream, int n, float* x, float* y)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 vx, vy;
+        Offset8(seed, stream, (uint32_t)i, vx, vy);
+        _mm256_storeu_ps(x + i, vx);
+        _mm256_storeu_ps(y + i, vy);
+    }
+    return i;
+}
+
+// Plain mul + add, not FMA, so it matches the narrower paths bit for bit.
+CPU_TARGET_AVX2
+static int DirectionsAvx2(const SpreadParams& p, int n, float* dx, float* dy, float* dz)
+{
+    const __m256 fx = _mm256_set1_ps(p.fx), fy = _mm256_set1_ps(p.fy), fz = _mm256_set1_ps(p.fz);
+    const __m256 rx = _mm256_set1_ps(p.rx), ry = _mm256_set1_ps(p.ry), rz = _mm256_set1_ps(p.rz);
+    const __m256 ux = _mm256_set1_ps(p.ux), uy = _mm256_set1_ps(p.uy), uz = _mm256_set1_ps(p.uz);
+    const __m256 cx = _mm256_set1_ps(p.coneX), cy = _mm256_set1_ps(p.coneY);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 x, y;
+        Offset8(p.seed, p.stream, (uint32_t)i, x, y);
+        __m256 a = _mm256_mul_ps(x, cx), b = _mm256_mul_ps(y, cy);
+        _mm256_storeu_ps(dx + i, _mm256_add_ps(_mm256_add_ps(fx, _mm256_mul_ps(a, rx)),
+                                               _mm256_mul_ps(b, ux)));
+        _mm256_storeu_ps(dy + i, _mm256_add_ps(_mm256_add_ps(fy, _mm256_mul_ps(a, ry)),
+                                               _mm256_mul_ps(b, uy)));
+        _mm256_storeu_ps(dz + i, _mm256_add_ps(_mm256_add_ps(fz, _mm256_mul_ps(a, rz)),
+                                               _mm256_mul_ps(b, uz)));
+    }
+    return i;
+}
+#endif
+
+void Spread_Offsets(uint32_t seed, uint32_t stream, int n, float* x, float* y)
+{
+    int i = 0;
+#ifdef SPREAD_AVX2
+    static const bool avx2 = Cpu_HasAvx2();
+    if (avx2) i = OffsetsAvx2(seed, stream, n, x, y);
+#endif
+#ifdef SPREAD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 vx, vy;
+        Offset4(seed, stream, (uint32_t)i, vx, vy);
+        _mm_storeu_ps(x + i, vx);
+        _mm_storeu_ps(y + i, vy);
+    }
+#endif
+    for (; i < n; i++) OffsetScalar(seed, stream, (uint32_t)i, x[i], y[i]);
+}
+
+void Spread_Directions(const SpreadParams& p, int n, float* dx, float* dy, float* dz)
+{
+    int i = 0;
+#ifdef SPREAD_AVX2
+    static const bool avx2 = Cpu_HasAvx2();
+    if (avx2) i = DirectionsAvx2(p, n, dx, dy, dz);
+#endif
+#ifdef SPREAD_SSE2
+    const __m128 fx = _mm_set1_ps(p.fx), fy = _mm_set1_ps(p.fy), fz = _mm_set1_ps(p.fz);
+    const __m128 rx = _mm_set1_ps(p.rx), ry = _mm_set1_ps(p.ry), rz = _mm_set1_ps(p.rz);
+    const __m128 ux = _mm_set1_ps(p.ux), uy = _mm_set1_ps(p.uy), uz = _mm_set1_ps(p.uz);
+    const __m128 cx = _mm_set1_ps(p.coneX), cy = _mm_set1_ps(p.coneY);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x, y;
+        Offset4(p.seed, p.stream, (uint32_t)i, x, y);
+        __m128 a = _mm_mul_ps(x, cx), b = _mm_mul_ps(y, cy);
+        _mm_storeu_ps(dx + i, _mm_add_ps(_mm_add_ps(fx, _mm_mul_ps(a, rx)), _mm_mul_ps(b, ux)));
+        _mm_storeu_ps(dy + i, _mm_add_ps(_mm_add_ps(fy, _mm_mul_ps(a, ry)), _mm_mul_ps(b, uy)));
+        _mm_storeu_ps(dz + i, _mm_add_ps(_mm_add_ps(fz, _mm_mul_ps(a, rz)), _mm_mul_ps(b, uz)));
+    }
+#endif
+    // Same operation order as above; relies on no FMA contraction, which
+    // neither MSVC's /fp:precise nor an x86 build without FMA does.
+    for (; i < n; i++)
+    {
+        float x, y;
+        OffsetScalar(p.seed, p.stream, (uint32_t)i, x, y);
+        float a = x * p.coneX, b = y * p.coneY;
+        dx[i] = (p.fx + a * p.rx) + b * p.ux;
+        dy[i] = (p.fy + a * p.ry) + b * p.uy;
+        dz[i] = (p.fz + a * p.rz) + b * p.uz;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+// spread.h - pellet spread from a counter-based RNG, eight or four pellets
+// per pass.
+// Pellet i of a shot draws its four uniforms from Philox4x32-10 with
+// counter (i, stream, 0, 0) and key (seed, SPREAD_KEY_HI): no generator
+// state, so any pellet can be produced on its own, in any order, and the
+// client's prediction gets the same numbers from the shared random seed
+// without replaying the engine RNG. Offsets use the SDK's shape, the sum of
+// two uniforms on [-0.5, 0.5) per axis.
+//
+// The AVX2, SSE2 and scalar paths give bit-identical results. AVX2 takes
+// eight pellets a pass when the CPU has it (checked once at run time);
+// SSE2 takes four whenever the build targets it (x64, or x86 with
+// /arch:SSE2, MSVC's default). Portable.
+
+#include <cstdint>
+
+static const uint32_t SPREAD_KEY_HI = 0x43534E5A;   // "CSNZ"
+
+struct SpreadParams
+{
+    float    fx, fy, fz;        // aim basis (MakeVectors)
+    float    rx, ry, rz;
+    float    ux, uy, uz;
+    float    coneX, coneY;      // VECTOR_CONE_* x / y, accuracy applied
+    uint32_t seed;              // shared random seed of the shot
+    uint32_t stream;            // separates draws within a shot (0 = spread)
+};
+
+// Offsets in cone units, each in (-1, 1), for pellets [0, n).
+void Spread_Offsets(uint32_t seed, uint32_t stream, int n, float* x, float* y);
+// Unnormalised directions forward + x*coneX*right + y*coneY*up, as the SDK
+// builds them, for pellets [0, n).
+void Spread_Directions(const SpreadParams& p, int n, float* dx, float* dy, float* dz);
+
+// Reference path, one pellet at a time. Same output as the above.
+void Spread_OffsetsScalar(uint32_t seed, uint32_t stream, int n, float* x, float* y);
+
+// The generator itself: Philox4x32-10 of counter c under key (k0, k1),
+// in place. Matches Random123's philox4x32_10.
+void Spread_Philox(uint32_t c[4], uint32_t k0, uint32_t k1);
@@ -0,0 +1,89 @@
+// stub_arena.cpp - line-granular allocator over near-module RWX regions
+#include "stub_arena.h"
+#include <cstring>
+
+static const uint64_t REL32_REACH = 0x7FFFFFFFull;
+
+StubArena::~StubArena()
+{
+    for (StubRegion& r : m_regions) m_pages.Release(r.base, r.size);
+}
+
+size_t StubArena::LiveBytes() const
+{
+    size_t n = 0;
+    for (const StubRegion& r : m_regions) n += r.live * STUB_LINE;
+    return n;
+}
+
+void* StubArena::AllocIn(StubRegion& r, size_t lines)
+{
+    size_t total = r.size / STUB_LINE, at = (size_t)-1;
+    if (r.bump + lines <= total)
+    {
+        at = r.bump;
+        r.bump += lines;
+    }
+    else
+    {
+        // First fit over released lines below the bump pointer.
+        size_t start = 0;
+        for (size_t i = 0; i < r.bump; )
+        {
+            if (r.runs[i]) { i += r.runs[i]; start = i; continue; }
+            if (++i - start == lines) { at = start; break; }
+        }
+        if (at == (size_t)-1) return nullptr;
+    }
+    r.runs[at] = (uint16_t)lines;
+    r.live += lines;
+    return (void*)(r.base + at * STUB_LINE);
+}
+
+void* StubArena::Alloc(size_t size, uintptr_t nearLo, uintptr_t nearHi)
+{
+    size_t gran  = m_pages.Granularity();
+    size_t lines = (size + STUB_LINE - 1) / STUB_LINE;
+    if (!lines || lines * STUB_LINE > gran) return nullptr;
+
+    // Region bases that keep the whole region within rel32 of [nearLo, nearHi).
+    // On a 32-bit address space rel32 wraps, so anything goes.
+    uint64_t lo = 0, hi = (uint64_t)UINTPTR_MAX - gran;
+    if (sizeof(uintptr_t) > 4 && (nearLo || nearHi))
+    {
+        lo = (uint64_t)nearHi > REL32_REACH ? (uint64_t)nearHi - REL32_REACH : 0;
+        uint64_t top = (uint64_t)nearLo + REL32_REACH - gran;
+        if (top < hi) hi = top;
+    }
+
+    for (StubRegion& r : m_regions)
+    {
+        if (r.base < lo || r.base > hi) continue;
+        if (void* p = AllocIn(r, lines)) return p;
+    }
+
+    uintptr_t pref = nearLo ? nearLo : (uintptr_t)lo;
+    uintptr_t base = m_pages.ReserveNear((uintptr_t)lo, (uintptr_t)hi, pref, gran);
+    if (!base) return nullptr;
+    m_regions.push_back({ base, gran, 0, 0, std::vector<uint16_t>(gran / STUB_LINE) });
+    return AllocIn(m_regions.back(), lines);
+}
+
+void StubArena::Free(void* p)
+{
+    uintptr_t a = (uintptr_t)p;
+    for (StubRegion& r : m_regions)
+    {
+        if (a < r.base || a >= r.base + r.size) continue;
+        size_t line = (a - r.base) / STUB_LINE;
+        size_t n    = r.runs[line];
+        if (!n || (a - r.base) % STUB_LINE) return;   // not an allocation start
+        // Anything still jumping here traps instead of running stale code.
+        memset(p, 0xCC, n * STUB_LINE);
+        m_pages.FlushCode(a, n * STUB_LINE);
+        r.runs[line] = 0;
+        r.live -= n;
+        if (line + n == r.bump) r.bump = line;
+        return;
+    }
+}
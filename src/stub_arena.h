@@ -0,0 +1,60 @@
+#pragma once
+// stub_arena.h - executable memory for trampolines and generated thunks.
+// Regions are reserved one allocation granule at a time (64 KB on Windows),
+// as close to the target module as the OS allows so rel32 jumps between the
+// module and its stubs always fit. Stubs are carved out in 64-byte lines:
+// bump first, then first-fit over lines released by Free().
+// Not thread-safe; stubs are created during install.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const size_t STUB_LINE = 64;
+
+// Backend: the running process (Stub_ProcessPages) or a test double.
+struct StubPages
+{
+    virtual ~StubPages() {}
+    // Size and alignment of one region.
+    virtual size_t    Granularity() = 0;
+    // Map size bytes of RWX memory at a base in [lo, hi], searching outward
+    // from pref. 0 on failure.
+    virtual uintptr_t ReserveNear(uintptr_t lo, uintptr_t hi, uintptr_t pref, size_t size) = 0;
+    virtual void      Release(uintptr_t base, size_t size) = 0;
+    virtual void      FlushCode(uintptr_t /*addr*/, size_t /*len*/) {}
+};
+
+StubPages& Stub_ProcessPages();
+
+struct StubRegion
+{
+    uintptr_t             base;
+    size_t                size;
+    size_t                bump;    // lines handed out at least once
+    size_t                live;    // lines currently allocated
+    std::vector<uint16_t> runs;    // per line: run length if an allocation starts here
+};
+
+class StubArena
+{
+public:
+    explicit StubArena(StubPages& pages) : m_pages(pages) {}
+    ~StubArena();
+
+    // size bytes, line-aligned, reachable by rel32 from every byte of
+    // [nearLo, nearHi). nearLo == nearHi == 0 means anywhere.
+    void* Alloc(size_t size, uintptr_t nearLo = 0, uintptr_t nearHi = 0);
+    void  Free(void* p);
+    // Call after writing code into a stub.
+    void  Flush(void* p, size_t len) { m_pages.FlushCode((uintptr_t)p, len); }
+
+    int    RegionCount() const { return (int)m_regions.size(); }
+    size_t LiveBytes() const;
+
+private:
+    void* AllocIn(StubRegion& r, size_t lines);
+
+    StubPages&              m_pages;
+    std::vector<StubRegion> m_regions;
+};
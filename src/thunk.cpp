@@ -0,0 +1,41 @@
+// thunk.cpp - pre-hook thunk encoding and allocation
+#include "thunk.h"
+#include "stub_arena.h"
+#include "x86_len.h"
+#include <cstring>
+
+static StubArena* g_arena  = nullptr;
+static uintptr_t  g_nearLo = 0;
+static uintptr_t  g_nearHi = 0;
+
+size_t Thunk_EncodePre(uint8_t* out, size_t cap, uintptr_t outAddr, uintptr_t pre, uintptr_t orig)
+{
+    if (cap < THUNK_PRE_SIZE || !pre || !orig) return 0;
+    out[0]  = 0x51;
+    out[1]  = 0xE8;
+    out[6]  = 0x59;
+    out[7]  = 0xE9;
+    if (!X86_PutRel32(out + 2, outAddr + 6, pre) || !X86_PutRel32(out + 8, outAddr + 12, orig)) return 0;
+    return THUNK_PRE_SIZE;
+}
+
+void Thunk_SetArena(StubArena* arena, uintptr_t nearLo, uintptr_t nearHi)
+{
+    g_arena  = arena;
+    g_nearLo = nearLo;
+    g_nearHi = nearHi;
+}
+
+void* Thunk_MakePre(void* pre, void* orig)
+{
+    if (!g_arena) return nullptr;
+    uint8_t* p = (uint8_t*)g_arena->Alloc(THUNK_PRE_SIZE, g_nearLo, g_nearHi);
+    if (!p) return nullptr;
+    if (!Thunk_EncodePre(p, THUNK_PRE_SIZE, (uintptr_t)p, (uintptr_t)pre, (uintptr_t)orig))
+    {
+        g_arena->Free(p);
+        return nullptr;
+    }
+    g_arena->Flush(p, THUNK_PRE_SIZE);
+    return p;
+}
@@ -0,0 +1,26 @@
+#pragma once
+// thunk.h - generated __thiscall pre-hook thunks (IA-32).
+// A pre-hook slot runs pre(this) and then enters the original directly:
+//
+//   51            push ecx        ; save this, and pass it to pre
+//   E8 rel32      call pre        ; void __cdecl pre(void* self)
+//   59            pop  ecx
+//   E9 rel32      jmp  orig       ; stack args and return address untouched
+//
+// Both targets are baked in, so the hot path has no global load, no
+// indirect call and no wrapper frame. pre may clobber eax/edx/flags, which
+// __thiscall does not use for arguments.
+
+#include <cstddef>
+#include <cstdint>
+
+static const size_t THUNK_PRE_SIZE = 12;
+
+// Pure encoder: writes into out, which will run at outAddr. 0 if it can't.
+size_t Thunk_EncodePre(uint8_t* out, size_t cap, uintptr_t outAddr, uintptr_t pre, uintptr_t orig);
+
+class StubArena;
+// Thunks are carved from the hook engine's arena, within rel32 reach of
+// [nearLo, nearHi). Set before building any.
+void  Thunk_SetArena(StubArena* arena, uintptr_t nearLo, uintptr_t nearHi);
+void* Thunk_MakePre(void* pre, void* orig);
@@ -0,0 +1,91 @@
+// trampoline.cpp - stolen-prologue relocation for call-through hooks
+#include "trampoline.h"
+#include "x86_len.h"
+#include <cstring>
+
+TrampResult Tramp_Build(const uint8_t* src, size_t avail, uintptr_t srcAddr, size_t minLen,
+                        uint8_t* out, size_t cap, uintptr_t outAddr,
+                        size_t& stolen, size_t& size)
+{
+    uintptr_t targets[TRAMP_MAX_STOLEN];
+    int       nTargets = 0;
+    size_t    in = 0, o = 0;
+    stolen = size = 0;
+
+    while (in < minLen)
+    {
+        X86Insn x;
+        if (!X86_Decode(src + in, avail - in, x)) return TRAMP_DECODE;
+        if (in + x.len > TRAMP_MAX_STOLEN) return TRAMP_UNSUPPORTED;
+        if (X86_IsTerminator(x, src + in) && in + x.len < minLen) return TRAMP_TOO_SHORT;
+
+        const uint8_t* p = src + in;
+        uintptr_t ip = srcAddr + in + x.len;
+        if (!x.relOff)
+        {
+            if (o + x.len > cap) return TRAMP_NO_ROOM;
+            memcpy(out + o, p, x.len);
+            o += x.len;
+        }
+        else
+        {
+            if (x.relSize == 2) return TRAMP_UNSUPPORTED;
+            int32_t rel = (int8_t)p[x.relOff];
+            if (x.relSize == 4) memcpy(&rel, p + x.relOff, 4);
+            uintptr_t target = ip + (intptr_t)rel;
+            targets[nTargets++] = target;
+
+            size_t n;
+            if (x.relSize == 4)
+            {
+                // E8/E9/0F 8x: copy as is, only the displacement moves.
+                n = x.len;
+                if (o + n > cap) return TRAMP_NO_ROOM;
+                memcpy(out + o, p, n);
+            }
+            else
+            {
+                // Short forms widen to rel32: Jcc -> 0F 8x, jmp -> E9. loop/jecxz
+                // have no long form.
+                if (x.opOff != 0 || x.twoByte || (x.opcode >= 0xE0 && x.opcode <= 0xE3))
+                    return TRAMP_UNSUPPORTED;
+                n = x.opcode == 0xEB ? 5 : 6;
+                if (o + n > cap) return TRAMP_NO_ROOM;
+                if (n == 5) out[o] = 0xE9;
+                else { out[o] = 0x0F; out[o + 1] = (uint8_t)(0x80 | (x.opcode & 0x0F)); }
+            }
+            if (!X86_PutRel32(out + o + n - 4, outAddr + o + n, target)) return TRAMP_RANGE;
+            o += n;
+        }
+        in += x.len;
+    }
+
+    // A branch back into the bytes we are about to overwrite (or to the entry,
+    // which becomes the hook) can't be kept.
+    for (int i = 0; i < nTargets; i++)
+        if (targets[i] >= srcAddr && targets[i] < srcAddr + in) return TRAMP_SELF_BRANCH;
+
+    if (o + 5 > cap) return TRAMP_NO_ROOM;
+    out[o] = 0xE9;
+    if (!X86_PutRel32(out + o + 1, outAddr + o + 5, srcAddr + in)) return TRAMP_RANGE;
+    o += 5;
+
+    stolen = in;
+    size   = o;
+    return TRAMP_OK;
+}
+
+const char* Tramp_ResultStr(TrampResult r)
+{
+    switch (r)
+    {
+    case TRAMP_OK:          return "ok";
+    case TRAMP_DECODE:      return "undecodable instruction";
+    case TRAMP_TOO_SHORT:   return "function shorter than the patch";
+    case TRAMP_UNSUPPORTED: return "unrelocatable instruction";
+    case TRAMP_SELF_BRANCH: return "branch into stolen bytes";
+    case TRAMP_RANGE:       return "relocated branch out of range";
+    case TRAMP_NO_ROOM:     return "stub buffer too small";
+    }
+    return "?";
+}
@@ -0,0 +1,32 @@
+#pragma once
+// trampoline.h - relocate a function's stolen prologue so the original can
+// still be called after its first bytes are overwritten by a jmp.
+// Whole instructions are copied until at least minLen bytes are covered,
+// relative branches are re-aimed (rel8 forms widened to rel32), and a jmp
+// back to the first untouched instruction is appended. Pure byte work: the
+// caller supplies the final address of the output buffer.
+
+#include <cstddef>
+#include <cstdint>
+
+static const size_t TRAMP_MAX_STOLEN = 16;
+static const size_t TRAMP_MAX_SIZE   = 64;   // worst case output incl. the jmp back
+
+enum TrampResult
+{
+    TRAMP_OK,
+    TRAMP_DECODE,        // unknown or truncated instruction
+    TRAMP_TOO_SHORT,     // ret/jmp before minLen bytes
+    TRAMP_UNSUPPORTED,   // loop/jecxz, rel16, prefixed short branch
+    TRAMP_SELF_BRANCH,   // branch into the stolen bytes
+    TRAMP_RANGE,         // relocated rel32 does not reach (64-bit hosts only)
+    TRAMP_NO_ROOM,       // output buffer too small
+};
+
+// src/avail: readable copy of the original code, located at srcAddr.
+// out/cap: buffer that will run at outAddr.
+// stolen receives the prologue bytes consumed, size the bytes written.
+TrampResult Tramp_Build(const uint8_t* src, size_t avail, uintptr_t srcAddr, size_t minLen,
+                        uint8_t* out, size_t cap, uintptr_t outAddr,
+                        size_t& stolen, size_t& size);
+const char* Tramp_ResultStr(TrampResult r);
@@ -0,0 +1,66 @@
+// vmt_shadow.cpp - pooled shadow vtables, one per hooked class
+#include "vmt_shadow.h"
+#include <cstring>
+#include <new>
+#include <vector>
+
+static const size_t VMT_ALIGN = 64;
+static const size_t VMT_HDR   = VMT_ALIGN / sizeof(void*);   // header line, words
+
+struct ShadowEntry
+{
+    void** orig;
+    void** table;
+};
+
+static std::vector<ShadowEntry> g_shadows;
+
+static void** VptrOf(const void* obj) { return *(void** const*)obj; }
+
+static const ShadowEntry* FindByTable(void** table)
+{
+    for (const ShadowEntry& e : g_shadows) if (e.table == table) return &e;
+    return nullptr;
+}
+
+void** VmtShadow_Get(void** origVtable, int slots, VmtFillFn fill)
+{
+    if (!origVtable || slots <= 0) return nullptr;
+    for (const ShadowEntry& e : g_shadows) if (e.orig == origVtable) return e.table;
+
+    size_t words = VMT_HDR + (size_t)slots;
+    void** block = (void**)::operator new(words * sizeof(void*), std::align_val_t(VMT_ALIGN), std::nothrow);
+    if (!block) return nullptr;
+
+    void** table = block + VMT_HDR;
+    table[-2] = origVtable;
+    table[-1] = origVtable[-1];
+    memcpy(table, origVtable, (size_t)slots * sizeof(void*));
+    if (fill) fill(table, origVtable);
+
+    g_shadows.push_back({ origVtable, table });
+    return table;
+}
+
+void VmtShadow_Attach(void* obj, void** shadow)
+{
+    if (obj && shadow && VptrOf(obj) != shadow) *(void***)obj = shadow;
+}
+
+bool VmtShadow_Detach(void* obj)
+{
+    const ShadowEntry* e = obj ? FindByTable(VptrOf(obj)) : nullptr;
+    if (!e) return false;
+    *(void***)obj = e->orig;
+    return true;
+}
+
+bool VmtShadow_IsShadowed(const void* obj)
+{
+    return obj && FindByTable(VptrOf(obj));
+}
+
+int VmtShadow_Count()
+{
+    return (int)g_shadows.size();
+}
@@ -0,0 +1,26 @@
+#pragma once
+// vmt_shadow.h - per-object vtable shadowing.
+// Instead of patching a class vtable (which reroutes every instance), copy
+// it once into a cache-aligned shadow with our hooks filled in and point
+// only the objects we own at it. Shadows are pooled: one per original
+// vtable, shared by every shadowed instance of that class, kept for the
+// life of the process. Not thread-safe; call from the game thread.
+//
+// Shadow layout (void* words, table 64-byte aligned):
+//   table[-2]  original vtable (for Detach / ownership checks)
+//   table[-1]  original[-1]    (MSVC RTTI locator, so typeid still works)
+//   table[0..slots)
+
+#include <cstdint>
+
+// Fills hooked slots of a fresh copy; orig is the class vtable.
+typedef void (*VmtFillFn)(void** table, void* const* orig);
+
+// Pooled shadow for origVtable, built on first use. slots entries are copied.
+void** VmtShadow_Get(void** origVtable, int slots, VmtFillFn fill);
+// Point obj at shadow; no-op if already there.
+void   VmtShadow_Attach(void* obj, void** shadow);
+// Restore obj's class vtable. False if obj wasn't shadowed.
+bool   VmtShadow_Detach(void* obj);
+bool   VmtShadow_IsShadowed(const void* obj);
+int    VmtShadow_Count();
@@ -0,0 +1,146 @@
+#pragma once
+// vtable_hook.h - declarative vtable hook tables.
+// A weapon lists its overrides once:
+//
+//   using Janus1Hooks = VtableHookSet<CJanus1Hook, WEAPON_VTABLE_SLOTS,
+//       VtHook<SLOT_Deploy,        &CJanus1Hook::Deploy>,
+//       VtPreHook<SLOT_WeaponIdle, &Janus1_PreIdle>>;
+//
+// Out-of-range slots, a slot hooked twice, a method used twice or a method
+// of another class fail to compile. AddTo() queues every slot into one
+// PatchBatch; Fill() writes them into a shadow table instead (vmt_shadow.h).
+// Each method gets its own original-pointer storage, and
+// VtOrig<&Class::Method>::Call(this, ...) inlines to one load and an
+// indirect __thiscall, the same code the hand-written casts produced.
+
+#include "patch.h"
+#include "thunk.h"
+#include <cstring>
+#include <type_traits>
+
+#if !defined(_MSC_VER) && !defined(__thiscall)
+#  if defined(__i386__)
+#    define __thiscall __attribute__((thiscall))
+#    define __cdecl    __attribute__((cdecl))
+#  else
+#    define __thiscall
+#    define __cdecl
+#  endif
+#endif
+
+// Original-pointer storage and call-through for one wrapper method.
+template<auto Fn, typename F = decltype(Fn)>
+struct VtOrig;
+
+template<auto Fn, typename C, typename R, typename... A>
+struct VtOrig<Fn, R (C::*)(A...)>
+{
+    using Class = C;
+    static inline void* ptr = nullptr;
+
+    static R Call(void* self, A... a)
+    {
+        typedef R(__thiscall* Thiscall)(void*, A...);
+        return reinterpret_cast<Thiscall>(ptr)(self, a...);
+    }
+};
+
+// Code address of a non-virtual method of a single-inheritance class: the
+// first word of the member pointer (on MSVC x86, the whole of it).
+template<typename F>
+inline void* VtCodePtr(F fn)
+{
+    static_assert(std::is_member_function_pointer<F>::value, "not a member function");
+    void* p;
+    memcpy(&p, &fn, sizeof(p));
+    return p;
+}
+
+// Replacement: the slot points at a wrapper method, which reaches the
+// original through VtOrig.
+template<int Slot, auto Fn>
+struct VtHook
+{
+    static constexpr int slot = Slot;
+    using Key   = VtOrig<Fn>;
+    using Class = typename VtOrig<Fn>::Class;
+
+    static void** Storage()          { return &VtOrig<Fn>::ptr; }
+    static void*  Target(void*)      { return VtCodePtr(Fn); }
+};
+
+// Pre-hook: the slot points at a generated thunk that calls
+// void __cdecl Pre(void* self) and then jumps straight into the original
+// (thunk.h). For per-frame slots where we only add behaviour.
+template<int Slot, void (__cdecl* Pre)(void*)>
+struct VtPreHook
+{
+    static constexpr int slot = Slot;
+    using Key   = VtPreHook;
+    using Class = void;
+    static inline void* orig = nullptr;
+
+    static void** Storage()          { return &orig; }
+    static void*  Target(void* prev) { return Thunk_MakePre((void*)Pre, prev); }
+};
+
+template<typename Weapon, int NumSlots, typename... Hooks>
+struct VtableHookSet
+{
+    static constexpr int count = (int)sizeof...(Hooks);
+
+    static constexpr bool SlotsInRange()
+    {
+        int s[] = { Hooks::slot... };
+        for (int i = 0; i < count; i++)
+            if (s[i] < 0 || s[i] >= NumSlots) return false;
+        return true;
+    }
+    static constexpr bool SlotsUnique()
+    {
+        int s[] = { Hooks::slot... };
+        for (int i = 0; i < count; i++)
+            for (int j = i + 1; j < count; j++)
+                if (s[i] == s[j]) return false;
+        return true;
+    }
+    template<typename H>
+    static constexpr int Uses() { return (0 + ... + (int)std::is_same<typename H::Key, typename Hooks::Key>::value); }
+    template<typename H>
+    static constexpr bool Ours() { return std::is_void<typename H::Class>::value || std::is_same<typename H::Class, Weapon>::value; }
+
+    static_assert(count > 0, "empty hook table");
+    static_assert(SlotsInRange(), "vtable slot out of range");
+    static_assert(SlotsUnique(), "vtable slot hooked twice");
+    static_assert(((Uses<Hooks>() == 1) && ...), "method used for more than one slot");
+    static_assert((Ours<Hooks>() && ...), "hook method belongs to another class");
+
+    // Queue every slot; the originals land in their storage before anything
+    // is written. The caller commits, possibly alongside other writes.
+    static bool AddTo(PatchBatch& b, void** vtable)
+    {
+        return (Queue<Hooks>(b, vtable) && ...);
+    }
+
+    // Same hooks written into a table we own (a VMT shadow), originals taken
+    // from the class vtable. Matches VmtFillFn. A thunk that can't be built
+    // leaves the slot pointing at the original.
+    static void Fill(void** table, void* const* orig)
+    {
+        (Put<Hooks>(table, orig), ...);
+    }
+
+private:
+    template<typename H>
+    static bool Queue(PatchBatch& b, void** vtable)
+    {
+        void* t = H::Target(vtable[H::slot]);
+        return t && b.AddPointer(&vtable[H::slot], t, H::Storage());
+    }
+    template<typename H>
+    static void Put(void** table, void* const* orig)
+    {
+        *H::Storage() = orig[H::slot];
+        if (void* t = H::Target(orig[H::slot])) table[H::slot] = t;
+    }
+};
@@ -0,0 +1,145 @@
+// weapon_alloc.cpp - WeaponSlab wired into mp.dll's entity lifetime
+#include "weapon_alloc.h"
+#include "game_api.h"
+#include "hooks.h"
+#include "logger.h"
+#include "weapon_slab.h"
+
+typedef void  (__cdecl* OnFreeEntPrivateDataFn)(edict_t* ed);
+typedef void  (__cdecl* ServerDeactivateFn)();
+typedef void* (__cdecl* PvAllocEntPrivateDataFn)(edict_t* ed, int32_t cb);
+
+static WeaponSlab g_slab;
+static uintptr_t  g_rvaFreePrivate = 0;
+static uintptr_t  g_rvaDeactivate  = 0;
+static bool       g_mapEnding      = false;
+static bool       g_required       = false;
+static PvAllocEntPrivateDataFn g_engAlloc = nullptr;   // the engine's, from mp's table
+static int        g_factories      = 0;       // slab factories running (game thread)
+static size_t     g_factorySize    = 0;       // what the running one expects, 0 = any
+
+static void** PrivateSlot(edict_t* ed)
+{
+    return reinterpret_cast<void**>(reinterpret_cast<uint8_t*>(ed) + CSNZ_PVPRIVATE_OFFSET);
+}
+
+// The engine calls this right before freeing pvPrivateData; mp.dll runs the
+// destructor. Ours go back to the slab and the slot is cleared so the
+// engine's Mem_Free sees null.
+static void __cdecl Hook_OnFreeEntPrivateData(edict_t* ed)
+{
+    auto orig = (OnFreeEntPrivateDataFn)GetOriginal(g_rvaFreePrivate);
+    if (orig) orig(ed);
+    if (!ed) return;
+
+    void** slot = PrivateSlot(ed);
+    if (*slot && g_slab.Free(*slot)) *slot = nullptr;
+    if (g_mapEnding && !g_slab.Live())
+    {
+        g_slab.ReleaseAll();
+        g_mapEnding = false;
+    }
+}
+
+// Entities are freed after this, during the level change; the last one
+// out releases the chunks.
+static void __cdecl Hook_ServerDeactivate()
+{
+    auto orig = (ServerDeactivateFn)GetOriginal(g_rvaDeactivate);
+    if (orig) orig();
+    LOG_DEBUG(hooks, "map end: %zu weapon objects live in %d chunks\n", g_slab.Live(), g_slab.Chunks());
+    if (g_slab.Live()) g_mapEnding = true;
+    else g_slab.ReleaseAll();
+}
+
+// mp.dll's GetClassPtr allocates through its engine table. Inside a slab
+// factory the object comes from the slab; everything else goes to the engine.
+static void* __cdecl Hook_PvAllocEntPrivateData(edict_t* ed, int32_t cb)
+{
+    if (g_factories && cb > 0)
+    {
+        static bool warned = false;
+        if (g_factorySize && (size_t)cb != g_factorySize && !warned)
+        {
+            LOG_WARN(hooks, "factory allocates %d bytes, weapon record says %zu\n", cb, g_factorySize);
+            warned = true;
+        }
+        if (void* p = WeaponObj_Alloc(ed, (size_t)cb)) return p;
+    }
+    return g_engAlloc(ed, cb);
+}
+
+void WeaponAlloc_Require()
+{
+    g_required = true;
+}
+
+bool WeaponAlloc_Register(HMODULE hMp)
+{
+    if (g_rvaFreePrivate) return true;
+    if (!g_required)
+    {
+        LOG_DEBUG(hooks, "no weapon allocates from the slab, free hooks not installed\n");
+        return true;
+    }
+
+    GameApi api;
+    if (!GameApi_Query(hMp, api) || !api.hasDll || !api.hasNewDll
+        || !api.newDll[NEWDLLFN_OnFreeEntPrivateData] || !api.dll[DLLFN_ServerDeactivate])
+    {
+        LOG_WARN(hooks, "weapon slab disabled: game API tables unavailable\n");
+        return false;
+    }
+    uintptr_t base = (uintptr_t)hMp;
+    uintptr_t rvaFree = (uintptr_t)api.newDll[NEWDLLFN_OnFreeEntPrivateData] - base;
+    uintptr_t rvaDeac = (uintptr_t)api.dll[DLLFN_ServerDeactivate] - base;
+
+    if (!RegisterDetour(hMp, "OnFreeEntPrivateData", (void*)Hook_OnFreeEntPrivateData, rvaFree))
+        return false;
+    if (!RegisterDetour(hMp, "ServerDeactivate", (void*)Hook_ServerDeactivate, rvaDeac))
+        LOG_WARN(hooks, "no map-end hook, slab chunks kept until unload\n");
+    g_rvaFreePrivate = rvaFree;
+    g_rvaDeactivate  = rvaDeac;
+    return true;
+}
+
+bool WeaponAlloc_PostInit()
+{
+    if (g_engAlloc) return true;
+    if (!GetOriginal(g_rvaFreePrivate)) return !g_required;
+    enginefuncs_t* mpEng = GetMpEngfuncs();
+    if (!mpEng || !mpEng->pfnPvAllocEntPrivateData)
+    {
+        LOG_WARN(hooks, "weapon slab disabled: no engine table in mp.dll\n");
+        return false;
+    }
+    // .data, writable as is; one aligned pointer store, so a server frame
+    // racing us sees either the old entry or ours.
+    g_engAlloc = mpEng->pfnPvAllocEntPrivateData;
+    mpEng->pfnPvAllocEntPrivateData = Hook_PvAllocEntPrivateData;
+    LOG_DEBUG(hooks, "PvAllocEntPrivateData routed through the weapon slab\n");
+    return true;
+}
+
+void WeaponAlloc_FactoryBegin(size_t size)
+{
+    g_factories++;
+    g_factorySize = size;
+}
+
+void WeaponAlloc_FactoryEnd()
+{
+    if (g_factories) g_factories--;
+    if (!g_factories) g_factorySize = 0;
+}
+
+void* WeaponObj_Alloc(edict_t* ed, size_t size)
+{
+    // Without the free detour the engine would Mem_Free our memory.
+    if (!ed || !GetOriginal(g_rvaFreePrivate)) return nullptr;
+    void** slot = PrivateSlot(ed);
+    if (*slot) return nullptr;
+    void* p = g_slab.Alloc(size);
+    if (p) *slot = p;
+    return p;
+}
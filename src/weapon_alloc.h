@@ -0,0 +1,33 @@
+#pragma once
+// weapon_alloc.h - slab-backed private data for our custom weapons.
+// Objects we create live in a WeaponSlab instead of the engine heap. mp.dll's
+// OnFreeEntPrivateData is detoured to hand them back (and null the edict's
+// pointer so the engine's own free skips them), and ServerDeactivate marks
+// the map end so the slab's chunks are dropped once the last object is gone.
+// Both detours sit on every entity free, so they only go in once a weapon
+// says its factory allocates here (WeaponAlloc_Require). Objects get here
+// through mp.dll's own pfnPvAllocEntPrivateData entry, which is redirected
+// to the slab while a weapon's factory runs (WeaponAlloc_FactoryBegin/End).
+
+#include <windows.h>
+#include <cstddef>
+#include "hlsdk/sdk.h"
+
+// A weapon whose factory calls WeaponObj_Alloc calls this from its setup,
+// before WeaponAlloc_Register.
+void  WeaponAlloc_Require();
+// Must run before Hooks_Install. Safe to call again after a failed install.
+// Installs nothing (and returns true) until some weapon has required it.
+bool  WeaponAlloc_Register(HMODULE hMp);
+// After Hooks_Install: takes over mp.dll's pfnPvAllocEntPrivateData once
+// the free detour is in. True if nothing was required.
+bool  WeaponAlloc_PostInit();
+// Bracket a detoured factory's call to the original: its allocation comes
+// from the slab. size is the expected object size (logged if the game asks
+// for another), 0 if unknown. Game thread.
+void  WeaponAlloc_FactoryBegin(size_t size);
+void  WeaponAlloc_FactoryEnd();
+// Zeroed object of `size` bytes stored as the edict's private data, or null
+// when the slab isn't active (detours not installed) - callers then fall
+// back to the engine's pfnPvAllocEntPrivateData.
+void* WeaponObj_Alloc(edict_t* ed, size_t size);
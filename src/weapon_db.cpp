@@ -0,0 +1,68 @@
+// weapon_db.cpp - read-only file mapping of the compiled weapon definitions
+#include "weapon_db.h"
+#include "platform/platform.h"
+#include <cstring>
+#include <initializer_list>
+
+static void*   g_map  = nullptr;
+static WdbView g_view = {};
+
+void WeaponDb_Close()
+{
+    Plat_UnmapFile(g_map);
+    g_map = nullptr;
+    memset(&g_view, 0, sizeof(g_view));
+}
+
+bool WeaponDb_Open(const char* path)
+{
+    WeaponDb_Close();
+    size_t size = 0;
+    const void* data = Plat_MapFile(path, size, g_map);
+    if (!data || !Wdb_View(data, size, g_view))
+    {
+        WeaponDb_Close();
+        return false;
+    }
+    return true;
+}
+
+int WeaponDb_Count()
+{
+    return g_view.hdr ? (int)g_view.hdr->count : 0;
+}
+
+const WeaponDef* WeaponDb_Find(uint32_t id)
+{
+    return Wdb_Find(g_view, id);
+}
+
+const char* WeaponDb_Str(uint32_t off)
+{
+    return Wdb_Str(g_view, off);
+}
+
+// The engine keeps the pointers it is given; the blob stays mapped until
+// unload, so the pool strings can go straight in.
+unsigned short WeaponDb_Precache(const WeaponDef& d, const enginefuncs_t& eng)
+{
+    for (uint32_t m : { d.modelV, d.modelP, d.modelW })
+        if (const char* s = WeaponDb_Str(m)) eng.pfnPrecacheModel(s);
+    for (uint32_t m : { d.soundFire, d.soundReload })
+        if (const char* s = WeaponDb_Str(m)) eng.pfnPrecacheSound(s);
+    const char* ev = WeaponDb_Str(d.event);
+    return ev ? eng.pfnPrecacheEvent(1, ev) : 0;
+}
+
+void WeaponDb_ItemInfo(const WeaponDef& d, int& maxClip, int& maxAmmo1)
+{
+    if (d.clip)    maxClip  = d.clip;
+    if (d.maxAmmo) maxAmmo1 = d.maxAmmo;
+}
+
+void WeaponDb_Volley(const WeaponDef& d, bool moving, bool inAir, HsVolley& v)
+{
+    if (d.damage) v.damage = d.damage;
+    float cone = inAir && d.spreadAir ? d.spreadAir : moving && d.spreadMove ? d.spreadMove : d.spread;
+    if (cone) v.spreadX = v.spreadY = cone;
+}
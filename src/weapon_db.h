@@ -0,0 +1,25 @@
+#pragma once
+// weapon_db.h - the mapped weapon definition blob (weapon_def.h).
+// Opened once at startup; lookups by weapon ID are a bounds check and one
+// index load. Adding or tuning weapons means recompiling the .wdb with
+// csnz_wdefc, not rebuilding the DLL.
+
+#include "hitscan.h"
+#include "weapon_def.h"
+#include "hlsdk/engine_types.h"
+
+bool             WeaponDb_Open(const char* path);
+void             WeaponDb_Close();
+int              WeaponDb_Count();
+const WeaponDef* WeaponDb_Find(uint32_t id);
+const char*      WeaponDb_Str(uint32_t off);                   // null if unset
+
+// The consumers' side. Each applies what the record sets and leaves the
+// rest as the game has it.
+// Precache the models and sounds through eng; returns the fire event
+// handle, 0 if the record has no event.
+unsigned short   WeaponDb_Precache(const WeaponDef& d, const enginefuncs_t& eng);
+// GetItemInfo's max clip and primary ammo.
+void             WeaponDb_ItemInfo(const WeaponDef& d, int& maxClip, int& maxAmmo1);
+// Per-pellet damage and the cone for how the shooter is moving.
+void             WeaponDb_Volley(const WeaponDef& d, bool moving, bool inAir, HsVolley& v);
@@ -0,0 +1,105 @@
+#pragma once
+// weapon_def.h - compiled weapon definition blob (.wdb).
+// Authored as text (data/weapons.txt), compiled by tools/wdefc into one
+// flat little-endian image that the DLL maps and uses in place: a header,
+// a direct index by weapon ID, fixed-size records and a string pool.
+// Nothing is parsed at load; Wdb_View only checks the header bounds and
+// every accessor stays inside the image. Shared by the compiler and the DLL.
+//
+// Layout: WdbHeader | u32 index[maxId + 1] | WeaponDef defs[count] | strings
+//   index[id] = record number, WDB_NONE if the ID is unused
+//   string fields are offsets into the pool, 0 = unset (pool starts with NUL)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static const char     WDB_MAGIC[8] = { 'C','S','N','Z','W','D','B','1' };
+static const uint32_t WDB_NONE     = 0xFFFFFFFF;
+static const uint32_t WDB_MAX_ID   = 0xFFFF;
+
+struct WdbHeader
+{
+    char     magic[8];
+    uint32_t fileSize;
+    uint32_t count;
+    uint32_t maxId;
+    uint32_t indexOff;
+    uint32_t defsOff;
+    uint32_t defSize;      // sizeof(WeaponDef) the blob was built with
+    uint32_t stringsOff;
+    uint32_t stringsSize;
+};
+
+// Everything static about a weapon, keyed by its CSNZ weapon ID. Zero
+// fields (and unset strings) keep the game's value, or for the mode switch
+// the built-in one (weapons/<name>.h).
+struct WeaponDef
+{
+    uint32_t id;
+    uint32_t classname;    // e.g. weapon_janus1
+    uint32_t modelV, modelP, modelW;
+    uint32_t soundFire, soundReload;
+    uint32_t event;
+    // mp.dll RVAs for the build the blob was made for; beat the offset
+    // database and address cache when set.
+    uint32_t vtableRva;
+    uint32_t factoryRva;
+    uint32_t objSize;      // bytes of private data the class allocates
+    int32_t  clip;
+    int32_t  maxAmmo;
+    float    fireRate;     // seconds between shots
+    float    reloadTime;
+    float    damage;       // per bullet / pellet
+    float    spread;       // cone standing still
+    float    spreadMove;
+    float    spreadAir;
+    // Mode switch (weapon_fsm.h): shots before the signal, then how long the
+    // signal, the change animation and the second mode last, in seconds.
+    uint32_t modeShots;
+    float    signalTime;
+    float    changeTime;
+    float    modeTime;
+};
+
+struct WdbView
+{
+    const uint8_t*   base;
+    const WdbHeader* hdr;
+    const uint32_t*  index;
+    const WeaponDef* defs;
+    const char*      strings;
+};
+
+// O(1): header and table bounds only.
+inline bool Wdb_View(const void* data, size_t size, WdbView& v)
+{
+    memset(&v, 0, sizeof(v));
+    const WdbHeader* h = (const WdbHeader*)data;
+    if (!data || size < sizeof(WdbHeader) || memcmp(h->magic, WDB_MAGIC, 8)) return false;
+    if (h->fileSize != size || h->defSize != sizeof(WeaponDef) || h->maxId > WDB_MAX_ID) return false;
+    if ((uint64_t)h->indexOff + ((uint64_t)h->maxId + 1) * 4 > size) return false;
+    if ((uint64_t)h->defsOff + (uint64_t)h->count * sizeof(WeaponDef) > size) return false;
+    if (!h->stringsSize || (uint64_t)h->stringsOff + h->stringsSize > size) return false;
+    if (h->indexOff % 4 || h->defsOff % 4) return false;
+
+    v.base    = (const uint8_t*)data;
+    v.hdr     = h;
+    v.index   = (const uint32_t*)(v.base + h->indexOff);
+    v.defs    = (const WeaponDef*)(v.base + h->defsOff);
+    v.strings = (const char*)(v.base + h->stringsOff);
+    // The compiler NUL-terminates the pool, so any in-range offset is a valid C string.
+    return v.strings[h->stringsSize - 1] == 0;
+}
+
+inline const WeaponDef* Wdb_Find(const WdbView& v, uint32_t id)
+{
+    if (!v.hdr || id > v.hdr->maxId) return nullptr;
+    uint32_t i = v.index[id];
+    return i < v.hdr->count ? &v.defs[i] : nullptr;
+}
+
+inline const char* Wdb_Str(const WdbView& v, uint32_t off)
+{
+    return v.hdr && off && off < v.hdr->stringsSize ? v.strings + off : nullptr;
+}
@@ -0,0 +1,45 @@
+// weapon_fsm.cpp - flattening state/transition lists into a WfsmTable
+#include "weapon_fsm.h"
+#include <cstring>
+
+bool Wfsm_Build(const WfsmDef& def, WfsmTable& out)
+{
+    memset(&out, 0, sizeof(out));
+    if (def.numStates <= 0 || def.numStates > WFSM_MAX_STATES || def.numTrans > WFSM_MAX_TRANS)
+        return false;
+    for (int i = 0; i < def.numTrans; i++)
+        if (def.trans[i].from >= def.numStates || def.trans[i].to >= def.numStates) return false;
+
+    out.def       = &def;
+    out.numStates = def.numStates;
+    for (int s = 0; s < def.numStates; s++)
+    {
+        out.duration[s] = def.states[s].duration;
+        out.anim[s]     = def.states[s].anim;
+    }
+
+    // Counting sort by from-state; list order is kept within a state, so
+    // earlier transitions still win.
+    int n = 0;
+    for (int s = 0; s < def.numStates; s++)
+    {
+        out.first[s] = (uint8_t)n;
+        for (int i = 0; i < def.numTrans; i++)
+        {
+            const WfsmTransDef& d = def.trans[i];
+            if (d.from != s) continue;
+            out.mask[n] = d.mask;
+            out.want[n] = d.want;
+            out.to[n]   = d.to;
+            n++;
+        }
+    }
+    out.first[def.numStates] = (uint8_t)n;
+    return true;
+}
+
+void Wfsm_Enter(const WfsmTable& t, WfsmInst& inst, int state, float now)
+{
+    inst.state = (uint8_t)state;
+    inst.until = t.duration[state] > 0.0f ? now + t.duration[state] : 0.0f;
+}
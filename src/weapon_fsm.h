@@ -0,0 +1,117 @@
+#pragma once
+// weapon_fsm.h - table-driven state machine for mode-switch weapons
+// (Janus, Buffer, Transform...). A weapon is a list of states (animation,
+// timer) and a list of guarded transitions; Wfsm_Build flattens them once
+// into a WfsmTable where each state's transitions are one contiguous run.
+// Wfsm_Tick is then the same few loads and masked compares for every
+// weapon: no per-weapon code on the frame path.
+//
+//   #define MYGUN_STATES(S)                       anim  seconds (0 = no timer)
+//       S(Idle,    0, 0.0f)
+//       S(Charged, 6, 0.0f)
+//   #define MYGUN_TRANS(T)                        from  to  mask  want
+//       T(Idle,    Charged, WIN_CHARGED, WIN_CHARGED)
+//       T(Charged, Idle,    WIN_TIMEOUT, WIN_TIMEOUT)
+//   WFSM_DEFINE(MyGun, MYGUN_STATES, MYGUN_TRANS)
+//   ... Wfsm_Build(MyGun_Def, table) once, Wfsm_Tick(table, inst, in, now) per frame.
+//
+// A transition fires when (inputs & mask) == want; the first match in list
+// order wins and at most one fires per tick. Inputs are whatever the caller
+// sampled this frame, plus WIN_TIMEOUT once the state's timer has run out.
+// Portable; the game glue maps weapon fields and buttons to input bits.
+
+#include <cstdint>
+
+// Input bits 0-23 are the caller's, the rest are reserved for the engine.
+static const uint32_t WIN_ATTACK1 = 1u << 0;
+static const uint32_t WIN_ATTACK2 = 1u << 1;
+static const uint32_t WIN_RELOAD  = 1u << 2;
+static const uint32_t WIN_CHARGED = 1u << 3;    // weapon-specific threshold reached
+static const uint32_t WIN_EMPTY   = 1u << 4;    // clip empty
+static const uint32_t WIN_TIMEOUT = 1u << 24;   // set by Wfsm_Tick
+
+static const int WFSM_MAX_STATES = 32;
+static const int WFSM_MAX_TRANS  = 128;
+
+struct WfsmStateDef
+{
+    const char* name;
+    int16_t     anim;         // -1 = leave the animation alone
+    float       duration;     // seconds before WIN_TIMEOUT, 0 = none
+};
+
+struct WfsmTransDef
+{
+    uint8_t  from, to;
+    uint32_t mask, want;
+};
+
+struct WfsmDef
+{
+    const char*         name;
+    const WfsmStateDef* states;
+    int                 numStates;
+    const WfsmTransDef* trans;
+    int                 numTrans;
+};
+
+// Built form. trans[] is grouped by from-state: state s owns
+// [first[s], first[s + 1]).
+struct WfsmTable
+{
+    const WfsmDef* def;
+    int            numStates;
+    float          duration[WFSM_MAX_STATES];
+    int16_t        anim[WFSM_MAX_STATES];
+    uint8_t        first[WFSM_MAX_STATES + 1];
+    uint32_t       mask[WFSM_MAX_TRANS];
+    uint32_t       want[WFSM_MAX_TRANS];
+    uint8_t        to[WFSM_MAX_TRANS];
+};
+
+// Per-object state, 8 bytes. Zeroed = state 0 with no timer armed yet;
+// call Wfsm_Enter to start the first state's timer.
+struct WfsmInst
+{
+    uint8_t state;
+    uint8_t pad[3];
+    float   until;            // time WIN_TIMEOUT fires, 0 = never
+};
+
+// False if the def has too many states or transitions or a transition
+// names a state that doesn't exist.
+bool Wfsm_Build(const WfsmDef& def, WfsmTable& out);
+void Wfsm_Enter(const WfsmTable& t, WfsmInst& inst, int state, float now);
+
+// Evaluate one frame. Returns the state entered, or -1 if nothing fired.
+inline int Wfsm_Tick(const WfsmTable& t, WfsmInst& inst, uint32_t inputs, float now)
+{
+    int s = inst.state;
+    inputs |= (inst.until != 0.0f && now >= inst.until) ? WIN_TIMEOUT : 0;
+    for (int i = t.first[s], end = t.first[s + 1]; i < end; i++)
+    {
+        if ((inputs & t.mask[i]) != t.want[i]) continue;
+        Wfsm_Enter(t, inst, t.to[i], now);
+        return t.to[i];
+    }
+    return -1;
+}
+
+inline const char* Wfsm_StateName(const WfsmTable& t, int state)
+{
+    return state >= 0 && state < t.numStates ? t.def->states[state].name : "?";
+}
+
+// Generates namespace <Name>_Fsm { enum State { <state>..., COUNT }; the
+// state and transition arrays } and the WfsmDef <Name>_Def.
+#define WFSM_DEFINE(Name, STATES, TRANS)                                      \
+    namespace Name##_Fsm {                                                    \
+        enum State : uint8_t { STATES(WFSM_ENUM_) COUNT };                     \
+        static const WfsmStateDef states[] = { STATES(WFSM_SDEF_) };           \
+        static const WfsmTransDef trans[]  = { TRANS(WFSM_TDEF_) };            \
+    }                                                                         \
+    static const WfsmDef Name##_Def = { #Name, Name##_Fsm::states, Name##_Fsm::COUNT, \
+        Name##_Fsm::trans, (int)(sizeof(Name##_Fsm::trans) / sizeof(WfsmTransDef)) };
+#define WFSM_ENUM_(name, anim, secs)           name,
+#define WFSM_SDEF_(name, anim, secs)           { #name, anim, secs },
+#define WFSM_TDEF_(from, to, mask, want)       { from, to, mask, want },
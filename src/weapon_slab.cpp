@@ -0,0 +1,74 @@
+// weapon_slab.cpp - per-class free lists over 64 KB chunks
+#include "weapon_slab.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+static size_t ClassSize(int cls) { return (size_t)(cls + 1) * SLAB_LINE; }
+
+int WeaponSlab::Find(const void* p) const
+{
+    const uint8_t* a = (const uint8_t*)p;
+    auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), a,
+                               [](const uint8_t* v, const Chunk& c) { return v < c.base; });
+    if (it == m_chunks.begin()) return -1;
+    --it;
+    if (a >= it->base + SLAB_CHUNK) return -1;
+    return (int)(it - m_chunks.begin());
+}
+
+bool WeaponSlab::Refill(int cls)
+{
+    uint8_t* base = (uint8_t*)::operator new(SLAB_CHUNK, std::align_val_t(SLAB_LINE), std::nothrow);
+    if (!base) return false;
+
+    Chunk c = { base, (uint32_t)cls };
+    m_chunks.insert(std::upper_bound(m_chunks.begin(), m_chunks.end(), c,
+                                     [](const Chunk& x, const Chunk& y) { return x.base < y.base; }), c);
+
+    // Push back to front so the list hands out ascending addresses.
+    size_t sz = ClassSize(cls), n = SLAB_CHUNK / sz;
+    for (size_t i = n; i-- > 0; )
+    {
+        FreeObj* o = (FreeObj*)(base + i * sz);
+        o->next = m_free[cls];
+        m_free[cls] = o;
+    }
+    return true;
+}
+
+void* WeaponSlab::Alloc(size_t size)
+{
+    if (!size || size > SLAB_MAX_OBJ) return nullptr;
+    int cls = (int)((size + SLAB_LINE - 1) / SLAB_LINE) - 1;
+    if (!m_free[cls] && !Refill(cls)) return nullptr;
+
+    FreeObj* o = m_free[cls];
+    m_free[cls] = o->next;
+    memset(o, 0, ClassSize(cls));
+    m_live++;
+    return o;
+}
+
+bool WeaponSlab::Free(void* p)
+{
+    int ci = p ? Find(p) : -1;
+    if (ci < 0) return false;
+    const Chunk& c = m_chunks[ci];
+    size_t sz = ClassSize((int)c.cls);
+    if ((size_t)((uint8_t*)p - c.base) % sz) return false;   // interior pointer
+
+    FreeObj* o = (FreeObj*)p;
+    o->next = m_free[c.cls];
+    m_free[c.cls] = o;
+    m_live--;
+    return true;
+}
+
+void WeaponSlab::ReleaseAll()
+{
+    for (const Chunk& c : m_chunks) ::operator delete(c.base, std::align_val_t(SLAB_LINE));
+    m_chunks.clear();
+    memset(m_free, 0, sizeof(m_free));
+    m_live = 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+// weapon_slab.h - size-class slab allocator for weapon entity objects.
+// Objects are rounded up to 64-byte classes (up to SLAB_MAX_OBJ) and carved
+// from 64 KB chunks; each class keeps an intrusive free list, so spawn/free
+// churn never reaches the heap. ReleaseAll() drops every chunk at once for
+// map change. Memory comes back zeroed, like pfnPvAllocEntPrivateData.
+// Not thread-safe; entities live on the game thread.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const size_t SLAB_LINE    = 64;
+static const size_t SLAB_MAX_OBJ = 2048;
+static const size_t SLAB_CHUNK   = 64 * 1024;
+static const int    SLAB_CLASSES = (int)(SLAB_MAX_OBJ / SLAB_LINE);
+
+class WeaponSlab
+{
+public:
+    ~WeaponSlab() { ReleaseAll(); }
+
+    // Null if size is 0, above SLAB_MAX_OBJ, or out of memory.
+    void*  Alloc(size_t size);
+    // p must come from Alloc; anything else is ignored (returns false).
+    bool   Free(void* p);
+    bool   Owns(const void* p) const { return Find(p) >= 0; }
+    // Invalidates every outstanding object.
+    void   ReleaseAll();
+
+    size_t Live() const   { return m_live; }
+    int    Chunks() const { return (int)m_chunks.size(); }
+
+private:
+    struct Chunk
+    {
+        uint8_t* base;
+        uint32_t cls;
+    };
+    struct FreeObj { FreeObj* next; };
+
+    int  Find(const void* p) const;   // chunk index, -1 if not ours
+    bool Refill(int cls);
+
+    FreeObj*           m_free[SLAB_CLASSES] = {};
+    std::vector<Chunk> m_chunks;      // sorted by base
+    size_t             m_live = 0;
+};
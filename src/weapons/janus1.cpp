@@ -5,85 +5,286 @@
 #include "janus1.h"
 #include "../hooks.h"
 #include "../logger.h"
+#include "../offset_db.h"
+#include "../patch.h"
+#include "../vtable_hook.h"
+#include "../vmt_shadow.h"
+#include "../weapon_alloc.h"
+#include "../weapon_db.h"
+#include "../weapon_fsm.h"
+#include "../hlsdk/cso_baseweapon.h"   // compiles the RECON_WEAPON_FIELDS checks
+#include "../hlsdk/sdk.h"
+#include "../platform/platform.h"
 #include <cstring>
 #include <cstdint>
 #include <windows.h>
 
-static const uintptr_t RVA_CJanus1_vtable = 0x1649034;
+// Dummy class so we can write __thiscall methods
+struct CJanus1Hook
+{
+    void Precache();
+    int  GetItemInfo(ItemInfo* p);
+    int  Deploy();
+    int  AddToPlayer(void* player);
+    void Holster();
+};
 
-static const int SLOT_AddToPlayer = 95;
-static const int SLOT_Deploy      = 102;
-static const int SLOT_WeaponIdle  = 142;
-static const int SLOT_Holster     = 168;
+//   Normal --charged--> Signal --secondary--> ChangeA --> ModeB --> ChangeB --> Normal
+//                          \--signal lapses--> Normal
+#define JANUS1_STATES(S)                                                      \
+    S(Normal,  -1,                      0.0f)                                 \
+    S(Signal,  JANUS1_ANIM_IDLE_SIGNAL, JANUS1_SIGNAL_TIME)                   \
+    S(ChangeA, JANUS1_ANIM_CHANGE_A,    JANUS1_CHANGE_TIME)                   \
+    S(ModeB,   JANUS1_ANIM_IDLE_B,      JANUS1_B_TIME)                        \
+    S(ChangeB, JANUS1_ANIM_CHANGE_B,    JANUS1_CHANGE_TIME)
+#define JANUS1_TRANS(T)                                                       \
+    T(Normal,  Signal,  WIN_CHARGED, WIN_CHARGED)                             \
+    T(Signal,  ChangeA, WIN_ATTACK2, WIN_ATTACK2)                             \
+    T(Signal,  Normal,  WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ChangeA, ModeB,   WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ModeB,   ChangeB, WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ChangeB, Normal,  WIN_TIMEOUT, WIN_TIMEOUT)
+WFSM_DEFINE(Janus1, JANUS1_STATES, JANUS1_TRANS)
 
-static void* g_origDeploy      = nullptr;
-static void* g_origWeaponIdle  = nullptr;
-static void* g_origAddToPlayer = nullptr;
-static void* g_origHolster     = nullptr;
+static WfsmTable g_fsm;
+static bool      g_fsmOk = false;
+static int       g_signalShots = JANUS1_SIGNAL_SHOTS;
 
-// Dummy class so we can write __thiscall methods
-struct CJanus1Hook
+// Machine state per Janus-1, keyed by object. Open addressing with linear
+// probing; Holster gives the slot back (backward shift, no tombstones).
+// PreIdle only runs for a deployed weapon and touches its slot every frame,
+// so a slot not seen for JANUS1_STALE seconds belongs to a weapon that left
+// without a Holster (dropped on death, freed with its owner) and is swept
+// when the table fills. Past that, new objects go untracked.
+static const int   JANUS1_SLOTS = 64;
+static const float JANUS1_STALE = 1.0f;
+struct Janus1Slot
 {
-    int Deploy()
-    {
-        Log("[janus1] Deploy\n");
-        typedef int(__thiscall* Fn)(void*);
-        return reinterpret_cast<Fn>(g_origDeploy)(this);
-    }
+    void*    obj;
+    float    seen;
+    WfsmInst fsm;
+};
+static Janus1Slot g_slots[JANUS1_SLOTS];
+static bool       g_slotsFullLogged = false;
+
+static uint32_t Janus1_Home(void* obj)
+{
+    return ((uint32_t)(uintptr_t)obj >> 3) % JANUS1_SLOTS;
+}
 
-    void WeaponIdle()
+static int Janus1_Find(void* obj)
+{
+    uint32_t home = Janus1_Home(obj);
+    for (uint32_t i = 0; i < JANUS1_SLOTS; i++)
     {
-        typedef void(__thiscall* Fn)(void*);
-        reinterpret_cast<Fn>(g_origWeaponIdle)(this);
+        uint32_t at = (home + i) % JANUS1_SLOTS;
+        if (g_slots[at].obj == obj) return (int)at;
+        if (!g_slots[at].obj) return -1;
     }
+    return -1;
+}
 
-    int AddToPlayer(void* player)
+// Pull later entries of the run back over the hole so every probe chain
+// stays unbroken.
+static void Janus1_Release(uint32_t hole)
+{
+    for (uint32_t j = (hole + 1) % JANUS1_SLOTS; g_slots[j].obj; j = (j + 1) % JANUS1_SLOTS)
     {
-        Log("[janus1] AddToPlayer\n");
-        typedef int(__thiscall* Fn)(void*, void*);
-        return reinterpret_cast<Fn>(g_origAddToPlayer)(this, player);
+        uint32_t home = Janus1_Home(g_slots[j].obj);
+        if ((j - home + JANUS1_SLOTS) % JANUS1_SLOTS >= (j - hole + JANUS1_SLOTS) % JANUS1_SLOTS)
+        {
+            g_slots[hole] = g_slots[j];
+            hole = j;
+        }
     }
+    g_slots[hole].obj = nullptr;
+}
 
-    void Holster()
+// Release moves entries backwards, across the wrap too, so an index walk
+// that deletes as it goes can step over one. Collect first, then delete.
+static int Janus1_Sweep(float now)
+{
+    void* stale[JANUS1_SLOTS];
+    int n = 0;
+    for (uint32_t i = 0; i < JANUS1_SLOTS; i++)
+        if (g_slots[i].obj && now - g_slots[i].seen > JANUS1_STALE) stale[n++] = g_slots[i].obj;
+    for (int k = 0; k < n; k++)
     {
-        Log("[janus1] Holster\n");
-        typedef void(__thiscall* Fn)(void*);
-        reinterpret_cast<Fn>(g_origHolster)(this);
+        int at = Janus1_Find(stale[k]);
+        if (at >= 0) Janus1_Release((uint32_t)at);
     }
-};
+    return n;
+}
 
-static bool PatchVtableSlot(void** vtable, int slot, void* newFn, void** outOrig)
+// Null when the table is full of weapons that are all in use.
+static Janus1Slot* Janus1_Slot(void* obj, float now)
 {
-    void** entry = &vtable[slot];
-    DWORD old = 0;
-    if (!VirtualProtect(entry, sizeof(void*), PAGE_EXECUTE_READWRITE, &old))
+    for (int pass = 0; pass < 2; pass++)
     {
-        Log("[janus1] VirtualProtect failed slot %d\n", slot);
-        return false;
+        uint32_t home = Janus1_Home(obj);
+        for (uint32_t i = 0; i < JANUS1_SLOTS; i++)
+        {
+            Janus1Slot& s = g_slots[(home + i) % JANUS1_SLOTS];
+            if (s.obj == obj) { s.seen = now; return &s; }
+            if (s.obj) continue;
+            s.obj  = obj;
+            s.seen = now;
+            Wfsm_Enter(g_fsm, s.fsm, Janus1_Fsm::Normal, now);
+            return &s;
+        }
+        if (!Janus1_Sweep(now)) break;
     }
-    *outOrig = *entry;
-    *entry = newFn;
-    VirtualProtect(entry, sizeof(void*), old, &old);
-    return true;
+    if (!g_slotsFullLogged) LOG_WARN(janus1, "%d Janus-1s in use, %p goes untracked\n", JANUS1_SLOTS, obj);
+    g_slotsFullLogged = true;
+    return nullptr;
+}
+
+// Runs ahead of the stock WeaponIdle every frame for every holder; the
+// thunk then enters the original directly, so keep it lean.
+// The stock code still does the actual switching; the machine tracks the
+// mode so our hooks can act on it. Secondary fire is seen through the
+// delay the game sets on flNextSecondary. No SendWeaponAnim slot yet, so
+// the anim column isn't played.
+static void __cdecl Janus1_PreIdle(void* self)
+{
+    if (!g_fsmOk) return;
+    float now = Clock_Time();
+    uint32_t in = (Fld<WpnF::iShotCount>(self) >= g_signalShots ? WIN_CHARGED : 0)
+                | (Fld<WpnF::flNextSecondary>(self) > now ? WIN_ATTACK2 : 0);
+    Janus1Slot* slot = Janus1_Slot(self, now);
+    if (!slot) return;
+    int s = Wfsm_Tick(g_fsm, slot->fsm, in, now);
+    if (s >= 0) LOG_TRACE(janus1, "%p -> %s\n", self, Wfsm_StateName(g_fsm, s));
+}
+
+using Janus1Hooks = VtableHookSet<CJanus1Hook, WEAPON_VTABLE_SLOTS,
+    VtHook<SLOT_Precache,      &CJanus1Hook::Precache>,
+    VtHook<SLOT_AddToPlayer,   &CJanus1Hook::AddToPlayer>,
+    VtHook<SLOT_GetItemInfo,   &CJanus1Hook::GetItemInfo>,
+    VtHook<SLOT_Deploy,        &CJanus1Hook::Deploy>,
+    VtPreHook<SLOT_WeaponIdle, &Janus1_PreIdle>,
+    VtHook<SLOT_Holster,       &CJanus1Hook::Holster>>;
+
+// Per-instance mode (CSNZ_VMT_SHADOW=1): the class vtable only routes
+// AddToPlayer to us, which moves the picked-up object onto a shadow table
+// carrying the full set. Janus-1s nobody picked up keep the plain vtable.
+// Precache and GetItemInfo run before anyone holds one, so they stay here.
+using Janus1Entry = VtableHookSet<CJanus1Hook, WEAPON_VTABLE_SLOTS,
+    VtHook<SLOT_Precache,    &CJanus1Hook::Precache>,
+    VtHook<SLOT_AddToPlayer, &CJanus1Hook::AddToPlayer>,
+    VtHook<SLOT_GetItemInfo, &CJanus1Hook::GetItemInfo>>;
+
+static void**           g_shadow = nullptr;
+static const WeaponDef* g_def = nullptr;      // weapon database record, null = game's values
+static unsigned short   g_fireEvent = 0;
+
+void CJanus1Hook::Precache()
+{
+    VtOrig<&CJanus1Hook::Precache>::Call(this);
+    if (!g_def || !g_engfuncs) return;
+    if (unsigned short ev = WeaponDb_Precache(*g_def, *g_engfuncs)) g_fireEvent = ev;
+    if (g_fireEvent) Fld<WpnF::usFireEvent>(this) = g_fireEvent;
+}
+
+int CJanus1Hook::GetItemInfo(ItemInfo* p)
+{
+    int ok = VtOrig<&CJanus1Hook::GetItemInfo>::Call(this, p);
+    if (ok && g_def) WeaponDb_ItemInfo(*g_def, p->iMaxClip, p->iMaxAmmo1);
+    return ok;
+}
+
+int CJanus1Hook::Deploy()
+{
+    LOG_TRACE(janus1, "Deploy\n");
+    if (g_fsmOk)
+        if (Janus1Slot* slot = Janus1_Slot(this, Clock_Time()))
+            Wfsm_Enter(g_fsm, slot->fsm, Janus1_Fsm::Normal, Clock_Time());
+    return VtOrig<&CJanus1Hook::Deploy>::Call(this);
+}
+
+int CJanus1Hook::AddToPlayer(void* player)
+{
+    LOG_TRACE(janus1, "AddToPlayer\n");
+    if (g_shadow) VmtShadow_Attach(this, g_shadow);
+    return VtOrig<&CJanus1Hook::AddToPlayer>::Call(this, player);
+}
+
+void CJanus1Hook::Holster()
+{
+    LOG_TRACE(janus1, "Holster\n");
+    int at = Janus1_Find(this);
+    if (at >= 0) Janus1_Release((uint32_t)at);
+    VtOrig<&CJanus1Hook::Holster>::Call(this);
 }
 
 void Janus1_PostInit(uintptr_t mpBase)
 {
-    Log("[janus1] PostInit\n");
-    void** vtable = reinterpret_cast<void**>(mpBase + RVA_CJanus1_vtable);
+    LOG_INFO(janus1, "PostInit\n");
+    g_fsmOk = Wfsm_Build(Janus1_Def, g_fsm);
+    if (!g_fsmOk) LOG_ERROR(janus1, "mode table rejected, mode tracking off\n");
+    if (const WeaponDef* def = g_def)
+    {
+        if (def->modeShots)  g_signalShots = (int)def->modeShots;
+        if (def->signalTime) g_fsm.duration[Janus1_Fsm::Signal]  = def->signalTime;
+        if (def->changeTime) g_fsm.duration[Janus1_Fsm::ChangeA] = g_fsm.duration[Janus1_Fsm::ChangeB] = def->changeTime;
+        if (def->modeTime)   g_fsm.duration[Janus1_Fsm::ModeB]   = def->modeTime;
+    }
+    else LOG_INFO(janus1, "no weapon database record for %u, game values\n", JANUS1_ID);
+    uintptr_t vtRva = g_def && g_def->vtableRva ? g_def->vtableRva
+                                                : GetCachedRva("CJanus1_vtable", Ofs_Rva(OFS_Rva_CJanus1_vtable));
+    void** vtable = reinterpret_cast<void**>(mpBase + vtRva);
 
-    // Get method pointers from the dummy class - these are __thiscall
-    void* fnDeploy      = (void*)(int(CJanus1Hook::*)())      &CJanus1Hook::Deploy;
-    void* fnWeaponIdle  = (void*)(void(CJanus1Hook::*)())     &CJanus1Hook::WeaponIdle;
-    void* fnAddToPlayer = (void*)(int(CJanus1Hook::*)(void*)) &CJanus1Hook::AddToPlayer;
-    void* fnHolster     = (void*)(void(CJanus1Hook::*)())     &CJanus1Hook::Holster;
+    char mode[8] = {};
+    if (Plat_GetEnv("CSNZ_VMT_SHADOW", mode, sizeof(mode)) && mode[0] == '1')
+    {
+        g_shadow = VmtShadow_Get(vtable, WEAPON_VTABLE_SLOTS, &Janus1Hooks::Fill);
+        if (!g_shadow) LOG_WARN(janus1, "shadow vtable alloc failed, patching the class vtable\n");
+    }
 
-    PatchVtableSlot(vtable, SLOT_Deploy,      fnDeploy,      &g_origDeploy);
-    PatchVtableSlot(vtable, SLOT_WeaponIdle,  fnWeaponIdle,  &g_origWeaponIdle);
-    PatchVtableSlot(vtable, SLOT_AddToPlayer, fnAddToPlayer, &g_origAddToPlayer);
-    PatchVtableSlot(vtable, SLOT_Holster,     fnHolster,     &g_origHolster);
+    // Every slot in one batch: one protection flip, and the originals are
+    // stored before any slot is redirected.
+    PatchBatch batch;
+    bool queued = g_shadow ? Janus1Entry::AddTo(batch, vtable) : Janus1Hooks::AddTo(batch, vtable);
+    if (!queued || !batch.Commit(Patch_ProcessMemory()))
+    {
+        LOG_ERROR(janus1, "vtable patch failed at 0x%08zX: %s\n", batch.ErrorAddr(), batch.Error());
+        g_shadow = nullptr;
+        return;
+    }
+    if (g_shadow) LOG_INFO(janus1, "per-instance mode, shadow vtable @ %p\n", g_shadow);
 
-    Log("[janus1] PostInit done\n");
+    LOG_INFO(janus1, "PostInit done\n");
+}
+
+typedef void (__cdecl* Janus1FactoryFn)(entvars_t* pev);
+static uintptr_t g_rvaFactory = 0;
+
+// mp.dll's weapon_janus1 (LINK_ENTITY_TO_CLASS): the original builds the
+// object, and the allocation it makes inside lands in the weapon slab.
+void __cdecl Janus1_Factory(entvars_t* pev)
+{
+    auto orig = (Janus1FactoryFn)GetOriginal(g_rvaFactory);
+    WeaponAlloc_FactoryBegin(g_def ? g_def->objSize : 0);
+    orig(pev);
+    WeaponAlloc_FactoryEnd();
 }
 
-void __cdecl Janus1_Factory(int /*edict*/) {}
+bool Janus1_Register(HMODULE hMp)
+{
+    if (g_rvaFactory) return true;
+    g_def = WeaponDb_Find(JANUS1_ID);
+    // The record, then the export the engine spawns it by, then the offset database.
+    uintptr_t rva = g_def ? g_def->factoryRva : 0;
+    if (!rva)
+        if (uintptr_t fn = (uintptr_t)GetProcAddress(hMp, "weapon_janus1")) rva = fn - (uintptr_t)hMp;
+    if (!rva) rva = Ofs_Rva(OFS_Rva_weapon_janus1);
+
+    if (!RegisterDetour(hMp, "weapon_janus1", (void*)Janus1_Factory, rva))
+    {
+        LOG_WARN(janus1, "factory not hooked, objects stay on the engine heap\n");
+        return false;
+    }
+    g_rvaFactory = rva;
+    WeaponAlloc_Require();
+    return true;
+}
@@ -3,10 +3,28 @@
 #include "../hlsdk/mp_offsets.h"
 #include <cstdint>
 
-// Object size: M79=0x1F0 (496), weapon_janus1=0x1F8 (504)
-static const int JANUS1_OBJ_SIZE = 504;
+// Field offsets: Fld<WpnF::usFireEvent>(this) etc., see hlsdk/csnz_layout.h
 
-// Field offsets are defined in sdk.h as macros (F_usFireEvent, F_iClip, etc.)
+// CSNZ weapon ID; the weapon database record (weapon_def.h) is keyed on it.
+static const uint32_t JANUS1_ID = 570;
 
-void __cdecl Janus1_Factory(int edict);
+// Mode switch (weapon_fsm.h). Shots before the signal, and how long each
+// phase lasts, when the weapon database doesn't say (weapon_def.h).
+// Sequence numbers are v_janus1.mdl's, not yet checked in game.
+static const int   JANUS1_SIGNAL_SHOTS = 5;
+static const float JANUS1_SIGNAL_TIME  = 10.0f;
+static const float JANUS1_CHANGE_TIME  = 1.5f;
+static const float JANUS1_B_TIME       = 10.0f;
+enum Janus1Anim
+{
+    JANUS1_ANIM_IDLE_SIGNAL = 7,
+    JANUS1_ANIM_CHANGE_A    = 8,
+    JANUS1_ANIM_IDLE_B      = 9,
+    JANUS1_ANIM_CHANGE_B    = 12,
+};
+
+void __cdecl Janus1_Factory(entvars_t* pev);
+// Before WeaponAlloc_Register and Hooks_Install: detours the factory and
+// looks up the weapon record. Safe to call again after a failed install.
+bool         Janus1_Register(HMODULE hMp);
 void         Janus1_PostInit(uintptr_t mpBase);
@@ -0,0 +1,181 @@
+// x86_len.cpp - IA-32 length decoder driven by two 256-entry opcode tables
+#include "x86_len.h"
+
+enum : uint8_t
+{
+    N_  = 0x00,  // opcode only
+    M_  = 0x01,  // ModRM (+ SIB / displacement)
+    I1  = 0x02,  // imm8
+    IZ  = 0x04,  // imm16/32 by operand size
+    I2  = 0x08,  // imm16
+    R1  = 0x10,  // rel8 branch
+    RZ  = 0x20,  // rel16/32 branch
+    AO  = 0x40,  // moffs16/32 by address size
+    X_  = 0x80,  // invalid, prefix or escape (handled before the lookup)
+    MI1 = M_ | I1,
+    MIZ = M_ | IZ,
+    FAR = IZ | I2,   // ptr16:32
+    ENT = I2 | I1,   // enter imm16, imm8
+};
+
+static const uint8_t g_op1[256] = {
+//   0    1    2    3    4    5    6    7    8    9    A    B    C    D    E    F
+    M_,  M_,  M_,  M_,  I1,  IZ,  N_,  N_,  M_,  M_,  M_,  M_,  I1,  IZ,  N_,  X_,  // 0
+    M_,  M_,  M_,  M_,  I1,  IZ,  N_,  N_,  M_,  M_,  M_,  M_,  I1,  IZ,  N_,  N_,  // 1
+    M_,  M_,  M_,  M_,  I1,  IZ,  X_,  N_,  M_,  M_,  M_,  M_,  I1,  IZ,  X_,  N_,  // 2
+    M_,  M_,  M_,  M_,  I1,  IZ,  X_,  N_,  M_,  M_,  M_,  M_,  I1,  IZ,  X_,  N_,  // 3
+    N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  // 4
+    N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  // 5
+    N_,  N_,  M_,  M_,  X_,  X_,  X_,  X_,  IZ,  MIZ, I1,  MI1, N_,  N_,  N_,  N_,  // 6
+    R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  R1,  // 7
+    MI1, MIZ, MI1, MI1, M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 8
+    N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  FAR, N_,  N_,  N_,  N_,  N_,  // 9
+    AO,  AO,  AO,  AO,  N_,  N_,  N_,  N_,  I1,  IZ,  N_,  N_,  N_,  N_,  N_,  N_,  // A
+    I1,  I1,  I1,  I1,  I1,  I1,  I1,  I1,  IZ,  IZ,  IZ,  IZ,  IZ,  IZ,  IZ,  IZ,  // B
+    MI1, MI1, I2,  N_,  M_,  M_,  MI1, MIZ, ENT, N_,  I2,  N_,  N_,  I1,  N_,  N_,  // C
+    M_,  M_,  M_,  M_,  I1,  I1,  N_,  N_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // D
+    R1,  R1,  R1,  R1,  I1,  I1,  I1,  I1,  RZ,  RZ,  FAR, R1,  N_,  N_,  N_,  N_,  // E
+    X_,  N_,  X_,  X_,  N_,  N_,  M_,  M_,  N_,  N_,  N_,  N_,  N_,  N_,  M_,  M_,  // F
+};
+
+static const uint8_t g_op2[256] = {
+//   0    1    2    3    4    5    6    7    8    9    A    B    C    D    E    F
+    M_,  M_,  M_,  M_,  X_,  N_,  N_,  N_,  N_,  N_,  X_,  N_,  X_,  M_,  N_,  MI1, // 0
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 1
+    M_,  M_,  M_,  M_,  X_,  X_,  X_,  X_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 2
+    N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  X_,  X_,  X_,  X_,  X_,  X_,  X_,  X_,  // 3
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 4
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 5
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 6
+    MI1, MI1, MI1, MI1, M_,  M_,  M_,  N_,  M_,  M_,  X_,  X_,  M_,  M_,  M_,  M_,  // 7
+    RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  RZ,  // 8
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // 9
+    N_,  N_,  N_,  M_,  MI1, M_,  X_,  X_,  N_,  N_,  N_,  M_,  MI1, M_,  M_,  M_,  // A
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  MI1, M_,  M_,  M_,  M_,  M_,  // B
+    M_,  M_,  MI1, M_,  MI1, MI1, MI1, M_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  N_,  // C
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // D
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // E
+    M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  M_,  // F
+};
+
+static inline bool IsPrefix(uint8_t b)
+{
+    switch (b)
+    {
+    case 0xF0: case 0xF2: case 0xF3:
+    case 0x2E: case 0x36: case 0x3E: case 0x26: case 0x64: case 0x65:
+    case 0x66: case 0x67:
+        return true;
+    }
+    return false;
+}
+
+// Bytes taken by ModRM + SIB + displacement.
+static int ModRmLen(const uint8_t* p, size_t avail, bool addr16)
+{
+    if (avail < 1) return 0;
+    uint8_t modrm = p[0], mod = modrm >> 6, rm = modrm & 7;
+    if (mod == 3) return 1;
+    if (addr16)
+    {
+        if (mod == 0) return rm == 6 ? 3 : 1;
+        return mod == 1 ? 2 : 3;
+    }
+    int n = 1;
+    if (rm == 4)
+    {
+        if (avail < 2) return 0;
+        n++;                                       // SIB
+        if (mod == 0 && (p[1] & 7) == 5) n += 4;   // no base: disp32
+    }
+    else if (mod == 0 && rm == 5) n += 4;          // [disp32]
+    if (mod == 1) n += 1;
+    if (mod == 2) n += 4;
+    return n;
+}
+
+int X86_Decode(const uint8_t* p, size_t avail, X86Insn& out)
+{
+    out = X86Insn{};
+    if (avail > 15) avail = 15;
+
+    size_t i = 0;
+    bool op16 = false, addr16 = false, repne = false;
+    while (i < avail && IsPrefix(p[i]))
+    {
+        if (p[i] == 0x66) op16 = true;
+        if (p[i] == 0x67) addr16 = true;
+        if (p[i] == 0xF2) repne = true;
+        i++;
+    }
+    if (i >= avail) return 0;
+
+    out.opOff = (uint8_t)i;
+    uint8_t op = p[i++], flags;
+    if (op == 0x0F)
+    {
+        if (i >= avail) return 0;
+        op = p[i++];
+        out.twoByte = true;
+        if (op == 0x38 || op == 0x3A)              // three-byte maps
+        {
+            if (i >= avail) return 0;
+            i++;
+            flags = op == 0x3A ? MI1 : M_;
+        }
+        else flags = g_op2[op];
+    }
+    else flags = g_op1[op];
+    out.opcode = op;
+    if (flags & X_) return 0;
+    // C4/C5/62 with a register ModRM are VEX/EVEX prefixes in 32-bit mode;
+    // AVX never shows up in code we hook, so refuse rather than guess.
+    if (!out.twoByte && (op == 0xC4 || op == 0xC5 || op == 0x62) && (i >= avail || p[i] >= 0xC0))
+        return 0;
+    // SSE4a extrq/insertq (66/F2 0F 78) carry two imm8 where vmread has none.
+    if (out.twoByte && op == 0x78 && (op16 || repne)) flags |= I2;
+
+    if (flags & M_)
+    {
+        // mov to/from CR/DR ignores mod: always a register operand.
+        bool regOnly = out.twoByte && op >= 0x20 && op <= 0x23;
+        int m = regOnly ? (i < avail) : ModRmLen(p + i, avail - i, addr16);
+        if (!m) return 0;
+        uint8_t reg = (p[i] >> 3) & 7;
+        if (!out.twoByte && ((op == 0xFE && reg > 1) || (op == 0xFF && reg == 7)))
+            return 0;                              // undefined group 4/5 encodings
+        // Group 3 TEST (F6/F7 /0 and /1) carries an immediate.
+        if (!out.twoByte && (op == 0xF6 || op == 0xF7) && reg < 2)
+            flags |= op == 0xF6 ? I1 : IZ;
+        i += m;
+    }
+
+    size_t immz = op16 ? 2 : 4;
+    if (flags & R1) { out.relOff = (uint8_t)i; out.relSize = 1;           i += 1; }
+    if (flags & RZ) { out.relOff = (uint8_t)i; out.relSize = (uint8_t)immz; i += immz; }
+    if (flags & AO) i += addr16 ? 2 : 4;
+    if (flags & I2) i += 2;
+    if (flags & IZ) i += immz;
+    if (flags & I1) i += 1;
+
+    if (i > avail) return 0;
+    out.len = (uint8_t)i;
+    return out.len;
+}
+
+bool X86_IsTerminator(const X86Insn& in, const uint8_t* p)
+{
+    if (in.twoByte) return false;
+    switch (in.opcode)
+    {
+    case 0xC2: case 0xC3: case 0xCA: case 0xCB: case 0xCF:   // ret / retf / iret
+    case 0xE9: case 0xEA: case 0xEB:                         // jmp
+        return true;
+    case 0xFF:                                               // jmp r/m (FF /4, /5)
+    {
+        uint8_t reg = (p[in.opOff + 1] >> 3) & 7;
+        return reg == 4 || reg == 5;
+    }
+    }
+    return false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+// x86_len.h - table-driven IA-32 instruction length decoder.
+// 32-bit mode only (what mp.dll is). Reports the total length and, for
+// relative branches, where the displacement sits so it can be relocated.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct X86Insn
+{
+    uint8_t len;       // total length, 0 = invalid / truncated
+    uint8_t opOff;     // offset of the opcode byte (after prefixes; the 0F for two-byte ops)
+    uint8_t opcode;    // primary opcode byte (second byte for 0F xx)
+    bool    twoByte;   // opcode came after a 0F escape
+    uint8_t relOff;    // offset of a rel8/rel32 branch displacement, 0 = none
+    uint8_t relSize;   // 1 or 4 when relOff != 0
+};
+
+// Decode one instruction from p (at most avail bytes). Returns out.len.
+int X86_Decode(const uint8_t* p, size_t avail, X86Insn& out);
+
+// Unconditional transfers after which straight-line copying must stop.
+bool X86_IsTerminator(const X86Insn& in, const uint8_t* p);
+
+// Store the rel32 that makes an instruction ending at next reach target.
+// False if it doesn't fit (only possible on 64-bit hosts; IA-32 wraps).
+inline bool X86_PutRel32(uint8_t* at, uintptr_t next, uintptr_t target)
+{
+    int64_t d = sizeof(uintptr_t) == 4 ? (int32_t)(uint32_t)(target - next)
+                                       : (int64_t)target - (int64_t)next;
+    if (d < INT32_MIN || d > INT32_MAX) return false;
+    int32_t v = (int32_t)d;
+    memcpy(at, &v, 4);
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+// bench.h - the csnz_core_bench harness.
+//
+//   BENCH(sigscan_image)
+//   {
+//       Bench_Run("128 sigs / 16 MB", [&] { Sig_ScanImage(img, defs, n, res); }, 16 << 20);
+//   }
+//
+// Bench_Run times fn over batches until BENCH_MIN_MS has passed, keeps the
+// best batch, and prints ns per call (and MB/s when bytes per call is
+// given). csnz_core_bench [filter] runs the benches whose name contains
+// filter. Not part of ctest; numbers only mean something in Release.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+typedef void (*BenchFn)();
+
+struct BenchReg
+{
+    BenchReg(const char* name, BenchFn fn);
+};
+
+#define BENCH(name)                                                       \
+    static void Bench_##name();                                           \
+    static BenchReg g_benchReg_##name(#name, Bench_##name);               \
+    static void Bench_##name()
+
+static const int BENCH_MIN_MS = 200;
+static const int BENCH_BATCHES = 5;
+
+void Bench_Report(const char* label, double nsPerCall, size_t bytesPerCall);
+
+// Keeps a result alive so the optimiser can't drop the work.
+extern volatile uint64_t g_benchSink;
+template<typename T>
+inline void Bench_Keep(T v) { g_benchSink += (uint64_t)v; }
+
+template<typename Fn>
+void Bench_Run(const char* label, Fn&& fn, size_t bytesPerCall = 0)
+{
+    typedef std::chrono::steady_clock Clock;
+    // Size a batch to roughly BENCH_MIN_MS / BENCH_BATCHES.
+    uint64_t calls = 1;
+    for (;;)
+    {
+        Clock::time_point t0 = Clock::now();
+        for (uint64_t i = 0; i < calls; i++) fn();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms >= (double)BENCH_MIN_MS / BENCH_BATCHES || calls >= (1ull << 40)) break;
+        calls *= ms < 1.0 ? 16 : 2;
+    }
+    double best = 1e300;
+    for (int b = 0; b < BENCH_BATCHES; b++)
+    {
+        Clock::time_point t0 = Clock::now();
+        for (uint64_t i = 0; i < calls; i++) fn();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (double)calls;
+        if (ns < best) best = ns;
+    }
+    Bench_Report(label, best, bytesPerCall);
+}
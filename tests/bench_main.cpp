@@ -0,0 +1,46 @@
+// bench_main.cpp - runner for csnz_core_bench
+#include "bench.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct BenchEntry
+{
+    const char* name;
+    BenchFn     fn;
+};
+
+static std::vector<BenchEntry>& Benches()
+{
+    static std::vector<BenchEntry> benches;
+    return benches;
+}
+
+volatile uint64_t g_benchSink;
+
+BenchReg::BenchReg(const char* name, BenchFn fn)
+{
+    Benches().push_back({ name, fn });
+}
+
+void Bench_Report(const char* label, double nsPerCall, size_t bytesPerCall)
+{
+    if (bytesPerCall)
+        printf("  %-44s %12.1f ns  %9.1f MB/s\n", label, nsPerCall,
+               (double)bytesPerCall / nsPerCall * 1e9 / (1024.0 * 1024.0));
+    else
+        printf("  %-44s %12.1f ns\n", label, nsPerCall);
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    for (const BenchEntry& b : Benches())
+    {
+        if (filter && !strstr(b.name, filter)) continue;
+        printf("%s\n", b.name);
+        b.fn();
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+// bench_pe_scan.cpp - pointer-run scan throughput
+#include "bench.h"
+#include "mock_engine.h"
+#include "pe_scan.h"
+
+BENCH(pe_find_pointer_run)
+{
+    // mp.dll's data sections are ~16 MB; mostly non-pointers with short
+    // false runs and the engine table near the end.
+    const size_t size = 16u << 20;
+    std::vector<uint32_t> buf(size / 4);
+    MockRng rng(1);
+    for (uint32_t& v : buf) v = rng.Below(16) ? rng.Next() : 0x03000000 + rng.Below(0x800000);
+    for (int i = 0; i < 218; i++) buf[buf.size() - 4096 + i] = 0x03000000 + 32 * i;
+
+    const uint8_t* p = (const uint8_t*)buf.data();
+    Bench_Run("16 MB, sparse", [&] { Bench_Keep(FindPointerRun(p, size, 0, 0x03000000, 0x03800000).count); }, size);
+
+    for (uint32_t& v : buf) v = 0x03000000 + rng.Below(0x800000);
+    Bench_Run("16 MB, all in range", [&] { Bench_Keep(FindPointerRun(p, size, 0, 0x03000000, 0x03800000).count); }, size);
+}
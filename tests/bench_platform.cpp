@@ -0,0 +1,21 @@
+// bench_platform.cpp - cost of the guarded reads on the frame path
+#include "bench.h"
+#include "mock_engine.h"
+#include "platform/platform.h"
+#include <cstring>
+
+BENCH(platform_safe_read)
+{
+    MockEngine& e = Mock_Engine();
+    float tf[2];
+    Bench_Run("Plat_SafeRead time+frametime", [&]
+    {
+        Plat_SafeRead(tf, (uintptr_t)e.TimePtr(), sizeof(tf));
+        Bench_Keep(tf[0] != 0.0f);
+    });
+    Bench_Run("plain load (frame clock snapshot)", [&]
+    {
+        memcpy(tf, (const void*)e.TimePtr(), sizeof(tf));
+        Bench_Keep(tf[0] != 0.0f);
+    });
+}
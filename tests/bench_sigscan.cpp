@@ -0,0 +1,38 @@
+// bench_sigscan.cpp - one-pass signature scan over a code-sized buffer
+#include "bench.h"
+#include "mock_engine.h"
+#include "sigscan.h"
+#include <cstdio>
+#include <string>
+
+BENCH(sig_scan_all)
+{
+    // Byte mix skewed towards the usual MSVC opcodes, 16 MB like mp.dll's .text.
+    static const uint8_t common[] = { 0x8B, 0x89, 0xE8, 0x00, 0xFF, 0x83, 0x85, 0x0F, 0x74, 0x75, 0x50, 0xCC };
+    const size_t size = 16u << 20;
+    std::vector<uint8_t> code(size);
+    MockRng rng(5);
+    for (uint8_t& c : code) c = rng.Below(2) ? common[rng.Below(sizeof(common))] : (uint8_t)rng.Next();
+
+    for (int n : { 8, 64 })
+    {
+        std::vector<std::string> pats(n);
+        std::vector<SigDef> defs(n);
+        for (int i = 0; i < n; i++)
+        {
+            size_t at = rng.Below((uint32_t)size - 16);
+            char buf[8];
+            for (int j = 0; j < 12; j++) { snprintf(buf, sizeof(buf), "%02X ", code[at + j]); pats[i] += buf; }
+            defs[i] = { "s", pats[i].c_str(), SIG_MATCH, 0 };
+        }
+        std::vector<SigResult> res(n);
+        char label[32];
+        snprintf(label, sizeof(label), "%d sigs / 16 MB", n);
+        Bench_Run(label, [&]
+        {
+            memset(res.data(), 0, n * sizeof(SigResult));
+            Sig_ScanAll(code.data(), size, 0, 0, defs.data(), n, res.data());
+            Bench_Keep(res[0].matches);
+        }, size);
+    }
+}
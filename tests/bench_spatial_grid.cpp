@@ -0,0 +1,104 @@
+// bench_spatial_grid.cpp - 2,000 entities: frame rebuild and explosion queries
+#include "bench.h"
+#include "mock_engine.h"
+#include "spatial_grid.h"
+#include <vector>
+
+static const int   ENTS = 2000;     // players, NPC zombies, grenades, items
+static const float MAP  = 8192.0f;  // a large zombie map, +-4096
+
+struct World
+{
+    std::vector<float> x, y, z, vx, vy;
+    int                frames = 0;
+
+    World()
+    {
+        MockRng rng(25);
+        for (int i = 0; i < ENTS; i++)
+        {
+            // Half the zombies packed round a few chokepoints, the rest
+            // anywhere on the map.
+            float cx = 0.0f, cy = 0.0f, r = MAP / 2;
+            if (i & 1) { cx = (float)(rng.Below(4) * 2048) - 3072.0f; cy = cx * 0.5f; r = 512.0f; }
+            x.push_back(cx + (rng.Unit() * 2.0f - 1.0f) * r);
+            y.push_back(cy + (rng.Unit() * 2.0f - 1.0f) * r);
+            z.push_back(rng.Unit() * 256.0f);
+            vx.push_back((rng.Unit() - 0.5f) * 8.0f);   // units per frame, ~250 u/s at 64 fps
+            vy.push_back((rng.Unit() - 0.5f) * 8.0f);
+        }
+    }
+
+    // Back and forth over a second, so the crowds stay put however long
+    // the bench runs but a share of them crosses cells every frame.
+    void Step()
+    {
+        bool turn = ++frames % 64 == 0;
+        for (int i = 0; i < ENTS; i++)
+        {
+            if (turn) { vx[i] = -vx[i]; vy[i] = -vy[i]; }
+            x[i] += vx[i];
+            y[i] += vy[i];
+        }
+    }
+};
+
+// UTIL_FindEntityInSphere's way: every edict, every time.
+static int ScanRadius(const World& w, float px, float py, float pz, float r, int* out, int max)
+{
+    int n = 0;
+    for (int i = 0; i < ENTS; i++)
+    {
+        float dx = w.x[i] - px, dy = w.y[i] - py, dz = w.z[i] - pz;
+        if (dx * dx + dy * dy + dz * dz > r * r) continue;
+        if (n < max) out[n] = i;
+        n++;
+    }
+    return n;
+}
+
+BENCH(spatial_grid_2000)
+{
+    World w;
+    SpatialGrid grid(ENTS);
+    auto frame = [&]
+    {
+        grid.BeginFrame();
+        for (int i = 0; i < ENTS; i++) grid.Update(i, w.x[i], w.y[i], w.z[i]);
+        grid.EndFrame();
+    };
+    frame();
+
+    Bench_Run("frame: move + update 2000", [&] { w.Step(); frame(); Bench_Keep(grid.Count()); });
+
+    // Explosions where the crowds are and out in the open.
+    MockRng rng(7);
+    std::vector<float> ex, ey;
+    for (int i = 0; i < 64; i++)
+    {
+        int e = (int)rng.Below(ENTS);
+        ex.push_back(w.x[e]);
+        ey.push_back(w.y[e]);
+    }
+    static int out[ENTS];
+    int total = 0, scanned = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        total   += grid.QueryRadius(ex[i], ey[i], 64.0f, 350.0f, out, ENTS);
+        scanned += ScanRadius(w, ex[i], ey[i], 64.0f, 350.0f, out, ENTS);
+    }
+    printf("  %.1f entities per 350-unit blast (grid %d, scan %d over 64 blasts)\n",
+           total / 64.0, total, scanned);
+
+    int q = 0;
+    Bench_Run("M79 blast, r=350, grid", [&] { Bench_Keep(grid.QueryRadius(ex[q & 63], ey[q & 63], 64.0f, 350.0f, out, ENTS)); q++; });
+    Bench_Run("M79 blast, r=350, linear scan", [&] { Bench_Keep(ScanRadius(w, ex[q & 63], ey[q & 63], 64.0f, 350.0f, out, ENTS)); q++; });
+    Bench_Run("small AoE, r=96, grid", [&] { Bench_Keep(grid.QueryRadius(ex[q & 63], ey[q & 63], 64.0f, 96.0f, out, ENTS)); q++; });
+    Bench_Run("box 512x512x256, grid", [&]
+    {
+        float mins[3] = { ex[q & 63] - 256.0f, ey[q & 63] - 256.0f, 0.0f };
+        float maxs[3] = { ex[q & 63] + 256.0f, ey[q & 63] + 256.0f, 256.0f };
+        Bench_Keep(grid.QueryBox(mins, maxs, out, ENTS));
+        q++;
+    });
+}
@@ -0,0 +1,28 @@
+// bench_spread.cpp - spread offsets and directions, AVX2/SSE2 against scalar
+#include "bench.h"
+#include "spread.h"
+
+BENCH(spread_volley)
+{
+    float x[32], y[32], z[32];
+    uint32_t seed = 1;
+    Bench_Run("8 pellets, offsets", [&] { Spread_Offsets(seed++, 0, 8, x, y); Bench_Keep(x[7]); });
+    Bench_Run("8 pellets, offsets, scalar", [&] { Spread_OffsetsScalar(seed++, 0, 8, x, y); Bench_Keep(x[7]); });
+    Bench_Run("16 pellets, offsets", [&] { Spread_Offsets(seed++, 0, 16, x, y); Bench_Keep(x[15]); });
+    Bench_Run("16 pellets, offsets, scalar", [&] { Spread_OffsetsScalar(seed++, 0, 16, x, y); Bench_Keep(x[15]); });
+
+    SpreadParams p = { 0.6f, 0.8f, 0.0f, 0.8f, -0.6f, 0.0f, 0.0f, 0.0f, 1.0f,
+                       0.0436f, 0.0218f, 0, 0 };
+    Bench_Run("16 pellets, directions", [&] { p.seed++; Spread_Directions(p, 16, x, y, z); Bench_Keep(z[15]); });
+}
+
+BENCH(spread_throughput)
+{
+    static float x[4096], y[4096];
+    uint32_t seed = 1;
+    // Output bytes per call, two floats a pellet.
+    Bench_Run("4096 pellets", [&] { Spread_Offsets(seed++, 0, 4096, x, y); Bench_Keep(y[4095]); },
+              4096 * 2 * sizeof(float));
+    Bench_Run("4096 pellets, scalar", [&] { Spread_OffsetsScalar(seed++, 0, 4096, x, y); Bench_Keep(y[4095]); },
+              4096 * 2 * sizeof(float));
+}
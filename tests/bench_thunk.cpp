@@ -0,0 +1,60 @@
+// bench_thunk.cpp - pre-hook thunk against the wrapper it replaced
+#include "bench.h"
+#include "stub_arena.h"
+#include "thunk.h"
+#include <cstdio>
+
+// The thunk is IA-32 code, but push/pop ecx and E8/E9 rel32 encode the
+// same on x86-64 (as push/pop rcx), and the extra push keeps the SysV
+// stack aligned at the call to pre, so it runs on either host.
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+
+static volatile int g_preCalls;
+
+static void Pre(void*)               { g_preCalls = g_preCalls + 1; }
+static int  Orig(void* self, int x)  { return *(const int*)self + x; }
+
+typedef int (*SlotFn)(void* self, int x);
+
+// What a hook looked like before thunks: a C++ wrapper frame, a global
+// load of the original and an indirect call.
+static SlotFn volatile g_orig = &Orig;
+static int Wrapper(void* self, int x)
+{
+    Pre(self);
+    return g_orig(self, x);
+}
+
+BENCH(thunk_pre_call)
+{
+    StubArena arena(Stub_ProcessPages());
+    Thunk_SetArena(&arena, (uintptr_t)&Orig, (uintptr_t)&Orig + 1);
+    void* thunk = Thunk_MakePre((void*)&Pre, (void*)&Orig);
+    if (!thunk)
+    {
+        printf("  no stub within rel32 of the binary, skipped\n");
+        return;
+    }
+
+    int obj = 1;
+    SlotFn volatile direct  = &Orig;
+    SlotFn volatile wrapped = &Wrapper;
+    SlotFn volatile thunked = (SlotFn)thunk;
+    Bench_Run("original, no hook", [&] { Bench_Keep(direct(&obj, 2)); });
+    Bench_Run("C++ wrapper + global orig", [&] { Bench_Keep(wrapped(&obj, 2)); });
+    Bench_Run("generated pre thunk", [&] { Bench_Keep(thunked(&obj, 2)); });
+
+    uint8_t buf[THUNK_PRE_SIZE];
+    Bench_Run("Thunk_EncodePre", [&]
+    {
+        Bench_Keep(Thunk_EncodePre(buf, sizeof(buf), (uintptr_t)buf, (uintptr_t)&Pre, (uintptr_t)&Orig));
+    });
+    Bench_Run("Thunk_MakePre + free", [&]
+    {
+        void* t = Thunk_MakePre((void*)&Pre, (void*)&Orig);
+        arena.Free(t);
+    });
+    Thunk_SetArena(nullptr, 0, 0);
+}
+
+#endif
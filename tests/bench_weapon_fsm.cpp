@@ -0,0 +1,67 @@
+// bench_weapon_fsm.cpp - one server frame of mode tracking for every holder
+#include "bench.h"
+#include "mock_engine.h"
+#include "hlsdk/csnz_layout.h"
+#include "weapon_fsm.h"
+#include <vector>
+
+#define BJANUS_STATES(S)                                                      \
+    S(Normal,  -1, 0.0f)                                                      \
+    S(Signal,   7, 10.0f)                                                     \
+    S(ChangeA,  8, 1.5f)                                                      \
+    S(ModeB,    9, 10.0f)                                                     \
+    S(ChangeB, 12, 1.5f)
+#define BJANUS_TRANS(T)                                                       \
+    T(Normal,  Signal,  WIN_CHARGED, WIN_CHARGED)                             \
+    T(Signal,  ChangeA, WIN_ATTACK2, WIN_ATTACK2)                             \
+    T(Signal,  Normal,  WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ChangeA, ModeB,   WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ModeB,   ChangeB, WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ChangeB, Normal,  WIN_TIMEOUT, WIN_TIMEOUT)
+WFSM_DEFINE(BJanus, BJANUS_STATES, BJANUS_TRANS)
+
+static const int HOLDERS = 64;   // 32 players, bots, a full zombie round
+
+BENCH(weapon_fsm_frame)
+{
+    MockEngine& eng = Mock_Engine();
+    eng.Reset(1.0f);
+    static MockWeaponClass cls(2, "CJanus1");
+    WfsmTable t;
+    Wfsm_Build(BJanus_Def, t);
+
+    // Spread the holders over every state so each tick takes a different
+    // path through the table.
+    std::vector<MockWeapon> ws(HOLDERS, MockWeapon(cls));
+    std::vector<WfsmInst>   in(HOLDERS);
+    MockRng rng(5);
+    for (int i = 0; i < HOLDERS; i++)
+    {
+        Wfsm_Enter(t, in[i], (int)rng.Below(BJanus_Fsm::COUNT), eng.Time() - rng.Unit() * 10.0f);
+        Fld<WpnF::iShotCount>(&ws[i]) = (int)rng.Below(8);
+    }
+
+    Bench_Run("64 holders, sample + tick", [&]
+    {
+        eng.Advance(1.0f / 64.0f);
+        float now = eng.Time();
+        int changed = 0;
+        // Offsets once per frame, not per holder: Wfsm_Tick stores in between.
+        int shots = Fld_Offset<WpnF::iShotCount>(), next2 = Fld_Offset<WpnF::flNextSecondary>();
+        for (int i = 0; i < HOLDERS; i++)
+        {
+            void* w = &ws[i];
+            uint32_t bits = (Fld<WpnF::iShotCount>(w, shots) >= 5 ? WIN_CHARGED : 0)
+                          | (Fld<WpnF::flNextSecondary>(w, next2) > now ? WIN_ATTACK2 : 0);
+            changed += Wfsm_Tick(t, in[i], bits, now) >= 0;
+        }
+        Bench_Keep(changed);
+    });
+
+    WfsmInst one = {};
+    Wfsm_Enter(t, one, BJanus_Fsm::ModeB, eng.Time());
+    Bench_Run("one tick, no transition", [&]
+    {
+        Bench_Keep(Wfsm_Tick(t, one, 0, 2.0f));
+    });
+}
@@ -0,0 +1,79 @@
+// bench_weapon_slab.cpp - weapon spawn/free churn, slab against the heap
+#include "bench.h"
+#include "mock_engine.h"
+#include "weapon_slab.h"
+#include <cstdlib>
+#include <vector>
+
+// Private data sizes of a few stock weapon classes (M79, Janus-1, rifles,
+// pistols), so several size classes are live at once.
+static const size_t g_sizes[] = { 0x1F0, 0x1F8, 0x1C0, 0x1A0, 0x180, 0x240 };
+static const int    LIVE      = 512;   // weapons on the ground and in hands
+static const int    STEPS     = 256;   // spawn/free pairs per call
+
+struct Churn
+{
+    std::vector<void*>    live = std::vector<void*>(LIVE);
+    std::vector<uint32_t> picks;
+
+    Churn()
+    {
+        MockRng rng(11);
+        for (int i = 0; i < STEPS * 2; i++) picks.push_back(rng.Next());
+    }
+
+    // One round: free a random victim, spawn a weapon of a random class in
+    // its place, and touch it the way a constructor would.
+    template<typename AllocFn, typename FreeFn>
+    void Run(AllocFn&& alloc, FreeFn&& release)
+    {
+        for (int s = 0; s < STEPS; s++)
+        {
+            uint32_t v = picks[s * 2] % LIVE;
+            size_t   n = g_sizes[picks[s * 2 + 1] % (sizeof(g_sizes) / sizeof(g_sizes[0]))];
+            release(live[v]);
+            live[v] = alloc(n);
+            ((uint8_t*)live[v])[n - 1] = 1;
+        }
+    }
+};
+
+BENCH(weapon_slab_churn)
+{
+    {
+        WeaponSlab slab;
+        Churn c;
+        for (int i = 0; i < LIVE; i++) c.live[i] = slab.Alloc(g_sizes[i % 6]);
+        Bench_Run("slab, 256 spawn/free of 512 live", [&]
+        {
+            c.Run([&](size_t n) { return slab.Alloc(n); }, [&](void* p) { slab.Free(p); });
+        });
+        Bench_Keep(slab.Chunks());
+    }
+    {
+        Churn c;
+        for (int i = 0; i < LIVE; i++) c.live[i] = calloc(1, g_sizes[i % 6]);
+        Bench_Run("calloc/free, same churn", [&]
+        {
+            c.Run([&](size_t n) { return calloc(1, n); }, [&](void* p) { free(p); });
+        });
+        for (void* p : c.live) free(p);
+    }
+}
+
+BENCH(weapon_slab_map_change)
+{
+    // Spawn a map's worth of weapons, then drop them all at the level change.
+    std::vector<void*> objs(LIVE);
+    Bench_Run("slab, 512 spawns + ReleaseAll", [&]
+    {
+        WeaponSlab slab;
+        for (int i = 0; i < LIVE; i++) objs[i] = slab.Alloc(g_sizes[i % 6]);
+        slab.ReleaseAll();
+    });
+    Bench_Run("calloc, 512 spawns + 512 frees", [&]
+    {
+        for (int i = 0; i < LIVE; i++) objs[i] = calloc(1, g_sizes[i % 6]);
+        for (void* p : objs) free(p);
+    });
+}
@@ -0,0 +1,66 @@
+// bench_x86_len.cpp - length decoder throughput and prologue relocation
+#include "bench.h"
+#include "mock_engine.h"
+#include "trampoline.h"
+#include "x86_len.h"
+#include <cstdio>
+#include <vector>
+
+// A stream of instructions the decoder accepts: random candidates with a
+// bias towards the usual MSVC opcodes, kept whole when they decode.
+static std::vector<uint8_t> InsnStream(size_t size, int& count)
+{
+    static const uint8_t common[] = { 0x8B, 0x89, 0xE8, 0xFF, 0x83, 0x85, 0x0F, 0x74, 0x75, 0x50,
+                                      0x55, 0x8D, 0xC7, 0x33, 0x3B, 0xE9, 0xEB, 0x6A, 0x68, 0xC3 };
+    std::vector<uint8_t> out;
+    out.reserve(size + 15);
+    MockRng rng(3);
+    count = 0;
+    while (out.size() < size)
+    {
+        uint8_t c[15];
+        rng.Fill(c, sizeof(c));
+        if (rng.Below(4)) c[0] = common[rng.Below(sizeof(common))];
+        X86Insn in;
+        int len = X86_Decode(c, sizeof(c), in);
+        if (!len) continue;
+        out.insert(out.end(), c, c + len);
+        count++;
+    }
+    return out;
+}
+
+BENCH(x86_decode_stream)
+{
+    int count;
+    std::vector<uint8_t> code = InsnStream(4u << 20, count);
+    const uint8_t* p = code.data();
+    size_t size = code.size();
+    Bench_Run("4 MB linear sweep", [&]
+    {
+        int n = 0;
+        X86Insn in;
+        for (size_t at = 0; at < size; n++)
+        {
+            int len = X86_Decode(p + at, size - at, in);
+            at += len ? len : 1;
+        }
+        Bench_Keep(n);
+    }, size);
+    printf("  (%d instructions, %.2f bytes each)\n", count, (double)size / count);
+}
+
+BENCH(x86_tramp_build)
+{
+    // mov edi,edi / push ebp / mov ebp,esp / sub esp,imm32 / jne rel8: the
+    // short branch has to be widened.
+    static const uint8_t prologue[] = { 0x8B, 0xFF, 0x55, 0x8B, 0xEC, 0x75, 0x10,
+                                        0x81, 0xEC, 0x00, 0x01, 0x00, 0x00, 0x90, 0x90, 0x90 };
+    uint8_t out[TRAMP_MAX_SIZE];
+    Bench_Run("7-byte prologue, rel8 widened", [&]
+    {
+        size_t stolen, size;
+        Bench_Keep(Tramp_Build(prologue, sizeof(prologue), 0x10001000, 7,
+                               out, sizeof(out), 0x20000000, stolen, size) + size);
+    });
+}
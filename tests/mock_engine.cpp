@@ -0,0 +1,179 @@
+// mock_engine.cpp - fake engine, weapon vtables and PE images for the tests
+#include "mock_engine.h"
+#include <cstring>
+#include <utility>
+
+// -------------------------------------------------------------------------
+// Engine
+// -------------------------------------------------------------------------
+static int Mock_PrecacheModel(const char* s)
+{
+    MockEngine& e = Mock_Engine();
+    e.models.push_back(s);
+    return (int)e.models.size();
+}
+
+static int Mock_PrecacheSound(const char* s)
+{
+    MockEngine& e = Mock_Engine();
+    e.sounds.push_back(s);
+    return (int)e.sounds.size();
+}
+
+static unsigned short Mock_PrecacheEvent(int, const char* s)
+{
+    MockEngine& e = Mock_Engine();
+    e.events.push_back(s);
+    return (unsigned short)e.events.size();
+}
+
+static void Mock_SetModel(edict_t*, const char*)
+{
+    Mock_Engine().setModels++;
+}
+
+void MockEngine::Reset(float t)
+{
+    funcs = {};
+    funcs.pfnPrecacheModel = Mock_PrecacheModel;
+    funcs.pfnPrecacheSound = Mock_PrecacheSound;
+    funcs.pfnSetModel      = Mock_SetModel;
+    funcs.pfnPrecacheEvent = Mock_PrecacheEvent;
+    globals = {};
+    globals.time = t;
+    models.clear();
+    sounds.clear();
+    events.clear();
+    setModels = 0;
+}
+
+MockEngine& Mock_Engine()
+{
+    static MockEngine e;
+    static bool init = (e.Reset(), true);
+    (void)init;
+    return e;
+}
+
+// -------------------------------------------------------------------------
+// Weapon classes
+// -------------------------------------------------------------------------
+template<int Cls, int Slot>
+static int Mock_Slot(void*) { return MockSlotValue(Cls, Slot); }
+
+template<int Cls, size_t... Slot>
+static const MockSlotFn* Mock_SlotTable(std::index_sequence<Slot...>)
+{
+    static const MockSlotFn table[] = { &Mock_Slot<Cls, (int)Slot>... };
+    return table;
+}
+
+static const MockSlotFn* Mock_Slots(int cls)
+{
+    typedef std::make_index_sequence<WEAPON_VTABLE_SLOTS> All;
+    static const MockSlotFn* tables[MOCK_CLASSES] = {
+        Mock_SlotTable<0>(All()), Mock_SlotTable<1>(All()),
+        Mock_SlotTable<2>(All()), Mock_SlotTable<3>(All()),
+    };
+    return tables[cls];
+}
+
+MockWeaponClass::MockWeaponClass(int id_, const char* name_, const MockWeaponClass* base,
+                                 const int* overrides, int nOverrides)
+    : name(name_), id(id_)
+{
+    const MockSlotFn* own = Mock_Slots(id);
+    words[0] = (void*)this;                   // stands in for the RTTI locator
+    for (int s = 0; s < WEAPON_VTABLE_SLOTS; s++)
+        words[1 + s] = base ? base->words[1 + s] : (void*)own[s];
+    for (int i = 0; i < nOverrides; i++)
+        words[1 + overrides[i]] = (void*)own[overrides[i]];
+}
+
+// -------------------------------------------------------------------------
+// PE image
+// -------------------------------------------------------------------------
+static const uint32_t PE_HEADERS   = 0x1000;
+static const uint32_t PE_SECT_ALIGN = 0x1000;
+static const uint32_t PE_FILE_ALIGN = 0x200;
+static const uint32_t PE_LFANEW    = 0x80;
+static const uint16_t PE_OPT_LEN   = 0xE0;
+
+static uint32_t AlignUp(uint32_t v, uint32_t a) { return (v + a - 1) & ~(a - 1); }
+
+template<typename T>
+static void PutLE(uint8_t* p, T v) { memcpy(p, &v, sizeof(T)); }
+
+MockPe::MockPe(uint32_t imageBase, uint32_t timeDateStamp, uint32_t checkSum)
+    : m_image(PE_HEADERS), m_imageBase(imageBase), m_timeDateStamp(timeDateStamp),
+      m_checkSum(checkSum)
+{
+    WriteHeaders();
+}
+
+uint32_t MockPe::AddSection(const char* name, uint32_t size, uint32_t flags)
+{
+    Sec s = {};
+    // IMAGE_SECTION_HEADER::Name: NUL-padded, no terminator at full length.
+    size_t len = strlen(name);
+    memcpy(s.name, name, len < sizeof(s.name) ? len : sizeof(s.name));
+    s.rva     = (uint32_t)m_image.size();
+    s.size    = size;
+    s.rawOff  = m_secs.empty() ? PE_FILE_ALIGN * 2 : m_secs.back().rawOff + m_secs.back().rawSize;
+    s.rawSize = (flags & 0x80) ? 0 : AlignUp(size, PE_FILE_ALIGN);
+    s.flags   = flags;
+    m_secs.push_back(s);
+    m_image.resize(s.rva + AlignUp(size ? size : 1, PE_SECT_ALIGN));
+    WriteHeaders();
+    return s.rva;
+}
+
+void MockPe::WriteHeaders()
+{
+    uint8_t* p = m_image.data();
+    memset(p, 0, PE_HEADERS);
+    p[0] = 'M'; p[1] = 'Z';
+    PutLE<uint32_t>(p + 0x3C, PE_LFANEW);
+
+    uint8_t* nt = p + PE_LFANEW;
+    PutLE<uint32_t>(nt, 0x00004550);                      // "PE\0\0"
+    PutLE<uint16_t>(nt + 4, 0x014C);                      // i386
+    PutLE<uint16_t>(nt + 6, (uint16_t)m_secs.size());
+    PutLE<uint32_t>(nt + 8, m_timeDateStamp);
+    PutLE<uint16_t>(nt + 20, PE_OPT_LEN);
+    PutLE<uint16_t>(nt + 22, 0x2102);                     // executable, 32-bit, DLL
+
+    uint8_t* opt = nt + 24;
+    PutLE<uint16_t>(opt, 0x10B);                          // PE32
+    PutLE<uint32_t>(opt + 28, m_imageBase);
+    PutLE<uint32_t>(opt + 32, PE_SECT_ALIGN);
+    PutLE<uint32_t>(opt + 36, PE_FILE_ALIGN);
+    PutLE<uint32_t>(opt + 56, (uint32_t)m_image.size()); // SizeOfImage
+    PutLE<uint32_t>(opt + 60, PE_FILE_ALIGN * 2);         // SizeOfHeaders
+    PutLE<uint32_t>(opt + 64, m_checkSum);
+
+    uint8_t* sh = opt + PE_OPT_LEN;
+    for (const Sec& s : m_secs)
+    {
+        memcpy(sh, s.name, 8);
+        PutLE<uint32_t>(sh + 8,  s.size);
+        PutLE<uint32_t>(sh + 12, s.rva);
+        PutLE<uint32_t>(sh + 16, s.rawSize);
+        PutLE<uint32_t>(sh + 20, s.rawOff);
+        PutLE<uint32_t>(sh + 36, s.flags);
+        sh += 40;
+    }
+}
+
+std::vector<uint8_t> MockPe::FileImage() const
+{
+    uint32_t end = PE_FILE_ALIGN * 2;
+    for (const Sec& s : m_secs) if (s.rawOff + s.rawSize > end) end = s.rawOff + s.rawSize;
+    std::vector<uint8_t> file(end);
+    memcpy(file.data(), m_image.data(), PE_FILE_ALIGN * 2);
+    for (const Sec& s : m_secs)
+        if (s.rawSize)
+            memcpy(file.data() + s.rawOff, m_image.data() + s.rva,
+                   s.rawSize < s.size ? s.rawSize : s.size);
+    return file;
+}
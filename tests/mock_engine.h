@@ -0,0 +1,137 @@
+#pragma once
+// mock_engine.h - stand-ins for hw.dll / mp.dll, so csnz_core runs under
+// test on any host:
+//   Mock_Engine()    enginefuncs_t that records every precache, and the
+//                    head of globalvars_t as a clock the test advances
+//   MockWeaponClass  a fake weapon vtable: WEAPON_VTABLE_SLOTS callable
+//                    slots plus an RTTI word at [-1], optionally derived
+//                    from another class with some slots overridden
+//   MockWeapon       an object of such a class, large enough for every
+//                    WpnF field
+//   MockPe           a synthetic PE32 image for the scanners and caches
+//   MockRng          deterministic data for tests and benches
+
+#include "hlsdk/engine_types.h"
+#include "hlsdk/mp_offsets.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// Engine
+// -------------------------------------------------------------------------
+struct MockEngine
+{
+    enginefuncs_t            funcs;
+    globalvars_head_t        globals;
+    std::vector<std::string> models;      // precache order
+    std::vector<std::string> sounds;
+    std::vector<std::string> events;
+    int                      setModels;   // pfnSetModel calls
+
+    // Clear the records and put the clock back to t.
+    void   Reset(float t = 1.0f);
+    void   Advance(float dt) { globals.frametime = dt; globals.time += dt; }
+    float  Time() const      { return globals.time; }
+    // What g_pTime points at in the game (&gpGlobals->time).
+    float* TimePtr()         { return &globals.time; }
+};
+
+MockEngine& Mock_Engine();
+
+// -------------------------------------------------------------------------
+// Weapon classes. Slot s of class c returns MockSlotValue(c, s), so a test
+// can tell from a call which implementation ran.
+// -------------------------------------------------------------------------
+static const int MOCK_CLASSES = 4;
+
+typedef int (*MockSlotFn)(void* self);
+
+inline int MockSlotValue(int cls, int slot) { return cls * 1000 + slot; }
+
+struct MockWeaponClass
+{
+    const char* name;
+    int         id;
+    void*       words[1 + WEAPON_VTABLE_SLOTS];   // [0] = RTTI locator
+
+    // id in [0, MOCK_CLASSES). With a base, copy its table and give only
+    // the listed slots this class's own functions.
+    MockWeaponClass(int id, const char* name, const MockWeaponClass* base = nullptr,
+                    const int* overrides = nullptr, int nOverrides = 0);
+
+    void** Vtable() { return words + 1; }
+};
+
+static const size_t MOCK_WEAPON_SIZE = 0x200;   // past the last WpnF field
+
+struct alignas(16) MockWeapon
+{
+    void**  vptr;
+    uint8_t body[MOCK_WEAPON_SIZE - sizeof(void*)];
+
+    explicit MockWeapon(MockWeaponClass& c) : vptr(c.Vtable()) { memset(body, 0, sizeof(body)); }
+};
+
+// Call slot through obj's current vtable, the way the engine would.
+inline int Mock_CallSlot(void* obj, int slot)
+{
+    void** vt = *(void***)obj;
+    return ((MockSlotFn)vt[slot])(obj);
+}
+
+// -------------------------------------------------------------------------
+// PE32 image, built in mapped layout (section i at its rva).
+// -------------------------------------------------------------------------
+static const uint32_t MOCK_SCN_TEXT  = 0x60000020;   // code, execute, read
+static const uint32_t MOCK_SCN_RDATA = 0x40000040;   // initialized, read
+static const uint32_t MOCK_SCN_DATA  = 0xC0000040;   // initialized, read, write
+static const uint32_t MOCK_SCN_BSS   = 0xC0000080;   // uninitialized
+
+class MockPe
+{
+public:
+    MockPe(uint32_t imageBase = 0x10000000, uint32_t timeDateStamp = 0x5F3A1B2C,
+           uint32_t checkSum = 0x01E2D4A1);
+
+    // Appends a section of size bytes (zeroed) and returns its rva.
+    uint32_t AddSection(const char* name, uint32_t size, uint32_t flags);
+
+    uint8_t*       At(uint32_t rva)           { return m_image.data() + rva; }
+    const uint8_t* Data() const               { return m_image.data(); }
+    size_t         Size() const               { return m_image.size(); }
+    uint32_t       ImageBase() const          { return m_imageBase; }
+    void           Put32(uint32_t rva, uint32_t v) { memcpy(At(rva), &v, 4); }
+    void           Put(uint32_t rva, const void* p, size_t n) { memcpy(At(rva), p, n); }
+
+    // The same image in file layout (sections at their raw offsets).
+    std::vector<uint8_t> FileImage() const;
+
+private:
+    void WriteHeaders();
+
+    struct Sec { char name[8]; uint32_t rva, size, rawOff, rawSize, flags; };
+    std::vector<uint8_t> m_image;
+    std::vector<Sec>     m_secs;
+    uint32_t             m_imageBase, m_timeDateStamp, m_checkSum;
+};
+
+// -------------------------------------------------------------------------
+// xorshift32: the same stream on every host and compiler.
+// -------------------------------------------------------------------------
+struct MockRng
+{
+    uint32_t s;
+
+    explicit MockRng(uint32_t seed = 0x2545F491) : s(seed ? seed : 1) {}
+    uint32_t Next()             { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+    uint32_t Below(uint32_t n)  { return (uint32_t)(((uint64_t)Next() * n) >> 32); }
+    float    Unit()             { return (float)(Next() >> 8) * (1.0f / 16777216.0f); }   // [0, 1)
+    void     Fill(void* p, size_t n)
+    {
+        uint8_t* b = (uint8_t*)p;
+        for (size_t i = 0; i < n; i++) b[i] = (uint8_t)(Next() >> 24);
+    }
+};
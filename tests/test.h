@@ -0,0 +1,45 @@
+#pragma once
+// test.h - the csnz_core_tests harness.
+// A test is a function registered at static-init time:
+//
+//   TEST(patch_commit_one_flip_per_page)
+//   {
+//       CHECK(batch.Commit(mem));
+//       CHECK_EQ(mem.flips, 1);
+//   }
+//
+// A failed CHECK logs file:line and the expression and the test keeps
+// going. csnz_core_tests [filter] runs every test whose name contains
+// filter, in a scratch directory under the system temp dir; the exit code
+// is the number of failed tests.
+
+#include <cstdint>
+
+typedef void (*TestFn)();
+
+struct TestReg
+{
+    TestReg(const char* name, TestFn fn);
+};
+
+void Test_Fail(const char* file, int line, const char* expr);
+void Test_FailEq(const char* file, int line, const char* a, const char* b,
+                 long long va, long long vb);
+
+#define TEST(name)                                                        \
+    static void Test_##name();                                            \
+    static TestReg g_testReg_##name(#name, Test_##name);                  \
+    static void Test_##name()
+
+#define CHECK(expr)                                                       \
+    do { if (!(expr)) Test_Fail(__FILE__, __LINE__, #expr); } while (0)
+
+// Integers (and enums/pointers cast by the caller); prints both values.
+#define CHECK_EQ(a, b)                                                    \
+    do {                                                                  \
+        long long va_ = (long long)(a), vb_ = (long long)(b);             \
+        if (va_ != vb_) Test_FailEq(__FILE__, __LINE__, #a, #b, va_, vb_); \
+    } while (0)
+
+// Path for a scratch file of the given name (in the working directory).
+const char* Test_TempPath(const char* name);
@@ -0,0 +1,172 @@
+// test_addr_cache.cpp - cache keying and persistence over synthetic PE headers
+#include "test.h"
+#include "mock_engine.h"
+#include "addr_cache.h"
+#include "offset_db.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static PeKey KeyOf(const MockPe& pe)
+{
+    PeImage img;
+    CHECK(Pe_Parse(pe.Data(), pe.Size(), true, img));
+    return PeKey_From(img);
+}
+
+static std::string ReadFile(const char* path)
+{
+    std::string s;
+    if (FILE* f = fopen(path, "r"))
+    {
+        char buf[256];
+        for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0; ) s.append(buf, n);
+        fclose(f);
+    }
+    return s;
+}
+
+TEST(addr_cache_key_from_pe_headers)
+{
+    MockPe mp(0x10000000, 0x5F3A1B2C, 0x01E2D4A1);
+    mp.AddSection(".text", 0x3000, MOCK_SCN_TEXT);
+    PeKey k = KeyOf(mp);
+    CHECK_EQ(k.timeDateStamp, 0x5F3A1B2C);
+    CHECK_EQ(k.checkSum, 0x01E2D4A1);
+    CHECK_EQ(k.sizeOfImage, 0x4000);
+}
+
+TEST(addr_cache_warm_only_on_matching_keys)
+{
+    MockPe mp(0x10000000, 0x5F3A1B2C, 0x01E2D4A1), hw(0x01D00000, 0x4A000001, 0x00123456);
+    mp.AddSection(".text", 0x3000, MOCK_SCN_TEXT);
+    hw.AddSection(".text", 0x8000, MOCK_SCN_TEXT);
+    PeKey kmp = KeyOf(mp), khw = KeyOf(hw);
+    const char* path = Test_TempPath("addr.cache");
+    remove(path);
+
+    CHECK(!AddrCache_Open(path, "ofs-1", kmp, khw));   // no file: cold
+    AddrCache_Put("weapon_janus1", 0x0E96640);
+    AddrCache_Put("engfuncs", 0x1E40000);
+    CHECK(AddrCache_Save());
+
+    CHECK(AddrCache_Open(path, "ofs-1", kmp, khw));
+    uint32_t rva = 0;
+    CHECK(AddrCache_Get("engfuncs", rva));
+    CHECK_EQ(rva, 0x1E40000);
+    CHECK(AddrCache_Get("weapon_janus1", rva));
+    CHECK_EQ(rva, 0x0E96640);
+
+    // Any key difference is a cold start with an empty cache.
+    CHECK(!AddrCache_Open(path, "ofs-2", kmp, khw));
+    CHECK(!AddrCache_Get("engfuncs", rva));
+    CHECK(!AddrCache_Open(path, "ofs-", kmp, khw));     // prefix of the stored build
+    CHECK(!AddrCache_Open(path, "ofs-12", kmp, khw));   // stored build is a prefix
+
+    PeKey k = kmp; k.checkSum++;
+    CHECK(!AddrCache_Open(path, "ofs-1", k, khw));
+    k = kmp; k.timeDateStamp++;
+    CHECK(!AddrCache_Open(path, "ofs-1", k, khw));
+    MockPe hw2(0x01D00000, 0x4A000001, 0x00123456);
+    hw2.AddSection(".text", 0x9000, MOCK_SCN_TEXT);     // SizeOfImage moved
+    CHECK(!AddrCache_Open(path, "ofs-1", kmp, KeyOf(hw2)));
+    remove(path);
+}
+
+TEST(addr_cache_get_or_never_stores_fallback)
+{
+    MockPe mp, hw(0x01D00000);
+    mp.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    hw.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    const char* path = Test_TempPath("addr_fallback.cache");
+    remove(path);
+
+    AddrCache_Open(path, "ofs-1", KeyOf(mp), KeyOf(hw));
+    AddrCache_Put("pGlobals", 0x1E51BCC);
+    CHECK_EQ(AddrCache_GetOr("pGlobals", 0x1234), 0x1E51BCC);
+    CHECK_EQ(AddrCache_GetOr("CJanus1_vtable", 0x1649034), 0x1649034);
+    uint32_t rva = 0;
+    CHECK(!AddrCache_Get("CJanus1_vtable", rva));
+    CHECK(AddrCache_Save());
+
+    std::string text = ReadFile(path);
+    CHECK(text.find("pGlobals 01E51BCC") != std::string::npos);
+    CHECK(text.find("CJanus1_vtable") == std::string::npos);
+    remove(path);
+}
+
+TEST(addr_cache_put_and_save)
+{
+    MockPe mp, hw(0x01D00000);
+    mp.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    hw.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    const char* path = Test_TempPath("addr_put.cache");
+    remove(path);
+
+    AddrCache_Open(path, "b", KeyOf(mp), KeyOf(hw));
+    AddrCache_Put("a", 1);
+    AddrCache_Put("a", 2);                                       // replaces
+    AddrCache_Put("a_name_that_is_far_too_long_for_the_cache", 3);   // dropped
+    CHECK(AddrCache_Save());
+    CHECK(AddrCache_Open(path, "b", KeyOf(mp), KeyOf(hw)));
+    uint32_t rva = 0;
+    CHECK(AddrCache_Get("a", rva));
+    CHECK_EQ(rva, 2);
+    CHECK(!AddrCache_Get("a_name_that_is_far_too_long_for_the_cache", rva));
+
+    // A warm cache with no changes isn't rewritten.
+    remove(path);
+    CHECK(AddrCache_Save());
+    CHECK(ReadFile(path).empty());
+}
+
+TEST(offset_db_defaults_hash)
+{
+    uint32_t h = OffsetDb_DefaultsHash();
+    CHECK_EQ(h, OffsetDb_DefaultsHash());
+    CHECK(h != ADDR_CACHE_HASH0);
+    // Overrides are per mp.dll build and don't move the key.
+    int32_t saved = g_offsets[OFS_Rva_pGlobals];
+    g_offsets[OFS_Rva_pGlobals] += 4;
+    CHECK_EQ(OffsetDb_DefaultsHash(), h);
+    g_offsets[OFS_Rva_pGlobals] = saved;
+
+    CHECK_EQ(AddrCache_Hash(ADDR_CACHE_HASH0, "", 0), ADDR_CACHE_HASH0);
+    CHECK_EQ(AddrCache_Hash(ADDR_CACHE_HASH0, "a", 1), 0xE40C292C);   // FNV-1a test vector
+}
+
+TEST(addr_cache_overrides_are_never_saved)
+{
+    MockPe mp, hw(0x01D00000);
+    mp.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    hw.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    const char* path = Test_TempPath("addr_override.cache");
+    remove(path);
+
+    // Cold start: scanned, then overridden from csnz_offsets.txt.
+    AddrCache_Open(path, "b", KeyOf(mp), KeyOf(hw));
+    AddrCache_Put("pGlobals", 0x1000);
+    AddrCache_Override("pGlobals", 0x2000);
+    AddrCache_Override("CJanus1_vtable", 0x3000);
+    CHECK_EQ(AddrCache_GetOr("pGlobals", 0), 0x2000);
+    CHECK_EQ(AddrCache_GetOr("CJanus1_vtable", 0), 0x3000);
+    AddrCache_Put("pGlobals", 0x1100);                   // a rescan doesn't beat it
+    CHECK_EQ(AddrCache_GetOr("pGlobals", 0), 0x2000);
+    CHECK(AddrCache_Save());
+    std::string text = ReadFile(path);
+    CHECK(text.find("pGlobals 00001100") != std::string::npos);
+    CHECK(text.find("pGlobals 00002000") == std::string::npos);
+    CHECK(text.find("CJanus1_vtable") == std::string::npos);
+
+    // Warm start with the override removed: the scanned value is back.
+    CHECK(AddrCache_Open(path, "b", KeyOf(mp), KeyOf(hw)));
+    CHECK_EQ(AddrCache_GetOr("pGlobals", 0), 0x1100);
+    uint32_t rva = 0;
+    CHECK(!AddrCache_Get("CJanus1_vtable", rva));
+
+    // An override alone doesn't make a warm cache dirty.
+    AddrCache_Override("pGlobals", 0x2000);
+    remove(path);
+    CHECK(AddrCache_Save());
+    CHECK(ReadFile(path).empty());
+}
@@ -0,0 +1,199 @@
+// test_attach.cpp - AttachMachine against a simulated loader and server
+#include "test.h"
+#include "attach.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// The process side: a frame hook that can be armed, a server that becomes
+// ready, and an install whose results the test scripts.
+struct SimHost : AttachHost
+{
+    AttachMachine*    machine = nullptr;
+    bool              canArm = true;
+    bool              fireOnArm = false;    // StartFrame already running when armed
+    std::atomic<bool> armed{ false };
+    bool              ready = false;
+    std::vector<bool> results;              // per Install call, then true
+    int               installs = 0, arms = 0, disarms = 0;
+    std::thread::id   installer;
+
+    bool ArmFrameHook() override
+    {
+        arms++;
+        if (!canArm) return false;
+        armed = true;
+        if (fireOnArm) machine->OnFrame();
+        return true;
+    }
+    void DisarmFrameHook() override { disarms++; armed = false; }
+    bool ServerReady() override     { return ready; }
+    bool Install() override
+    {
+        installer = std::this_thread::get_id();
+        int i = installs++;
+        return i < (int)results.size() ? results[i] : true;
+    }
+
+    // One server frame: StartFrame only reaches the machine while armed.
+    void Frame() { if (armed) machine->OnFrame(); }
+};
+
+TEST(attach_first_frame_install)
+{
+    SimHost host;
+    AttachMachine m(host);
+    host.machine = &m;
+    CHECK_EQ(m.State(), ATTACH_WAIT_MODULE);
+    host.Frame();
+    m.OnPollTick();
+    CHECK_EQ(host.installs, 0);
+
+    m.OnModuleLoaded();
+    CHECK_EQ(m.State(), ATTACH_WAIT_FRAME);
+    CHECK(host.armed);
+    host.Frame();
+    CHECK_EQ(m.State(), ATTACH_DONE);
+    CHECK_EQ(host.installs, 1);
+    CHECK(!host.armed);
+
+    // Nothing after DONE reaches the host.
+    m.OnModuleLoaded();
+    m.OnFrame();
+    m.OnModuleUnloaded();
+    CHECK_EQ(m.State(), ATTACH_DONE);
+    CHECK_EQ(host.installs, 1);
+    CHECK_EQ(host.arms, 1);
+}
+
+TEST(attach_retries_every_n_frames)
+{
+    SimHost host;
+    AttachMachine m(host);
+    host.machine = &m;
+    host.results = { false, false };
+    m.OnModuleLoaded();
+
+    int frames = 0;
+    while (m.State() == ATTACH_WAIT_FRAME && frames < 10 * ATTACH_RETRY_FRAMES)
+    {
+        host.Frame();
+        frames++;
+    }
+    CHECK_EQ(m.State(), ATTACH_DONE);
+    CHECK_EQ(host.installs, 3);
+    CHECK_EQ(m.Tries(), 3);
+    CHECK_EQ(frames, 2 * ATTACH_RETRY_FRAMES + 1);
+    CHECK(!host.armed);
+}
+
+TEST(attach_gives_up_after_max_tries)
+{
+    SimHost host;
+    AttachMachine m(host);
+    host.machine = &m;
+    host.results.assign(ATTACH_MAX_TRIES + 4, false);
+    m.OnModuleLoaded();
+    for (int f = 0; f < (ATTACH_MAX_TRIES + 2) * ATTACH_RETRY_FRAMES; f++) host.Frame();
+    CHECK_EQ(m.State(), ATTACH_FAILED);
+    CHECK_EQ(host.installs, ATTACH_MAX_TRIES);
+    CHECK_EQ(host.disarms, 1);
+    CHECK(!host.armed);
+}
+
+TEST(attach_hook_firing_while_armed)
+{
+    // The server is already running: the first StartFrame lands inside
+    // ArmFrameHook, before OnModuleLoaded returns.
+    SimHost host;
+    AttachMachine m(host);
+    host.machine = &m;
+    host.fireOnArm = true;
+    m.OnModuleLoaded();
+    CHECK_EQ(m.State(), ATTACH_DONE);
+    CHECK_EQ(host.installs, 1);
+    CHECK(!host.armed);
+}
+
+TEST(attach_polling_fallback)
+{
+    SimHost host;
+    AttachMachine m(host);
+    host.machine = &m;
+    host.canArm = false;
+    host.results = { false };
+    m.OnModuleLoaded();
+    CHECK_EQ(m.State(), ATTACH_POLLING);
+
+    m.OnFrame();                  // no frame hook in this mode
+    m.OnPollTick();               // server not up yet
+    CHECK_EQ(host.installs, 0);
+    host.ready = true;
+    m.OnPollTick();
+    CHECK_EQ(m.State(), ATTACH_POLLING);
+    m.OnPollTick();
+    CHECK_EQ(m.State(), ATTACH_DONE);
+    CHECK_EQ(host.installs, 2);
+    CHECK_EQ(host.disarms, 0);
+}
+
+TEST(attach_unload_before_install)
+{
+    SimHost host;
+    AttachMachine m(host);
+    host.machine = &m;
+    host.results = { false };
+    m.OnModuleLoaded();
+    host.Frame();                 // first attempt fails
+    m.OnModuleUnloaded();
+    CHECK_EQ(m.State(), ATTACH_FAILED);
+    CHECK(!host.armed);
+
+    // A reloaded mp.dll is not chased.
+    m.OnModuleLoaded();
+    for (int f = 0; f < 2 * ATTACH_RETRY_FRAMES; f++) m.OnFrame();
+    CHECK_EQ(m.State(), ATTACH_FAILED);
+    CHECK_EQ(host.installs, 1);
+    CHECK_EQ(host.arms, 1);
+
+    SimHost polled;
+    AttachMachine p(polled);
+    polled.machine = &p;
+    polled.canArm = false;
+    p.OnModuleLoaded();
+    p.OnModuleUnloaded();
+    polled.ready = true;
+    p.OnPollTick();
+    CHECK_EQ(p.State(), ATTACH_FAILED);
+    CHECK_EQ(polled.installs, 0);
+    CHECK_EQ(polled.disarms, 0);
+}
+
+TEST(attach_loader_thread_and_game_thread)
+{
+    // The loader reports mp.dll on its own thread while the server is
+    // already ticking; install still happens once, on the game thread.
+    for (int round = 0; round < 50; round++)
+    {
+        SimHost host;
+        AttachMachine m(host);
+        host.machine = &m;
+        std::atomic<bool> go{ false };
+        std::thread loader([&]
+        {
+            while (!go) std::this_thread::yield();
+            m.OnModuleLoaded();
+        });
+        std::thread::id game = std::this_thread::get_id();
+        go = true;
+        for (int f = 0; f < 1000000 && m.State() != ATTACH_DONE; f++)
+        {
+            host.Frame();
+            if (m.State() == ATTACH_WAIT_MODULE) std::this_thread::yield();
+        }
+        loader.join();
+        CHECK_EQ(m.State(), ATTACH_DONE);
+        CHECK_EQ(host.installs, 1);
+        CHECK(host.installer == game);
+    }
+}
@@ -0,0 +1,228 @@
+// test_damage_accum.cpp - per-victim accumulation against the SDK's gMultiDamage and TraceAttack
+#include "test.h"
+#include "mock_engine.h"
+#include "damage_accum.h"
+#include "hitscan.h"
+#include <vector>
+
+struct Victim
+{
+    float health = 1000.0f;
+    int   bits = 0;          // OR of the type bits of every TakeDamage
+    int   takeDamage = 0;    // calls
+};
+
+static void TakeDamage(Victim* v, float damage, int bits)
+{
+    v->health -= damage;
+    v->bits   |= bits;
+    v->takeDamage++;
+}
+
+// weapons.cpp: one victim at a time, flushed when the next hit lands on
+// someone else. The type bits are OR'd in before the flush and only reset
+// by Clear, so they leak onto the victim being flushed.
+struct LegacyMultiDamage
+{
+    Victim* ent = nullptr;
+    float   amount = 0.0f;
+    int     type = 0;
+
+    void Clear() { ent = nullptr; amount = 0.0f; type = 0; }
+    void Apply() { if (ent) TakeDamage(ent, amount, type); }
+    void Add(Victim* v, float damage, int bits)
+    {
+        if (!v) return;
+        type |= bits;
+        if (v != ent)
+        {
+            Apply();
+            ent = v;
+            amount = 0.0f;
+        }
+        amount += damage;
+    }
+};
+
+struct Hit { int victim; float damage; int bits; };
+
+static void RunLegacy(const std::vector<Hit>& hits, std::vector<Victim>& vs)
+{
+    LegacyMultiDamage md;
+    md.Clear();
+    for (const Hit& h : hits) md.Add(&vs[h.victim], h.damage, h.bits);
+    md.Apply();
+}
+
+// The way hitscan and piercing attacks use it: a hit that doesn't fit is
+// applied on its own.
+static void RunAccum(const std::vector<Hit>& hits, std::vector<Victim>& vs)
+{
+    DamageAccum acc;
+    for (const Hit& h : hits)
+        if (!acc.Add(&vs[h.victim], h.damage, h.bits)) TakeDamage(&vs[h.victim], h.damage, h.bits);
+    acc.Apply([](const DamageEntry& e) { TakeDamage((Victim*)e.victim, e.damage, e.bits); });
+}
+
+// Damage in whole points, as weapon scripts give it, so sums are exact in
+// any order.
+static std::vector<Hit> Attack(MockRng& rng, int victims, int hits)
+{
+    std::vector<Hit> out;
+    for (int i = 0; i < hits; i++)
+    {
+        int v = (int)rng.Below(victims);
+        // Runs on the same victim, like pellets hitting one player.
+        int run = 1 + (int)rng.Below(3);
+        for (int r = 0; r < run && (int)out.size() < hits; r++)
+            out.push_back({ v, (float)(5 + rng.Below(40)), 1 << rng.Below(4) });
+    }
+    return out;
+}
+
+TEST(damage_accum_matches_per_hit_totals)
+{
+    MockRng rng(24);
+    for (int attack = 0; attack < 2000; attack++)
+    {
+        int victims = 1 + (int)rng.Below(48);   // past DMG_ACCUM_MAX some of the time
+        std::vector<Hit> hits = Attack(rng, victims, 1 + (int)rng.Below(64));
+        std::vector<Victim> legacy(victims), accum(victims);
+        RunLegacy(hits, legacy);
+        RunAccum(hits, accum);
+
+        std::vector<int> wantBits(victims, 0), hitCount(victims, 0);
+        for (const Hit& h : hits) { wantBits[h.victim] |= h.bits; hitCount[h.victim]++; }
+        int distinct = 0;
+        for (int v = 0; v < victims; v++)
+        {
+            // Same damage taken by everyone.
+            CHECK(accum[v].health == legacy[v].health);
+            // Each victim's own bits; the SDK's leak can only add to them.
+            CHECK_EQ(accum[v].bits, wantBits[v]);
+            CHECK_EQ(legacy[v].bits & wantBits[v], wantBits[v]);
+            // Once per victim while the accumulator has room, never more
+            // often than the per-hit flushes.
+            CHECK(accum[v].takeDamage <= legacy[v].takeDamage);
+            if (hitCount[v]) distinct++;
+        }
+        if (distinct <= DMG_ACCUM_MAX)
+            for (int v = 0; v < victims; v++) CHECK_EQ(accum[v].takeDamage, hitCount[v] ? 1 : 0);
+    }
+}
+
+TEST(damage_accum_alternating_victims)
+{
+    // A piercing shot through a column of zombies, back and forth: the
+    // SDK flushes on every hit, the accumulator once per zombie.
+    std::vector<Victim> legacy(2), accum(2);
+    std::vector<Hit> hits;
+    for (int i = 0; i < 10; i++) hits.push_back({ i & 1, 30.0f, 2 });
+    RunLegacy(hits, legacy);
+    RunAccum(hits, accum);
+    CHECK_EQ(legacy[0].takeDamage + legacy[1].takeDamage, 10);
+    CHECK_EQ(accum[0].takeDamage, 1);
+    CHECK_EQ(accum[1].takeDamage, 1);
+    CHECK(accum[0].health == legacy[0].health && accum[0].health == 850.0f);
+    CHECK(accum[1].health == legacy[1].health);
+}
+
+TEST(damage_accum_first_hit_order_and_clear)
+{
+    // Adjacent bytes: same hash, so every lookup walks the probe chain.
+    static char ents[40];
+    DamageAccum acc;
+    for (int i = 0; i < DMG_ACCUM_MAX; i++) CHECK(acc.Add(&ents[DMG_ACCUM_MAX - 1 - i], 1.0f, 1));
+    for (int i = 0; i < DMG_ACCUM_MAX; i++) CHECK(acc.Add(&ents[i], 2.0f, 4));
+    CHECK(!acc.Add(&ents[DMG_ACCUM_MAX], 1.0f, 1));
+    CHECK_EQ(acc.Count(), DMG_ACCUM_MAX);
+
+    int i = 0;
+    acc.Apply([&](const DamageEntry& e)
+    {
+        CHECK(e.victim == &ents[DMG_ACCUM_MAX - 1 - i]);
+        CHECK(e.damage == 3.0f);
+        CHECK_EQ(e.bits, 5);
+        CHECK_EQ(e.hits, 2);
+        i++;
+    });
+    CHECK_EQ(i, DMG_ACCUM_MAX);
+    CHECK_EQ(acc.Count(), 0);
+    CHECK(acc.Add(&ents[DMG_ACCUM_MAX], 1.0f, 1));
+    CHECK_EQ(acc.Entry(0).hits, 1);
+}
+
+// CBasePlayer::TraceAttack: the hitgroup multiplier, then AddMultiDamage.
+static float TraceAttackScale(int hitgroup)
+{
+    switch (hitgroup)
+    {
+    case HS_HIT_HEAD:     return 4.0f;
+    case HS_HIT_STOMACH:  return 1.25f;
+    case HS_HIT_LEFTLEG:
+    case HS_HIT_RIGHTLEG: return 0.75f;
+    default:              return 1.0f;
+    }
+}
+
+// Hands back a scripted trace result per pellet; the rays don't matter.
+struct ScriptedWorld : HitscanWorld
+{
+    std::vector<Victim>& vs;
+    std::vector<HsHit>   script;
+    explicit ScriptedWorld(std::vector<Victim>& v) : vs(v) {}
+
+    void TraceBatch(const HsRay*, int n, void*, HsHit* out) override
+    {
+        for (int i = 0; i < n; i++) out[i] = script[i];
+    }
+    void ApplyDamage(void* victim, float damage, int bits, int) override
+    {
+        TakeDamage((Victim*)victim, damage, bits);
+    }
+};
+
+TEST(damage_accum_hitscan_hitgroups_match_trace_attack)
+{
+    MockRng rng(22);
+    for (int volley = 0; volley < 2000; volley++)
+    {
+        int victims = 1 + (int)rng.Below(6);
+        int pellets = 1 + (int)rng.Below(HS_MAX_PELLETS);
+        std::vector<Victim> legacy(victims), accum(victims);
+        ScriptedWorld w(accum);
+
+        // Per pellet, the SDK way: TraceAttack scales, AddMultiDamage
+        // flushes on a victim change, ApplyMultiDamage at the end.
+        LegacyMultiDamage md;
+        md.Clear();
+        for (int i = 0; i < pellets; i++)
+        {
+            HsHit h = { 1.0f, { 0, 0, 0 }, nullptr, 0 };
+            if (rng.Below(5))   // some pellets miss
+            {
+                int v = (int)rng.Below(victims);
+                h.fraction = 0.5f;
+                h.entity   = &accum[v];
+                h.hitgroup = (int)rng.Below(HS_HITGROUPS);
+                md.Add(&legacy[v], 20.0f * TraceAttackScale(h.hitgroup), 2);
+            }
+            w.script.push_back(h);
+        }
+        md.Apply();
+
+        HsVolley v = {};
+        v.forward = { 1, 0, 0 };
+        v.range   = 1000.0f;
+        v.damage  = 20.0f;
+        v.dmgBits = 2;
+        v.pellets = pellets;
+        Hitscan_Fire(w, v, nullptr);
+
+        for (int i = 0; i < victims; i++)
+        {
+            CHECK(accum[i].health == legacy[i].health);
+            CHECK(accum[i].takeDamage <= 1);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+// test_hitscan.cpp - Hitscan_Fire's rays, per-victim damage and hitgroup scaling
+#include "test.h"
+#include "hitscan.h"
+#include <cmath>
+#include <vector>
+
+// Records every ray and hands back a scripted hit per pellet.
+struct RecordingWorld : HitscanWorld
+{
+    struct Apply { void* victim; float damage; int bits, hits; };
+    std::vector<HsRay> rays;
+    std::vector<HsHit> script;
+    std::vector<Apply> applies;
+    void*              skip = nullptr;
+    int                batches = 0;
+
+    void TraceBatch(const HsRay* r, int n, void* s, HsHit* out) override
+    {
+        batches++;
+        skip = s;
+        for (int i = 0; i < n; i++)
+        {
+            rays.push_back(r[i]);
+            out[i] = i < (int)script.size() ? script[i] : HsHit{ 1.0f, r[i].end, nullptr, 0 };
+        }
+    }
+    void ApplyDamage(void* victim, float damage, int bits, int hits) override
+    {
+        applies.push_back({ victim, damage, bits, hits });
+    }
+};
+
+static HsVolley Volley(int pellets, float spread)
+{
+    HsVolley v = {};
+    v.src     = { 10.0f, 20.0f, 30.0f };
+    v.forward = { 1, 0, 0 };
+    v.right   = { 0, -1, 0 };
+    v.up      = { 0, 0, 1 };
+    v.spreadX = v.spreadY = spread;
+    v.range   = 8192.0f;
+    v.damage  = 20.0f;
+    v.dmgBits = 2;
+    v.pellets = pellets;
+    v.seed    = 7;
+    return v;
+}
+
+static HsHit On(void* e, int hitgroup) { return { 0.5f, { 0, 0, 0 }, e, hitgroup }; }
+
+TEST(hitscan_no_pellets_no_trace)
+{
+    RecordingWorld w;
+    CHECK_EQ(Hitscan_Fire(w, Volley(0, 0.1f), nullptr), 0);
+    CHECK_EQ(Hitscan_Fire(w, Volley(-3, 0.1f), nullptr), 0);
+    CHECK_EQ(w.batches, 0);
+    CHECK(w.applies.empty());
+}
+
+TEST(hitscan_rays_one_batch_clamped)
+{
+    RecordingWorld w;
+    int shooter;
+    HsVolley v = Volley(HS_MAX_PELLETS + 10, 0.0f);
+    v.shooter = &shooter;
+    CHECK_EQ(Hitscan_Fire(w, v, nullptr), 0);
+    CHECK_EQ(w.batches, 1);
+    CHECK_EQ(w.rays.size(), HS_MAX_PELLETS);
+    CHECK(w.skip == &shooter);
+    // No spread: every ray runs range units straight down forward.
+    for (const HsRay& r : w.rays)
+    {
+        CHECK(r.start.x == 10.0f && r.start.y == 20.0f && r.start.z == 30.0f);
+        CHECK(fabsf(r.end.x - (10.0f + 8192.0f)) < 1e-2f);
+        CHECK(r.end.y == 20.0f && r.end.z == 30.0f);
+    }
+}
+
+TEST(hitscan_spread_stays_in_the_cone)
+{
+    RecordingWorld w;
+    HsVolley v = Volley(HS_MAX_PELLETS, 0.1f);
+    Hitscan_Fire(w, v, nullptr);
+    bool spread = false;
+    for (const HsRay& r : w.rays)
+    {
+        // The SDK's cone: forward + x * right + y * up, x and y within
+        // (-1, 1) * spread.
+        float dy = (r.end.y - r.start.y) / v.range, dz = (r.end.z - r.start.z) / v.range;
+        CHECK(fabsf(dy) < 0.1f + 1e-4f && fabsf(dz) < 0.1f + 1e-4f);
+        CHECK(fabsf((r.end.x - r.start.x) / v.range - 1.0f) < 1e-4f);
+        if (dy != 0.0f || dz != 0.0f) spread = true;
+    }
+    CHECK(spread);
+}
+
+TEST(hitscan_one_apply_per_victim_first_hit_order)
+{
+    RecordingWorld w;
+    int a, b;
+    w.script = { On(&b, HS_HIT_CHEST), On(&a, HS_HIT_CHEST), On(nullptr, 0),
+                 On(&b, HS_HIT_CHEST), { 1.0f, { 0, 0, 0 }, &a, 0 }, On(&a, HS_HIT_GENERIC) };
+    HsHit hits[HS_MAX_PELLETS];
+    CHECK_EQ(Hitscan_Fire(w, Volley(6, 0.05f), hits), 2);
+    CHECK_EQ(w.applies.size(), 2);
+    // The world pellet and the one that ran its full length don't count.
+    CHECK(w.applies[0].victim == &b);
+    CHECK(w.applies[0].damage == 40.0f);
+    CHECK_EQ(w.applies[0].hits, 2);
+    CHECK_EQ(w.applies[0].bits, 2);
+    CHECK(w.applies[1].victim == &a);
+    CHECK(w.applies[1].damage == 40.0f);
+    CHECK_EQ(w.applies[1].hits, 2);
+    // The caller's buffer gets every trace, for decals.
+    CHECK(hits[2].entity == nullptr);
+    CHECK(hits[3].entity == &b);
+}
+
+TEST(hitscan_scales_by_hitgroup)
+{
+    RecordingWorld w;
+    int p;
+    w.script = { On(&p, HS_HIT_HEAD), On(&p, HS_HIT_STOMACH), On(&p, HS_HIT_LEFTLEG),
+                 On(&p, HS_HIT_RIGHTARM), On(&p, 42) };
+    Hitscan_Fire(w, Volley(5, 0.05f), nullptr);
+    CHECK_EQ(w.applies.size(), 1);
+    // 20 * (4 + 1.25 + 0.75 + 1 + 1); an unknown group counts as 1.
+    CHECK(w.applies[0].damage == 160.0f);
+    CHECK_EQ(w.applies[0].hits, 5);
+}
+
+// A backend whose victims are props: no hitgroup multiplier at all.
+struct PropWorld : RecordingWorld
+{
+    float HitgroupScale(void*, int) override { return 1.0f; }
+};
+
+TEST(hitscan_backend_overrides_hitgroup_scale)
+{
+    PropWorld w;
+    int crate;
+    w.script = { On(&crate, HS_HIT_HEAD), On(&crate, HS_HIT_LEFTLEG) };
+    Hitscan_Fire(w, Volley(2, 0.05f), nullptr);
+    CHECK_EQ(w.applies.size(), 1);
+    CHECK(w.applies[0].damage == 40.0f);
+}
@@ -0,0 +1,133 @@
+// test_hook_registry.cpp - registration rules and the sealed hash indices
+#include "test.h"
+#include "hook_registry.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int g_fn;   // any non-null hook function
+static void* const FN = &g_fn;
+
+// hook_registry.cpp's slot for a key, so the tests can aim keys at one
+// slot and make them collide.
+static uint32_t RvaSlot(uintptr_t rva, uint32_t mask)
+{
+    uint32_t h = (uint32_t)rva * 0x9E3779B1u;
+    return (h ^ (h >> 16)) & mask;
+}
+
+static uint32_t NameSlot(const char* s, uint32_t mask)
+{
+    uint32_t h = 2166136261u;
+    while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+    return (h ^ (h >> 16)) & mask;
+}
+
+// n RVAs (16-byte aligned, like function starts) that all land in `slot`.
+static std::vector<uintptr_t> RvasAt(uint32_t slot, uint32_t mask, int n)
+{
+    std::vector<uintptr_t> out;
+    for (uintptr_t rva = 0x1000; (int)out.size() < n; rva += 0x10)
+        if (RvaSlot(rva, mask) == slot) out.push_back(rva);
+    return out;
+}
+
+static std::vector<std::string> NamesAt(uint32_t slot, uint32_t mask, int n)
+{
+    std::vector<std::string> out;
+    char buf[32];
+    for (int i = 0; (int)out.size() < n; i++)
+    {
+        snprintf(buf, sizeof(buf), "weapon_%d", i);
+        if (NameSlot(buf, mask) == slot) out.push_back(buf);
+    }
+    return out;
+}
+
+TEST(hook_registry_rejects_bad_and_duplicate_entries)
+{
+    HookReg_Reset();
+    CHECK_EQ(HookReg_Add("weapon_janus1", FN, 0x0E96640), HOOKREG_OK);
+    CHECK_EQ(HookReg_Add(nullptr, FN, 0x1000), HOOKREG_BAD_ARGS);
+    CHECK_EQ(HookReg_Add("weapon_m79", nullptr, 0x1000), HOOKREG_BAD_ARGS);
+    CHECK_EQ(HookReg_Add("weapon_m79", FN, 0x0E96640), HOOKREG_DUPLICATE_RVA);
+    CHECK_EQ(HookReg_Add("weapon_janus1", FN, 0x0F29F30), HOOKREG_DUPLICATE_NAME);
+    CHECK_EQ(HookReg_Count(), 1);
+    CHECK(strcmp(HookReg_ResultStr(HOOKREG_DUPLICATE_RVA), "?") != 0);
+
+    // Unsealed lookups: the linear scan.
+    CHECK(HookReg_FindRva(0x0E96640) == &HookReg_At(0));
+    CHECK(HookReg_FindName("weapon_janus1") == &HookReg_At(0));
+    CHECK(HookReg_FindRva(0x0F29F30) == nullptr);
+    CHECK(HookReg_FindName("weapon_m79") == nullptr);
+}
+
+TEST(hook_registry_closed_after_seal)
+{
+    HookReg_Reset();
+    CHECK_EQ(HookReg_Add("StartFrame", FN, 0x2000), HOOKREG_OK);
+    HookReg_Seal();
+    CHECK_EQ(HookReg_Add("ServerDeactivate", FN, 0x3000), HOOKREG_SEALED);
+    CHECK_EQ(HookReg_Add(nullptr, nullptr, 0), HOOKREG_SEALED);
+    HookReg_Seal();   // again: no change
+    CHECK_EQ(HookReg_Count(), 1);
+    CHECK(HookReg_FindRva(0x2000) == &HookReg_At(0));
+    CHECK(HookReg_FindRva(0x3000) == nullptr);
+
+    HookReg_Reset();
+    CHECK_EQ(HookReg_Count(), 0);
+    CHECK_EQ(HookReg_Add("ServerDeactivate", FN, 0x3000), HOOKREG_OK);
+}
+
+TEST(hook_registry_sealed_empty_finds_nothing)
+{
+    HookReg_Reset();
+    HookReg_Seal();
+    CHECK(HookReg_FindRva(0x1000) == nullptr);
+    CHECK(HookReg_FindName("weapon_janus1") == nullptr);
+}
+
+TEST(hook_registry_collisions_wrap_around)
+{
+    // Four entries seal into 8 slots. All four RVAs and all four names
+    // hash to the last slot, so each chain runs 7, 0, 1, 2.
+    const uint32_t mask = 7;
+    std::vector<uintptr_t>   rvas  = RvasAt(mask, mask, 5);
+    std::vector<std::string> names = NamesAt(mask, mask, 5);
+
+    HookReg_Reset();
+    for (int i = 0; i < 4; i++) CHECK_EQ(HookReg_Add(names[i].c_str(), FN, rvas[i]), HOOKREG_OK);
+    HookReg_Seal();
+    for (int i = 0; i < 4; i++)
+    {
+        CHECK(HookReg_FindRva(rvas[i]) == &HookReg_At(i));
+        CHECK(HookReg_FindName(names[i].c_str()) == &HookReg_At(i));
+    }
+    // Missing keys on the same chain walk it through the wrap and stop
+    // at the first empty slot.
+    CHECK(HookReg_FindRva(rvas[4]) == nullptr);
+    CHECK(HookReg_FindName(names[4].c_str()) == nullptr);
+    CHECK(HookReg_FindRva(0) == nullptr);
+    CHECK(HookReg_FindName("") == nullptr);
+    HookReg_Reset();   // the names die with this scope
+}
+
+TEST(hook_registry_many_entries)
+{
+    // Past the initial 8 slots: the index grows to keep load <= 0.5.
+    HookReg_Reset();
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++) names.push_back("hook_" + std::to_string(i));
+    for (int i = 0; i < 100; i++)
+        CHECK_EQ(HookReg_Add(names[i].c_str(), FN, 0x10000 + i * 0x40), HOOKREG_OK);
+    HookReg_Seal();
+    for (int i = 0; i < 100; i++)
+    {
+        CHECK(HookReg_FindRva(0x10000 + i * 0x40) == &HookReg_At(i));
+        CHECK(HookReg_FindName(names[i].c_str()) == &HookReg_At(i));
+        CHECK(HookReg_FindRva(0x10000 + i * 0x40 + 0x10) == nullptr);
+    }
+    CHECK(HookReg_FindName("hook_100") == nullptr);
+    HookReg_Reset();
+}
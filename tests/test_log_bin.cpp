@@ -0,0 +1,195 @@
+// test_log_bin.cpp - binary log records: encode, decode, compare with printf
+#include "test.h"
+#include "log_bin.h"
+#include "log_decode.h"
+#include "logger.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+enum TestMode { MODE_A = 3, MODE_B = -2 };
+
+struct BinLog
+{
+    std::vector<uint8_t> data;
+
+    BinLog() : data(LOGBIN_MAGIC, LOGBIN_MAGIC + sizeof(LOGBIN_MAGIC)) {}
+
+    void Append(const uint8_t* rec, size_t len) { data.insert(data.end(), rec, rec + len); }
+
+    template<typename... Args>
+    void Def(uint32_t id, const char* fmt)
+    {
+        uint8_t rec[512];
+        typedef LogArgTypes<Args...> Types;
+        size_t n = LogBin_EncodeDef(rec, sizeof(rec), id, Types::str, Types::count, fmt);
+        CHECK(n);
+        Append(rec, n);
+    }
+
+    template<typename... Args>
+    void Msg(uint32_t id, const Args&... args)
+    {
+        uint8_t rec[512];
+        size_t n = LogBin_EncodeMsg(rec, sizeof(rec), id, args...);
+        CHECK(n);
+        Append(rec, n);
+    }
+};
+
+static bool Decode(const std::vector<uint8_t>& data, std::string& out, std::string& err)
+{
+    FILE* fo = tmpfile();
+    FILE* fe = tmpfile();
+    if (!fo || !fe) return false;
+    bool ok = LogBin_Decode(data.data(), data.size(), fo, fe);
+    char buf[4096];
+    out.clear(); err.clear();
+    rewind(fo);
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), fo)) > 0; ) out.append(buf, n);
+    rewind(fe);
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), fe)) > 0; ) err.append(buf, n);
+    fclose(fo); fclose(fe);
+    return ok;
+}
+
+template<typename... Args>
+static std::string Printf(const char* fmt, Args... args)
+{
+    char buf[512];
+    snprintf(buf, sizeof(buf), fmt, args...);
+    return buf;
+}
+
+TEST(log_bin_type_codes)
+{
+    CHECK(!strcmp(LogArgTypes<int, unsigned, long long, unsigned long long>::str, "iulq"));
+    CHECK(!strcmp(LogArgTypes<char, short, uint8_t, bool, TestMode>::str, "iiuui"));
+    CHECK(!strcmp(LogArgTypes<float, double, const char*, char*, void*, const int*>::str, "ddsspp"));
+    CHECK_EQ((LogArgTypes<>::count), 0);
+}
+
+TEST(log_bin_round_trip_every_arg_type)
+{
+    const char* fmt = "i=%d u=%u l=%lld q=%llu d=%.3f f=%g s=[%-6s] c=%c h=%hd x=%08x e=%d\n";
+    BinLog log;
+    log.Def<int, unsigned, long long, unsigned long long, double, float, const char*, char, short,
+            uint32_t, TestMode>(1, fmt);
+    log.Msg(1, -7, 4000000000u, -9000000000123LL, 18446744073709551615ULL, 3.14159, 0.5f,
+            "abc", 'Z', (short)-12, 0xBEEFu, MODE_B);
+    log.Msg(1, INT32_MIN, 0u, INT64_MIN, 0ULL, -0.0005, 1e30f, "", ' ', (short)32767, 0u, MODE_A);
+
+    // Pointers print as 8 hex digits (the game's width) whatever the spec;
+    // null and mutable strings ride along as strings.
+    char buf[] = "mutable";
+    log.Def<void*, const char*, char*>(2, "p=%p n=%s m=%s\n");
+    log.Msg(2, (void*)(uintptr_t)0x2468ACE0, (const char*)nullptr, buf);
+
+    std::string out, err;
+    CHECK(Decode(log.data, out, err));
+    std::string want =
+        Printf(fmt, -7, 4000000000u, -9000000000123LL, 18446744073709551615ULL, 3.14159, 0.5,
+               "abc", 'Z', -12, 0xBEEFu, -2)
+      + Printf(fmt, INT32_MIN, 0u, (long long)INT64_MIN, 0ULL, -0.0005, 1e30, "", ' ', 32767, 0u, 3)
+      + "p=2468ACE0 n=(null) m=mutable\n";
+    CHECK(out == want);
+    if (out != want) fprintf(stderr, "  got:\n%s  want:\n%s", out.c_str(), want.c_str());
+    CHECK(err.empty());
+}
+
+TEST(log_bin_def_reuse_and_order)
+{
+    BinLog log;
+    log.Msg(5, 1);                               // before its DEF: other thread's record
+    log.Def<int>(5, "hit %d\n");
+    log.Msg(5, 2);
+    log.Def<int>(5, "other format %d\n");        // racing second DEF: first one wins
+    log.Msg(5, 3);
+    log.Msg(9, 4);                               // never defined
+    log.Def<>(6, "plain 100%%\n");
+    log.Msg(6);                                  // no args: empty payload, not decoded
+    uint8_t rec[16];
+    size_t n = LogBin_EncodeMsg(rec, sizeof(rec), 6, 0);
+    log.Append(rec, n);                          // args the DEF doesn't have: ignored
+    log.Def<int, int>(7, "%d %d %d\n");          // more conversions than args
+    log.Msg(7, 1, 2);
+
+    std::string out, err;
+    CHECK(Decode(log.data, out, err));
+    CHECK(out == "hit 1\nhit 2\nhit 3\n<message for unknown site 9>\nplain 100%\n"
+                 "1 2 <bad arg 2 in \"%d %d %d\n\">\n");
+    if (!err.empty()) fprintf(stderr, "  err: %s", err.c_str());
+}
+
+TEST(log_bin_truncated_file)
+{
+    BinLog log;
+    log.Def<int, const char*>(1, "n=%d s=%s\n");
+    log.Msg(1, 1, "first");
+    log.Msg(1, 2, "second");
+    std::string out, err;
+
+    // Cut inside the last record's payload: everything before it survives.
+    std::vector<uint8_t> cut(log.data.begin(), log.data.end() - 3);
+    CHECK(Decode(cut, out, err));
+    CHECK(out == "n=1 s=first\n");
+    CHECK(err == "truncated record at end of file\n");
+
+    // Cut inside a header: stops quietly.
+    cut.assign(log.data.begin(), log.data.end() - (LOGBIN_HDR + 4 + 2 + 6) + 2);
+    CHECK(Decode(cut, out, err));
+    CHECK(out == "n=1 s=first\n");
+
+    // Magic only, or not a log at all.
+    cut.assign(log.data.begin(), log.data.begin() + sizeof(LOGBIN_MAGIC));
+    CHECK(Decode(cut, out, err));
+    CHECK(out.empty());
+    cut[0] = 'X';
+    CHECK(!Decode(cut, out, err));
+}
+
+TEST(log_bin_encoder_truncation)
+{
+    uint8_t rec[64];
+    // A string too long for the slot is cut, the record still decodes.
+    std::string longStr(200, 'x');
+    size_t n = LogBin_EncodeMsg(rec, 32, 1, 7, longStr.c_str());
+    CHECK_EQ(n, 32);
+    BinLog log;
+    log.Def<int, const char*>(1, "%d %s\n");
+    log.Append(rec, n);
+    std::string out, err;
+    CHECK(Decode(log.data, out, err));
+    CHECK(out == "7 " + std::string(32 - LOGBIN_HDR - 4 - 2, 'x') + "\n");
+
+    // Fixed-size arguments that don't fit: nothing is written.
+    CHECK_EQ(LogBin_EncodeMsg(rec, LOGBIN_HDR + 7, 1, 1LL), 0);
+    CHECK_EQ(LogBin_EncodeMsg(rec, LOGBIN_HDR - 1, 1), 0);
+    CHECK_EQ(LogBin_EncodeMsg(rec, LOGBIN_HDR, 1), LOGBIN_HDR);
+    CHECK_EQ(LogBin_EncodeMsg(rec, LOGBIN_HDR + 1, 1, "s"), 0);   // no room for the length
+    // DEF: the format string is never cut.
+    CHECK_EQ(LogBin_EncodeDef(rec, LOGBIN_HDR + 1 + 1 + 4, 1, "i", 1, "n=%d"), LOGBIN_HDR + 6);
+    CHECK_EQ(LogBin_EncodeDef(rec, LOGBIN_HDR + 1 + 1 + 3, 1, "i", 1, "n=%d"), 0);
+}
+
+TEST(log_bin_through_the_logger)
+{
+    // LOG_FAST in binary mode, written by the real logger, decoded back.
+    Log_SetBinary(true);
+    for (int i = 0; i < 3; i++) LOG_FAST("fast %d %s %.2f %llu\n", i, "abc", i * 0.5, 1ULL << 40);
+    Log_Flush();
+    Log_SetBinary(false);
+
+    std::vector<uint8_t> data;
+    if (FILE* f = fopen("csnz_weapons.bin", "rb"))
+    {
+        uint8_t buf[4096];
+        for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0; ) data.insert(data.end(), buf, buf + n);
+        fclose(f);
+    }
+    std::string out, err;
+    CHECK(Decode(data, out, err));
+    CHECK(out.find("fast 0 abc 0.00 1099511627776\nfast 1 abc 0.50 1099511627776\n"
+                   "fast 2 abc 1.00 1099511627776\n") != std::string::npos);
+    CHECK(err.empty());
+}
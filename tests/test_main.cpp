@@ -0,0 +1,70 @@
+// test_main.cpp - runner for csnz_core_tests
+#include "test.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct TestEntry
+{
+    const char* name;
+    TestFn      fn;
+};
+
+static std::vector<TestEntry>& Tests()
+{
+    static std::vector<TestEntry> tests;
+    return tests;
+}
+
+static int g_failures;
+
+TestReg::TestReg(const char* name, TestFn fn)
+{
+    Tests().push_back({ name, fn });
+}
+
+void Test_Fail(const char* file, int line, const char* expr)
+{
+    fprintf(stderr, "  %s:%d: CHECK(%s) failed\n", file, line, expr);
+    g_failures++;
+}
+
+void Test_FailEq(const char* file, int line, const char* a, const char* b,
+                 long long va, long long vb)
+{
+    fprintf(stderr, "  %s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", file, line, a, b, va, vb);
+    g_failures++;
+}
+
+const char* Test_TempPath(const char* name)
+{
+    static std::string path;
+    path = std::string("csnz_test_") + name;
+    return path.c_str();
+}
+
+int main(int argc, char** argv)
+{
+    // Run in a scratch directory: the logger and the caches write to the cwd.
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "csnz_core_tests";
+    std::filesystem::create_directories(dir, ec);
+    std::filesystem::current_path(dir, ec);
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0, failed = 0;
+    for (const TestEntry& t : Tests())
+    {
+        if (filter && !strstr(t.name, filter)) continue;
+        int before = g_failures;
+        t.fn();
+        run++;
+        bool ok = g_failures == before;
+        if (!ok) failed++;
+        printf("%-4s %s\n", ok ? "ok" : "FAIL", t.name);
+    }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed;
+}
@@ -0,0 +1,76 @@
+// test_mock_engine.cpp - the mock itself, so other tests can lean on it
+#include "test.h"
+#include "mock_engine.h"
+#include "pe_scan.h"
+
+TEST(mock_engine_records_precaches)
+{
+    MockEngine& e = Mock_Engine();
+    e.Reset();
+    CHECK_EQ(e.funcs.pfnPrecacheModel("models/v_a.mdl"), 1);
+    CHECK_EQ(e.funcs.pfnPrecacheModel("models/p_a.mdl"), 2);
+    CHECK_EQ(e.funcs.pfnPrecacheSound("weapons/a-1.wav"), 1);
+    e.funcs.pfnSetModel(nullptr, "models/w_a.mdl");
+    CHECK_EQ(e.models.size(), 2);
+    CHECK(e.models[1] == "models/p_a.mdl");
+    CHECK(e.sounds[0] == "weapons/a-1.wav");
+    CHECK_EQ(e.setModels, 1);
+    e.Reset();
+    CHECK(e.models.empty() && e.sounds.empty());
+}
+
+TEST(mock_engine_clock)
+{
+    MockEngine& e = Mock_Engine();
+    e.Reset(10.0f);
+    e.Advance(0.5f);
+    e.Advance(0.25f);
+    CHECK(e.Time() == 10.75f);
+    CHECK(e.globals.frametime == 0.25f);
+    // frametime sits right after time, as in globalvars_t
+    CHECK(e.TimePtr()[1] == 0.25f);
+}
+
+TEST(mock_weapon_class_override)
+{
+    MockWeaponClass base(0, "CBasePlayerWeapon");
+    const int over[] = { SLOT_Deploy, SLOT_Holster };
+    MockWeaponClass derived(1, "CJanus1", &base, over, 2);
+    MockWeapon a(base), b(derived);
+
+    CHECK_EQ(Mock_CallSlot(&a, SLOT_Deploy), MockSlotValue(0, SLOT_Deploy));
+    CHECK_EQ(Mock_CallSlot(&b, SLOT_Deploy), MockSlotValue(1, SLOT_Deploy));
+    CHECK_EQ(Mock_CallSlot(&b, SLOT_Holster), MockSlotValue(1, SLOT_Holster));
+    CHECK_EQ(Mock_CallSlot(&b, SLOT_WeaponIdle), MockSlotValue(0, SLOT_WeaponIdle));
+    CHECK_EQ(Mock_CallSlot(&b, WEAPON_VTABLE_SLOTS - 1), MockSlotValue(0, WEAPON_VTABLE_SLOTS - 1));
+    CHECK(derived.Vtable()[-1] == &derived);
+    CHECK(sizeof(MockWeapon) >= MOCK_WEAPON_SIZE);
+}
+
+TEST(mock_pe_parses)
+{
+    MockPe pe(0x10000000, 0x11223344, 0x55667788);
+    uint32_t text = pe.AddSection(".text", 0x3000, MOCK_SCN_TEXT);
+    uint32_t data = pe.AddSection(".data", 0x1234, MOCK_SCN_DATA);
+    pe.Put32(data + 8, 0xDEADBEEF);
+
+    PeImage img;
+    CHECK(Pe_Parse(pe.Data(), pe.Size(), true, img));
+    CHECK_EQ(img.numSections, 2);
+    CHECK_EQ(img.imageBase, 0x10000000);
+    CHECK_EQ(img.timeDateStamp, 0x11223344);
+    CHECK_EQ(img.checkSum, 0x55667788);
+    CHECK_EQ(img.sizeOfImage, pe.Size());
+    CHECK_EQ(img.sections[0].rva, text);
+    CHECK_EQ(img.sections[1].vsize, 0x1234);
+
+    std::vector<uint8_t> file = pe.FileImage();
+    PeImage fimg;
+    CHECK(Pe_Parse(file.data(), file.size(), false, fimg));
+    size_t len = 0;
+    const uint8_t* p = Pe_SectionData(fimg, fimg.sections[1], len);
+    CHECK(p && len == 0x1234);
+    uint32_t v = 0;
+    if (p) memcpy(&v, p + 8, 4);
+    CHECK_EQ(v, 0xDEADBEEF);
+}
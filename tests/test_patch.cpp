@@ -0,0 +1,335 @@
+// test_patch.cpp - PatchBatch against a fake memory model and the live process
+#include "test.h"
+#include "patch.h"
+#include <cstring>
+#include <functional>
+#include <vector>
+#ifndef _WIN32
+#include <cstdio>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// A 16-page address space at FAKE_BASE. Each page carries a protection
+// word; writes only land on unprotected pages, so a backend call made out
+// of order shows up as a failed write rather than silently succeeding.
+static const uintptr_t FAKE_BASE  = 0x10000;
+static const size_t    FAKE_PAGE  = 0x1000;
+static const int       FAKE_PAGES = 16;
+
+enum { FAKE_RX = 0x20, FAKE_R = 0x02, FAKE_RW = 0x04, FAKE_RWX = 0x40 };
+
+struct FakeMemory : PatchMemory
+{
+    std::vector<uint8_t>  bytes = std::vector<uint8_t>(FAKE_PAGES * FAKE_PAGE);
+    uint32_t              prot[FAKE_PAGES];
+    int                   flips = 0, restores = 0, flushes = 0, writes = 0;
+    uintptr_t             failUnprotect = 0, failRead = 0, failWrite = 0;
+    std::function<void()> onFirstWrite;
+
+    FakeMemory()
+    {
+        for (size_t i = 0; i < bytes.size(); i++) bytes[i] = (uint8_t)(i * 7 + 3);
+        for (uint32_t& p : prot) p = FAKE_RX;
+    }
+
+    uint32_t& Prot(uintptr_t page) { return prot[(page - FAKE_BASE) / FAKE_PAGE]; }
+    bool      InRange(uintptr_t a, size_t n) const
+    {
+        return a >= FAKE_BASE && a + n <= FAKE_BASE + bytes.size();
+    }
+    uint8_t*  At(uintptr_t a) { return &bytes[a - FAKE_BASE]; }
+
+    size_t PageSize() override { return FAKE_PAGE; }
+
+    bool Unprotect(uintptr_t page, uint32_t& saved) override
+    {
+        if (page == failUnprotect || !InRange(page, FAKE_PAGE)) return false;
+        flips++;
+        saved = Prot(page);
+        Prot(page) = FAKE_RWX;
+        return true;
+    }
+
+    bool Restore(uintptr_t page, uint32_t saved) override
+    {
+        restores++;
+        Prot(page) = saved;
+        return true;
+    }
+
+    bool Read(uintptr_t addr, void* dst, size_t len) override
+    {
+        if (addr == failRead || !InRange(addr, len)) return false;
+        memcpy(dst, At(addr), len);
+        return true;
+    }
+
+    bool Write(uintptr_t addr, const void* src, size_t len) override
+    {
+        if (!InRange(addr, len)) return false;
+        if (!writes++ && onFirstWrite) onFirstWrite();
+        // A failing write lands its first byte, like a fault partway through.
+        size_t n = addr == failWrite ? 1 : len;
+        for (size_t i = 0; i < n; i++)
+        {
+            uintptr_t a = addr + i;
+            if (Prot(a & ~(uintptr_t)(FAKE_PAGE - 1)) != FAKE_RWX) return false;
+            *At(a) = ((const uint8_t*)src)[i];
+        }
+        return n == len;
+    }
+
+    void FlushCode(uintptr_t, size_t) override { flushes++; }
+};
+
+static const uint8_t NOPS[4] = { 0x90, 0x90, 0x90, 0x90 };
+
+TEST(patch_plan_one_page_per_touch)
+{
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x2010, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x0100, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x2400, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x0200, NOPS, 2));
+    std::vector<uintptr_t> pages;
+    CHECK(b.Plan(FAKE_PAGE, pages));
+    CHECK_EQ(pages.size(), 2);
+    CHECK_EQ(pages[0], FAKE_BASE);
+    CHECK_EQ(pages[1], FAKE_BASE + 0x2000);
+}
+
+TEST(patch_plan_straddling_write_needs_both_pages)
+{
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x0FFE, NOPS, 4));
+    std::vector<uintptr_t> pages;
+    CHECK(b.Plan(FAKE_PAGE, pages));
+    CHECK_EQ(pages.size(), 2);
+    CHECK_EQ(pages[0], FAKE_BASE);
+    CHECK_EQ(pages[1], FAKE_BASE + 0x1000);
+}
+
+TEST(patch_overlap_rejected_before_touching_memory)
+{
+    FakeMemory mem;
+    std::vector<uint8_t> before = mem.bytes;
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x100, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x103, NOPS, 2));
+    CHECK(!b.Commit(mem));
+    CHECK(strcmp(b.Error(), "overlapping writes") == 0);
+    CHECK_EQ(b.ErrorAddr(), FAKE_BASE + 0x103);
+    CHECK_EQ(mem.flips, 0);
+    CHECK(mem.bytes == before);
+}
+
+TEST(patch_add_rejects_bad_sizes)
+{
+    uint8_t big[PATCH_MAX_BYTES + 1] = {};
+    PatchBatch b;
+    CHECK(!b.Add(FAKE_BASE, big, sizeof(big)));
+    CHECK(!b.Add(FAKE_BASE, big, 0));
+    CHECK(!b.Add(FAKE_BASE, nullptr, 4));
+    CHECK_EQ(b.Count(), 0);
+}
+
+TEST(patch_commit_writes_and_restores_each_page_protection)
+{
+    FakeMemory mem;
+    mem.prot[0] = FAKE_RX;
+    mem.prot[1] = FAKE_R;
+    mem.prot[3] = FAKE_RW;
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x0010, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x0FFF, NOPS, 2));    // pages 0 and 1
+    CHECK(b.Add(FAKE_BASE + 0x3020, NOPS, 3));
+    CHECK(b.Commit(mem));
+    CHECK_EQ(mem.flips, 3);
+    CHECK_EQ(mem.restores, 3);
+    CHECK_EQ(mem.flushes, 3);
+    CHECK_EQ(mem.prot[0], FAKE_RX);
+    CHECK_EQ(mem.prot[1], FAKE_R);
+    CHECK_EQ(mem.prot[3], FAKE_RW);
+    CHECK(memcmp(mem.At(FAKE_BASE + 0x0010), NOPS, 4) == 0);
+    CHECK(memcmp(mem.At(FAKE_BASE + 0x0FFF), NOPS, 2) == 0);
+    CHECK(memcmp(mem.At(FAKE_BASE + 0x3020), NOPS, 3) == 0);
+}
+
+TEST(patch_originals_published_before_any_write)
+{
+    FakeMemory mem;
+    uintptr_t a = FAKE_BASE + 0x0040, c = FAKE_BASE + 0x5000;
+    uint8_t expectA[4], expectC[4];
+    memcpy(expectA, mem.At(a), 4);
+    memcpy(expectC, mem.At(c), 4);
+
+    uint8_t saveA[4] = {}, saveC[4] = {};
+    bool seenBeforeWrite = false;
+    mem.onFirstWrite = [&]
+    {
+        seenBeforeWrite = memcmp(saveA, expectA, 4) == 0 && memcmp(saveC, expectC, 4) == 0;
+    };
+    PatchBatch b;
+    CHECK(b.Add(c, NOPS, 4, saveC));
+    CHECK(b.Add(a, NOPS, 4, saveA));
+    CHECK(b.Commit(mem));
+    CHECK(seenBeforeWrite);
+}
+
+TEST(patch_failed_unprotect_changes_nothing)
+{
+    FakeMemory mem;
+    mem.prot[2] = FAKE_R;
+    std::vector<uint8_t> before = mem.bytes;
+    mem.failUnprotect = FAKE_BASE + 0x4000;
+    uint8_t save[4] = { 0xAA, 0xAA, 0xAA, 0xAA };
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x2000, NOPS, 4, save));
+    CHECK(b.Add(FAKE_BASE + 0x4000, NOPS, 4));
+    CHECK(!b.Commit(mem));
+    CHECK(strcmp(b.Error(), "unprotect failed") == 0);
+    CHECK_EQ(b.ErrorAddr(), FAKE_BASE + 0x4000);
+    CHECK(mem.bytes == before);
+    CHECK_EQ(mem.writes, 0);
+    CHECK_EQ(mem.restores, 1);              // the page that did flip
+    CHECK_EQ(mem.prot[2], FAKE_R);
+    CHECK_EQ(save[0], 0xAA);                // nothing published
+    CHECK(!b.Revert(mem));
+}
+
+TEST(patch_failed_read_changes_nothing)
+{
+    FakeMemory mem;
+    std::vector<uint8_t> before = mem.bytes;
+    mem.failRead = FAKE_BASE + 0x1800;
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x1000, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x1800, NOPS, 4));
+    CHECK(!b.Commit(mem));
+    CHECK(strcmp(b.Error(), "read failed") == 0);
+    CHECK(mem.bytes == before);
+    CHECK_EQ(mem.writes, 0);
+    CHECK_EQ(mem.prot[1], FAKE_RX);
+}
+
+TEST(patch_failed_write_rolls_back_everything)
+{
+    FakeMemory mem;
+    mem.prot[6] = FAKE_R;
+    std::vector<uint8_t> before = mem.bytes;
+    mem.failWrite = FAKE_BASE + 0x6000;     // third in address order, lands one byte
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x6000, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x0100, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x7000, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x0200, NOPS, 4));
+    CHECK(!b.Commit(mem));
+    CHECK(strcmp(b.Error(), "write failed") == 0);
+    CHECK_EQ(b.ErrorAddr(), FAKE_BASE + 0x6000);
+    CHECK(mem.bytes == before);
+    CHECK_EQ(mem.flips, 3);
+    CHECK_EQ(mem.restores, 3);
+    CHECK_EQ(mem.flushes, 0);
+    CHECK_EQ(mem.prot[0], FAKE_RX);
+    CHECK_EQ(mem.prot[6], FAKE_R);
+    CHECK_EQ(mem.prot[7], FAKE_RX);
+}
+
+TEST(patch_revert_and_single_commit)
+{
+    FakeMemory mem;
+    std::vector<uint8_t> before = mem.bytes;
+    PatchBatch b;
+    CHECK(b.Add(FAKE_BASE + 0x0300, NOPS, 4));
+    CHECK(b.Add(FAKE_BASE + 0x8FFE, NOPS, 4));
+    CHECK(!b.Revert(mem));
+    CHECK(b.Commit(mem));
+    CHECK(mem.bytes != before);
+
+    CHECK(!b.Commit(mem));
+    CHECK(strcmp(b.Error(), "batch already committed") == 0);
+    CHECK(!b.Add(FAKE_BASE, NOPS, 1));
+
+    CHECK(b.Revert(mem));
+    CHECK(mem.bytes == before);
+    CHECK_EQ(mem.prot[8], FAKE_RX);
+    CHECK_EQ(mem.prot[9], FAKE_RX);
+    CHECK(!b.Revert(mem));
+}
+
+TEST(patch_jmp5_and_pointer_encoding)
+{
+    FakeMemory mem;
+    PatchBatch b;
+    uintptr_t from = FAKE_BASE + 0x100, back = FAKE_BASE + 0x40;
+    CHECK(b.AddJmp5(from, FAKE_BASE + 0x2000));
+    CHECK(b.AddJmp5(from + 0x10, back));
+    uintptr_t slot = FAKE_BASE + 0x3000;
+    void* prev = nullptr;
+    void* origPtr;
+    memcpy(&origPtr, mem.At(slot), sizeof(origPtr));
+    CHECK(b.AddPointer((void**)slot, (void*)(uintptr_t)0x12345678, &prev));
+    CHECK(b.Commit(mem));
+
+    int32_t rel;
+    CHECK_EQ(*mem.At(from), 0xE9);
+    memcpy(&rel, mem.At(from + 1), 4);
+    CHECK_EQ(rel, 0x2000 - 0x100 - 5);
+    CHECK_EQ(*mem.At(from + 0x10), 0xE9);
+    memcpy(&rel, mem.At(from + 0x11), 4);
+    CHECK_EQ(rel, -(0x100 + 0x10 - 0x40) - 5);
+
+    void* now;
+    memcpy(&now, mem.At(slot), sizeof(now));
+    CHECK_EQ((uintptr_t)now, 0x12345678);
+    CHECK(prev == origPtr);
+}
+
+#ifndef _WIN32
+// The mapping's perms field for addr, e.g. "r--p".
+static bool MapsPerms(uintptr_t addr, char perms[5])
+{
+    FILE* f = fopen("/proc/self/maps", "r");
+    if (!f) return false;
+    char line[4096];
+    bool found = false;
+    unsigned long lo, hi;
+    while (!found && fgets(line, sizeof(line), f))
+        found = sscanf(line, "%lx-%lx %4s", &lo, &hi, perms) == 3 && addr >= lo && addr < hi;
+    fclose(f);
+    return found;
+}
+
+TEST(patch_process_memory_restores_original_protection)
+{
+    size_t ps = (size_t)sysconf(_SC_PAGESIZE);
+    uint8_t* p = (uint8_t*)mmap(nullptr, ps * 3, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(p != MAP_FAILED);
+    if (p == MAP_FAILED) return;
+    memset(p, 0xCC, ps * 3);
+    // Distinct protections so neighbouring mappings don't merge.
+    mprotect(p, ps, PROT_READ);
+    mprotect(p + ps * 2, ps, PROT_READ | PROT_EXEC);
+
+    PatchBatch b;
+    CHECK(b.Add((uintptr_t)p + 8, NOPS, 4));
+    CHECK(b.Add((uintptr_t)p + ps + 8, NOPS, 4));
+    CHECK(b.Add((uintptr_t)p + ps * 2 + 8, NOPS, 4));
+    CHECK(b.Commit(Patch_ProcessMemory()));
+    CHECK(memcmp(p + 8, NOPS, 4) == 0);
+    CHECK(memcmp(p + ps + 8, NOPS, 4) == 0);
+    CHECK(memcmp(p + ps * 2 + 8, NOPS, 4) == 0);
+
+    char perms[5] = {};
+    CHECK(MapsPerms((uintptr_t)p, perms) && strncmp(perms, "r--", 3) == 0);
+    CHECK(MapsPerms((uintptr_t)p + ps, perms) && strncmp(perms, "rw-", 3) == 0);
+    CHECK(MapsPerms((uintptr_t)p + ps * 2, perms) && strncmp(perms, "r-x", 3) == 0);
+
+    CHECK(b.Revert(Patch_ProcessMemory()));
+    CHECK_EQ(p[8], 0xCC);
+    CHECK(MapsPerms((uintptr_t)p, perms) && strncmp(perms, "r--", 3) == 0);
+    munmap(p, ps * 3);
+}
+#endif
@@ -0,0 +1,174 @@
+// test_pe_scan.cpp - PE header parsing and the pointer-run scanner
+#include "test.h"
+#include "mock_engine.h"
+#include "pe_scan.h"
+
+// First longest run, dword by dword.
+static PtrRun RefRun(const uint8_t* p, size_t len, uint32_t rva0, uint32_t lo, uint32_t hi)
+{
+    PtrRun best = { 0, 0 };
+    int cur = 0;
+    for (size_t i = 0; i < len / 4; i++)
+    {
+        uint32_t v;
+        memcpy(&v, p + i * 4, 4);
+        cur = v >= lo && v < hi ? cur + 1 : 0;
+        if (cur > best.count) { best.count = cur; best.rva = rva0 + (uint32_t)(i + 1 - cur) * 4; }
+    }
+    return best;
+}
+
+TEST(pe_parse_rejects_bad_headers)
+{
+    MockPe pe;
+    pe.AddSection(".text", 0x1000, MOCK_SCN_TEXT);
+    std::vector<uint8_t> img(pe.Data(), pe.Data() + pe.Size());
+    PeImage out;
+    CHECK(Pe_Parse(img.data(), img.size(), true, out));
+
+    CHECK(!Pe_Parse(nullptr, img.size(), true, out));
+    CHECK(!Pe_Parse(img.data(), 0x3F, true, out));
+
+    std::vector<uint8_t> bad = img;
+    bad[0] = 'X';                                       // MZ
+    CHECK(!Pe_Parse(bad.data(), bad.size(), true, out));
+
+    bad = img;
+    bad[0x80] = 'X';                                    // PE\0\0
+    CHECK(!Pe_Parse(bad.data(), bad.size(), true, out));
+
+    bad = img;
+    bad[0x80 + 24] = 0x0B; bad[0x80 + 25] = 0x02;       // PE32+
+    CHECK(!Pe_Parse(bad.data(), bad.size(), true, out));
+
+    bad = img;
+    uint32_t lfanew = 0xFFFFFF00;                       // e_lfanew past the end
+    memcpy(bad.data() + 0x3C, &lfanew, 4);
+    CHECK(!Pe_Parse(bad.data(), bad.size(), true, out));
+
+    bad = img;
+    uint16_t nsec = PE_MAX_SECTIONS + 1;
+    memcpy(bad.data() + 0x80 + 6, &nsec, 2);
+    CHECK(!Pe_Parse(bad.data(), bad.size(), true, out));
+
+    // Section table cut off by the buffer.
+    CHECK(!Pe_Parse(img.data(), 0x80 + 24 + 0xE0 + 20, true, out));
+}
+
+TEST(pe_section_data_clamps)
+{
+    MockPe pe;
+    pe.AddSection(".text", 0x800, MOCK_SCN_TEXT);
+    uint32_t data = pe.AddSection(".data", 0x2000, MOCK_SCN_DATA);
+    PeImage img;
+    CHECK(Pe_Parse(pe.Data(), pe.Size(), true, img));
+
+    size_t len = 0;
+    CHECK(Pe_SectionData(img, img.sections[1], len) == pe.Data() + data);
+    CHECK_EQ(len, 0x2000);
+
+    // Truncated capture: the tail of .data is missing.
+    PeImage cut;
+    CHECK(Pe_Parse(pe.Data(), data + 0x100, true, cut));
+    CHECK(Pe_SectionData(cut, cut.sections[1], len));
+    CHECK_EQ(len, 0x100);
+    CHECK(!Pe_Parse(pe.Data(), 0x10, true, cut));
+
+    // Entirely outside the buffer.
+    PeSection far = img.sections[1];
+    far.rva = 0x7FFFF000;
+    CHECK(!Pe_SectionData(img, far, len));
+    CHECK_EQ(len, 0);
+}
+
+TEST(pe_is_data_section)
+{
+    MockPe pe;
+    pe.AddSection(".text",  0x100, MOCK_SCN_TEXT);
+    pe.AddSection(".rdata", 0x100, MOCK_SCN_RDATA);
+    pe.AddSection(".data",  0x100, MOCK_SCN_DATA);
+    pe.AddSection(".bss",   0x100, MOCK_SCN_BSS);
+    pe.AddSection(".xdata", 0x100, MOCK_SCN_DATA | MOCK_SCN_TEXT);
+    PeImage img;
+    CHECK(Pe_Parse(pe.Data(), pe.Size(), true, img));
+    CHECK(!Pe_IsDataSection(img.sections[0]));
+    CHECK(Pe_IsDataSection(img.sections[1]));
+    CHECK(Pe_IsDataSection(img.sections[2]));
+    CHECK(!Pe_IsDataSection(img.sections[3]));
+    CHECK(!Pe_IsDataSection(img.sections[4]));
+}
+
+TEST(pe_pointer_run_matches_reference)
+{
+    // Random lengths and offsets exercise the vector body, the scalar tail
+    // and runs crossing block boundaries; the ranges cover the sign bit
+    // that the SIMD compares bias around.
+    static const uint32_t ranges[][2] = {
+        { 0x01D00000, 0x01E00000 }, { 0x7FFFFFF0, 0x80000010 },
+        { 0x80000000, 0xFFFFFFFF }, { 0, 0x100 }, { 0, 0xFFFFFFFF },
+    };
+    MockRng rng(7);
+    std::vector<uint32_t> buf(4096 + 8);
+    for (int iter = 0; iter < 400; iter++)
+    {
+        uint32_t lo = ranges[iter % 5][0], hi = ranges[iter % 5][1];
+        for (uint32_t& v : buf)
+        {
+            uint32_t r = rng.Below(8);
+            v = r < 5 ? lo + rng.Below(hi - lo) : rng.Next();   // mostly in range
+        }
+        size_t off = rng.Below(4), len = rng.Below(4096 * 4 + 1);
+        const uint8_t* p = (const uint8_t*)buf.data() + off * 4;
+        PtrRun got = FindPointerRun(p, len, 0x1000, lo, hi);
+        PtrRun ref = RefRun(p, len, 0x1000, lo, hi);
+        CHECK_EQ(got.count, ref.count);
+        if (ref.count) CHECK_EQ(got.rva, ref.rva);
+    }
+}
+
+TEST(pe_pointer_run_edges)
+{
+    uint32_t v[16];
+    for (int i = 0; i < 16; i++) v[i] = 0x100 + i;
+    CHECK_EQ(FindPointerRun(nullptr, 64, 0, 0, 0x1000).count, 0);
+    CHECK_EQ(FindPointerRun((uint8_t*)v, 64, 0, 0x1000, 0x1000).count, 0);   // empty range
+    CHECK_EQ(FindPointerRun((uint8_t*)v, 3, 0, 0, 0x1000).count, 0);         // under one dword
+    PtrRun r = FindPointerRun((uint8_t*)v, 63, 0x2000, 0, 0x1000);            // partial dword ignored
+    CHECK_EQ(r.count, 15);
+    CHECK_EQ(r.rva, 0x2000);
+    // hi is exclusive
+    r = FindPointerRun((uint8_t*)v, 64, 0, 0x100, 0x10F);
+    CHECK_EQ(r.count, 15);
+    // Ties go to the first run.
+    uint32_t t[9] = { 1, 1, 0, 1, 1, 0, 0, 1, 1 };
+    r = FindPointerRun((uint8_t*)t, sizeof(t), 0, 1, 2);
+    CHECK_EQ(r.count, 2);
+    CHECK_EQ(r.rva, 0);
+}
+
+TEST(pe_find_pointer_run_over_sections)
+{
+    // The engine's function table: a run of pointers into hw.dll sitting in
+    // mp.dll's .data. Longer decoys in .text and .bss must not count.
+    const uint32_t hwLo = 0x03000000, hwHi = 0x03800000;
+    MockPe pe;
+    uint32_t text  = pe.AddSection(".text",  0x4000, MOCK_SCN_TEXT);
+    uint32_t rdata = pe.AddSection(".rdata", 0x2000, MOCK_SCN_RDATA);
+    uint32_t data  = pe.AddSection(".data",  0x3000, MOCK_SCN_DATA);
+    for (int i = 0; i < 300; i++) pe.Put32(text + 4 * i, hwLo + 16 * i);
+    for (int i = 0; i < 40;  i++) pe.Put32(rdata + 0x100 + 4 * i, hwLo + 16 * i);
+    for (int i = 0; i < 218; i++) pe.Put32(data + 0x840 + 4 * i, hwLo + 32 * i);
+
+    PeImage img;
+    CHECK(Pe_Parse(pe.Data(), pe.Size(), true, img));
+    PtrRun r = Pe_FindPointerRun(img, hwLo, hwHi);
+    CHECK_EQ(r.count, 218);
+    CHECK_EQ(r.rva, data + 0x840);
+
+    // Same answer from the file layout.
+    std::vector<uint8_t> file = pe.FileImage();
+    CHECK(Pe_Parse(file.data(), file.size(), false, img));
+    r = Pe_FindPointerRun(img, hwLo, hwHi);
+    CHECK_EQ(r.count, 218);
+    CHECK_EQ(r.rva, data + 0x840);
+}
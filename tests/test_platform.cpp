@@ -0,0 +1,77 @@
+// test_platform.cpp - platform.h on the host OS
+#include "test.h"
+#include "platform/platform.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+TEST(platform_file_write_then_map)
+{
+    const char* path = Test_TempPath("platform.bin");
+    void* f = Plat_FileCreate(path);
+    CHECK(f);
+    if (!f) return;
+    CHECK(Plat_FileWrite(f, "hello ", 6));
+    CHECK(Plat_FileWrite(f, "world", 5));
+    Plat_FileFlush(f);
+    Plat_FileClose(f);
+
+    size_t size = 0;
+    void* h = nullptr;
+    const void* p = Plat_MapFile(path, size, h);
+    CHECK(p && size == 11);
+    if (p) CHECK(!memcmp(p, "hello world", 11));
+    Plat_UnmapFile(h);
+
+    // Create truncates; an empty file maps to null.
+    Plat_FileClose(Plat_FileCreate(path));
+    CHECK(!Plat_MapFile(path, size, h));
+    CHECK(!Plat_MapFile(Test_TempPath("platform.missing"), size, h));
+}
+
+TEST(platform_safe_copy)
+{
+    uint32_t src = 0x12345678, dst = 0;
+    CHECK(Plat_SafeRead(&dst, (uintptr_t)&src, 4));
+    CHECK_EQ(dst, 0x12345678);
+    CHECK(Plat_SafeWrite((uintptr_t)&dst, "\x01\x02\x03\x04", 4));
+    CHECK_EQ(dst, 0x04030201);
+    // The zero page is never mapped.
+    CHECK(!Plat_SafeRead(&dst, 16, 4));
+    CHECK(!Plat_SafeWrite(16, &src, 4));
+}
+
+struct ThreadCtx
+{
+    void* ev;
+    int   value;
+};
+
+TEST(platform_thread_and_event)
+{
+    ThreadCtx ctx = { Plat_EventCreate(), 0 };
+    CHECK(ctx.ev);
+    CHECK(!Plat_EventWait(ctx.ev, 1));     // auto-reset, starts clear
+    CHECK(Plat_StartThread([](void* arg)
+    {
+        ThreadCtx* c = (ThreadCtx*)arg;
+        c->value = 42;
+        Plat_EventSet(c->ev);
+    }, &ctx));
+    CHECK(Plat_EventWait(ctx.ev, 5000));
+    CHECK_EQ(ctx.value, 42);
+    CHECK(!Plat_EventWait(ctx.ev, 1));
+}
+
+TEST(platform_getenv)
+{
+    char buf[4];
+    CHECK(!Plat_GetEnv("CSNZ_TEST_SURELY_UNSET_VARIABLE", buf, sizeof(buf)));
+#ifndef _WIN32
+    setenv("CSNZ_TEST_ENV", "abc", 1);
+    CHECK(Plat_GetEnv("CSNZ_TEST_ENV", buf, sizeof(buf)));
+    CHECK(!strcmp(buf, "abc"));
+    setenv("CSNZ_TEST_ENV", "abcd", 1);
+    CHECK(!Plat_GetEnv("CSNZ_TEST_ENV", buf, sizeof(buf)));   // needs 5 bytes
+#endif
+}
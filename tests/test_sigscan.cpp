@@ -0,0 +1,176 @@
+// test_sigscan.cpp - pattern parsing, anchoring, the one-pass scan and .sig files
+#include "test.h"
+#include "mock_engine.h"
+#include "sigscan.h"
+#include <cstdio>
+#include <string>
+
+// Every match position of one pattern, the slow way.
+static SigResult RefScan(const uint8_t* code, size_t len, const char* pattern)
+{
+    uint8_t b[SIG_MAX_LEN], m[SIG_MAX_LEN];
+    int n = 0;
+    SigResult r = { 0, 0 };
+    if (!Sig_Parse(pattern, b, m, n)) return r;
+    for (size_t i = 0; i + n <= len; i++)
+    {
+        int j = 0;
+        while (j < n && (code[i + j] & m[j]) == b[j]) j++;
+        if (j == n && r.matches++ == 0) r.rva = (uint32_t)i;
+    }
+    return r;
+}
+
+static std::string HexPattern(const uint8_t* p, int n, MockRng& rng)
+{
+    std::string s;
+    char buf[4];
+    for (int i = 0; i < n; i++)
+    {
+        bool wild = i > 0 && i < n - 1 && rng.Below(4) == 0;
+        snprintf(buf, sizeof(buf), wild ? "?? " : "%02X ", p[i]);
+        s += buf;
+    }
+    return s;
+}
+
+TEST(sig_parse)
+{
+    uint8_t b[SIG_MAX_LEN], m[SIG_MAX_LEN];
+    int n = 0;
+    CHECK(Sig_Parse("8B 0D ?? ? 85\tc9", b, m, n));
+    CHECK_EQ(n, 6);
+    CHECK(b[0] == 0x8B && m[0] == 0xFF && m[2] == 0 && m[3] == 0 && b[5] == 0xC9);
+    CHECK(!Sig_Parse("?? ??", b, m, n));          // nothing to anchor on
+    CHECK(!Sig_Parse("8B 0G", b, m, n));
+    CHECK(!Sig_Parse("8", b, m, n));
+    std::string longPat;
+    for (int i = 0; i <= SIG_MAX_LEN; i++) longPat += "90 ";
+    CHECK(!Sig_Parse(longPat.c_str(), b, m, n));
+}
+
+TEST(sig_anchor_is_rarest_fixed_byte)
+{
+    uint32_t freq[256] = {};
+    freq[0x8B] = 900; freq[0x0D] = 40; freq[0x85] = 300; freq[0xC9] = 40; freq[0x5F] = 0;
+    uint8_t b[SIG_MAX_LEN], m[SIG_MAX_LEN];
+    int n = 0;
+    CHECK(Sig_Parse("8B 0D ?? ?? ?? ?? 85 C9", b, m, n));
+    CHECK_EQ(Sig_PickAnchor(b, m, n, freq), 1);          // 0D, first of the 40s
+    CHECK(Sig_Parse("8B ?? 5F 85", b, m, n));
+    CHECK_EQ(Sig_PickAnchor(b, m, n, freq), 2);          // never seen at all
+    m[0] = m[2] = m[3] = 0;
+    CHECK_EQ(Sig_PickAnchor(b, m, n, freq), -1);
+}
+
+TEST(sig_scan_matches_reference)
+{
+    // Few patterns take the SSE2 filter, many (more anchor bytes than it
+    // holds) the byte table; both must agree with the reference.
+    MockRng rng(3);
+    std::vector<uint8_t> code(40000);
+    for (int round = 0; round < 6; round++)
+    {
+        // Skewed bytes so anchor choice matters, like real code.
+        for (uint8_t& c : code) c = rng.Below(3) ? (uint8_t)(0x80 + rng.Below(16)) : (uint8_t)rng.Next();
+        int n = round < 3 ? 4 : 60;
+        std::vector<std::string> pats(n);
+        std::vector<SigDef> defs(n);
+        for (int i = 0; i < n; i++)
+        {
+            int len = 3 + (int)rng.Below(12);
+            size_t at = rng.Below((uint32_t)(code.size() - len));
+            if (i == 0) at = 0;                          // anchor past position 0
+            if (i == 1) at = code.size() - len;          // ends at the buffer end
+            pats[i] = HexPattern(&code[at], len, rng);
+            if (i == 2) pats[i] = "81 82";               // many matches
+            defs[i] = { "s", pats[i].c_str(), SIG_MATCH, 0 };
+        }
+        std::vector<SigResult> got(n);
+        CHECK(Sig_ScanAll(code.data(), code.size(), 0, 0, defs.data(), n, got.data()));
+        for (int i = 0; i < n; i++)
+        {
+            SigResult ref = RefScan(code.data(), code.size(), pats[i].c_str());
+            CHECK_EQ(got[i].matches, ref.matches);
+            CHECK_EQ(got[i].rva, ref.rva);
+        }
+    }
+}
+
+TEST(sig_scan_operands)
+{
+    //   +0  A1 <abs32>        mov eax, [pGlobals]
+    //   +5  E8 <rel32>        call UTIL_WeaponTimeBase
+    uint8_t code[64];
+    memset(code, 0x90, sizeof(code));
+    uint32_t abs = 0x11E51BCC, rel = 0x00000100;
+    code[16] = 0xA1; memcpy(code + 17, &abs, 4);
+    code[21] = 0xE8; memcpy(code + 22, &rel, 4);
+    code[26] = 0x5D; code[27] = 0xC3;
+
+    SigDef defs[] = {
+        { "pGlobals", "A1 ?? ?? ?? ?? E8",    SIG_ABS32, 1 },
+        { "call",     "E8 ?? ?? ?? ?? 5D C3", SIG_REL32, 1 },
+        { "match",    "5D C3",                SIG_MATCH, 1 },
+        { "none",     nullptr,                SIG_MATCH, 0 },
+        { "missing",  "0F 0B 0F 0B",          SIG_MATCH, 0 },
+    };
+    SigResult res[5] = {};
+    CHECK(Sig_ScanAll(code, sizeof(code), 0x1000, 0x10000000, defs, 5, res));
+    CHECK_EQ(res[0].matches, 1);
+    CHECK_EQ(res[0].rva, 0x1E51BCC);
+    CHECK_EQ(res[1].rva, 0x1000 + 21 + 5 + 0x100);
+    CHECK_EQ(res[2].rva, 0x1000 + 26 + 1);
+    CHECK_EQ(res[3].matches, 0);
+    CHECK_EQ(res[4].matches, 0);
+}
+
+TEST(sig_scan_image_code_sections_only)
+{
+    MockPe pe(0x10000000);
+    uint32_t text = pe.AddSection(".text", 0x2000, MOCK_SCN_TEXT);
+    uint32_t data = pe.AddSection(".data", 0x1000, MOCK_SCN_DATA);
+    const uint8_t sig[] = { 0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x1C, 0xD9, 0x05 };
+    pe.Put(text + 0x1230, sig, sizeof(sig));
+    pe.Put(data + 0x40, sig, sizeof(sig));          // same bytes in data: not code
+
+    std::vector<uint8_t> file = pe.FileImage();
+    PeImage img;
+    CHECK(Pe_Parse(file.data(), file.size(), false, img));
+    SigDef def = { "fn", "55 8B EC 83 EC 1C D9 05", SIG_MATCH, 0 };
+    SigResult res = {};
+    CHECK(Sig_ScanImage(img, &def, 1, &res));
+    CHECK_EQ(res.matches, 1);
+    CHECK_EQ(res.rva, text + 0x1230);
+}
+
+TEST(sig_load_file_caller_pool)
+{
+    const char* path = Test_TempPath("sigs.sig");
+    FILE* f = fopen(path, "w");
+    CHECK(f);
+    if (!f) return;
+    fputs("# name kind off pattern\n"
+          "pGlobals abs32 1 A1 ?? ?? ?? ?? 85 C0\r\n"
+          "bogus nope 0 90\n"
+          "short\n"
+          "fire rel32 -2 E8 ?? ?? ?? ?? 5D\n", f);
+    fclose(f);
+
+    SigDef defs[8];
+    char pool[128];
+    // Each call reuses the pool from the start, so loading again (e.g. after
+    // the file changed) can't run it dry.
+    for (int i = 0; i < 100; i++)
+        CHECK_EQ(Sig_LoadFile(path, defs, 8, pool, sizeof(pool)), 2);
+    CHECK(!strcmp(defs[0].name, "pGlobals"));
+    CHECK(!strcmp(defs[0].pattern, "A1 ?? ?? ?? ?? 85 C0"));
+    CHECK_EQ(defs[0].operand, SIG_ABS32);
+    CHECK_EQ(defs[1].operand, SIG_REL32);
+    CHECK_EQ(defs[1].opOffset, -2);
+
+    CHECK_EQ(Sig_LoadFile(path, defs, 1, pool, sizeof(pool)), 1);   // maxDefs
+    CHECK_EQ(Sig_LoadFile(path, defs, 8, pool, 40), 1);             // pool too small for the second
+    CHECK_EQ(Sig_LoadFile(Test_TempPath("sigs.missing"), defs, 8, pool, sizeof(pool)), 0);
+    remove(path);
+}
@@ -0,0 +1,135 @@
+// test_spatial_grid.cpp - SpatialGrid queries against a brute-force scan
+#include "test.h"
+#include "mock_engine.h"
+#include "spatial_grid.h"
+#include <algorithm>
+#include <vector>
+
+struct Origin { float x, y, z; bool live; };
+
+static std::vector<int> Sorted(const int* ids, int n)
+{
+    std::vector<int> v(ids, ids + n);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+static std::vector<int> BruteRadius(const std::vector<Origin>& ents, float x, float y, float z, float r)
+{
+    std::vector<int> out;
+    for (int i = 0; i < (int)ents.size(); i++)
+    {
+        const Origin& e = ents[i];
+        float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+        if (e.live && dx * dx + dy * dy + dz * dz <= r * r) out.push_back(i);
+    }
+    return out;
+}
+
+static std::vector<int> BruteBox(const std::vector<Origin>& ents, const float* mins, const float* maxs)
+{
+    std::vector<int> out;
+    for (int i = 0; i < (int)ents.size(); i++)
+    {
+        const Origin& e = ents[i];
+        if (e.live && e.x >= mins[0] && e.x <= maxs[0] && e.y >= mins[1] && e.y <= maxs[1]
+            && e.z >= mins[2] && e.z <= maxs[2])
+            out.push_back(i);
+    }
+    return out;
+}
+
+TEST(spatial_grid_matches_brute_force_over_frames)
+{
+    // Zombies wandering a map centred on the origin, some crossing cell
+    // edges every frame, some dying and respawning.
+    const int N = 300;
+    MockRng rng(25);
+    SpatialGrid grid(N);
+    std::vector<Origin> ents(N);
+    for (Origin& e : ents)
+    {
+        e.x = (rng.Unit() - 0.5f) * 4096.0f;
+        e.y = (rng.Unit() - 0.5f) * 4096.0f;
+        e.z = (rng.Unit() - 0.5f) * 512.0f;
+        e.live = true;
+    }
+
+    std::vector<int> buf(N);
+    for (int frame = 0; frame < 200; frame++)
+    {
+        grid.BeginFrame();
+        for (int i = 0; i < N; i++)
+        {
+            Origin& e = ents[i];
+            if (rng.Below(50) == 0) e.live = !e.live;
+            e.x += (rng.Unit() - 0.5f) * 200.0f;
+            e.y += (rng.Unit() - 0.5f) * 200.0f;
+            if (e.live) grid.Update(i, e.x, e.y, e.z);
+        }
+        grid.EndFrame();
+        int live = 0;
+        for (const Origin& e : ents) live += e.live;
+        CHECK_EQ(grid.Count(), live);
+
+        float x = (rng.Unit() - 0.5f) * 4096.0f, y = (rng.Unit() - 0.5f) * 4096.0f;
+        float r = 50.0f + rng.Unit() * 600.0f;
+        int n = grid.QueryRadius(x, y, 0.0f, r, buf.data(), N);
+        CHECK(Sorted(buf.data(), n) == BruteRadius(ents, x, y, 0.0f, r));
+
+        float mins[3] = { x - r, y - r * 0.5f, -100.0f }, maxs[3] = { x + r * 0.5f, y + r, 100.0f };
+        n = grid.QueryBox(mins, maxs, buf.data(), N);
+        CHECK(Sorted(buf.data(), n) == BruteBox(ents, mins, maxs));
+    }
+}
+
+TEST(spatial_grid_short_buffer_reports_full_count)
+{
+    SpatialGrid grid(16);
+    grid.BeginFrame();
+    for (int i = 0; i < 10; i++) grid.Update(i, i * 10.0f, 0.0f, 0.0f);
+    grid.EndFrame();
+    int out[4] = { -1, -1, -1, -1 };
+    CHECK_EQ(grid.QueryRadius(0.0f, 0.0f, 0.0f, 1000.0f, out, 3), 10);
+    for (int i = 0; i < 3; i++) CHECK(out[i] >= 0 && out[i] < 10);
+    CHECK_EQ(out[3], -1);
+}
+
+TEST(spatial_grid_remove_clear_and_bad_ids)
+{
+    SpatialGrid grid(8);
+    int out[8];
+    grid.BeginFrame();
+    grid.Update(-1, 0.0f, 0.0f, 0.0f);
+    grid.Update(8, 0.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 4; i++) grid.Update(i, 0.0f, 0.0f, (float)i);
+    CHECK_EQ(grid.Count(), 4);
+    grid.Remove(2);
+    grid.Remove(2);
+    grid.Remove(7);
+    CHECK_EQ(grid.Count(), 3);
+    CHECK_EQ(grid.QueryRadius(0.0f, 0.0f, 0.0f, 10.0f, out, 8), 3);
+    // z is filtered per entity.
+    CHECK_EQ(grid.QueryRadius(0.0f, 0.0f, 3.0f, 0.5f, out, 8), 1);
+    CHECK_EQ(out[0], 3);
+    grid.Clear();
+    CHECK_EQ(grid.Count(), 0);
+    CHECK_EQ(grid.QueryRadius(0.0f, 0.0f, 0.0f, 10.0f, out, 8), 0);
+}
+
+TEST(spatial_grid_huge_shapes_and_far_origins)
+{
+    // A box over more columns than buckets takes the plain scan; origins
+    // far outside any map are clamped, not lost.
+    SpatialGrid grid(4);
+    grid.BeginFrame();
+    grid.Update(0, -100000.0f, 0.0f, 0.0f);
+    grid.Update(1, 100000.0f, 100000.0f, 0.0f);
+    grid.Update(2, 1.0e30f, -1.0e30f, 0.0f);
+    grid.EndFrame();
+    int out[4];
+    float mins[3] = { -200000.0f, -200000.0f, -1.0f }, maxs[3] = { 200000.0f, 200000.0f, 1.0f };
+    CHECK(Sorted(out, grid.QueryBox(mins, maxs, out, 4)) == std::vector<int>({ 0, 1 }));
+    CHECK_EQ(grid.QueryRadius(1.0e30f, -1.0e30f, 0.0f, 1.0f, out, 4), 1);
+    CHECK_EQ(out[0], 2);
+}
@@ -0,0 +1,161 @@
+// test_spread.cpp - Philox known answers, SIMD/scalar agreement, distribution
+#include "test.h"
+#include "spread.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Random123's kat_vectors for philox4x32_10: counter, key, expected.
+TEST(spread_philox_known_answers)
+{
+    static const uint32_t kat[][10] = {
+        { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+          0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+        { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+          0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+        { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0,
+          0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 },
+    };
+    for (const uint32_t* v : kat)
+    {
+        uint32_t c[4] = { v[0], v[1], v[2], v[3] };
+        Spread_Philox(c, v[4], v[5]);
+        for (int i = 0; i < 4; i++) CHECK_EQ(c[i], v[6 + i]);
+    }
+}
+
+TEST(spread_simd_matches_scalar)
+{
+    float x[37], y[37], sx[37], sy[37];
+    for (uint32_t seed = 0; seed < 64; seed++)
+        for (int n = 0; n <= 37; n += (n < 9 ? 1 : 7))
+        {
+            Spread_Offsets(seed * 0x9E3779B9u, seed & 3, n, x, y);
+            Spread_OffsetsScalar(seed * 0x9E3779B9u, seed & 3, n, sx, sy);
+            CHECK(memcmp(x, sx, n * sizeof(float)) == 0);
+            CHECK(memcmp(y, sy, n * sizeof(float)) == 0);
+        }
+
+    // Directions, against the formula applied to the scalar offsets; 23
+    // pellets run through eight-, four- and one-wide steps.
+    SpreadParams p = { 0.6f, 0.8f, 0.0f, 0.8f, -0.6f, 0.0f, 0.0f, 0.0f, 1.0f,
+                       0.0436f, 0.0218f, 12345, 0 };
+    float dx[23], dy[23], dz[23];
+    Spread_Directions(p, 23, dx, dy, dz);
+    Spread_OffsetsScalar(p.seed, p.stream, 23, sx, sy);
+    for (int i = 0; i < 23; i++)
+    {
+        float a = sx[i] * p.coneX, b = sy[i] * p.coneY;
+        CHECK(dx[i] == (p.fx + a * p.rx) + b * p.ux);
+        CHECK(dy[i] == (p.fy + a * p.ry) + b * p.uy);
+        CHECK(dz[i] == (p.fz + a * p.rz) + b * p.uz);
+    }
+}
+
+TEST(spread_pellets_are_independent_of_count)
+{
+    // Pellet i is a function of (seed, stream, i) alone: prediction can
+    // draw any subset and get the server's numbers.
+    float all[32], ally[32], one[1], oney[1];
+    Spread_Offsets(777, 0, 32, all, ally);
+    for (int i = 1; i <= 32; i++)
+    {
+        float x[32], y[32];
+        Spread_Offsets(777, 0, i, x, y);
+        CHECK(x[i - 1] == all[i - 1] && y[i - 1] == ally[i - 1]);
+    }
+    Spread_Offsets(777, 0, 1, one, oney);
+    CHECK(one[0] == all[0] && oney[0] == ally[0]);
+
+    float other[32], othery[32];
+    Spread_Offsets(777, 1, 32, other, othery);
+    int same = 0;
+    for (int i = 0; i < 32; i++) same += other[i] == all[i];
+    CHECK(same < 2);
+}
+
+// Triangular on [-1, 1): CDF of the sum of two uniforms on [-0.5, 0.5).
+static double TriCdf(double s)
+{
+    if (s <= -1.0) return 0.0;
+    if (s >= 1.0)  return 1.0;
+    return s < 0.0 ? (s + 1.0) * (s + 1.0) / 2.0 : 1.0 - (1.0 - s) * (1.0 - s) / 2.0;
+}
+
+static double Correlation(const std::vector<float>& a, const std::vector<float>& b)
+{
+    double sa = 0, sb = 0, sab = 0, saa = 0, sbb = 0;
+    size_t n = a.size() < b.size() ? a.size() : b.size();
+    for (size_t i = 0; i < n; i++)
+    {
+        sa += a[i]; sb += b[i]; sab += (double)a[i] * b[i];
+        saa += (double)a[i] * a[i]; sbb += (double)b[i] * b[i];
+    }
+    double cov = sab / n - (sa / n) * (sb / n);
+    return cov / sqrt((saa / n - (sa / n) * (sa / n)) * (sbb / n - (sb / n) * (sb / n)));
+}
+
+// Fixed seeds, so the bounds below are checked once and then hold; they
+// sit at about p = 0.001 for a good generator.
+TEST(spread_distribution)
+{
+    const int SHOTS = 4096, PELLETS = 16, N = SHOTS * PELLETS;
+    std::vector<float> x(N), y(N);
+    for (int s = 0; s < SHOTS; s++)
+        Spread_Offsets((uint32_t)s * 2654435761u + 17, 0, PELLETS, &x[s * PELLETS], &y[s * PELLETS]);
+
+    const int BINS = 20;
+    for (const std::vector<float>* v : { &x, &y })
+    {
+        double sum = 0, sum2 = 0;
+        int hist[BINS] = {};
+        for (float f : *v)
+        {
+            CHECK(f >= -1.0f && f < 1.0f);
+            sum += f;
+            sum2 += (double)f * f;
+            int b = (int)((f + 1.0f) * (BINS / 2));
+            hist[b < BINS ? b : BINS - 1]++;
+        }
+        double mean = sum / N, var = sum2 / N - mean * mean;
+        CHECK(fabs(mean) < 4.0 * sqrt(1.0 / 6.0 / N));
+        CHECK(fabs(var - 1.0 / 6.0) < 0.02 / 6.0);
+
+        double chi2 = 0;
+        for (int b = 0; b < BINS; b++)
+        {
+            double lo = -1.0 + 2.0 * b / BINS, hi = lo + 2.0 / BINS;
+            double want = (TriCdf(hi) - TriCdf(lo)) * N;
+            chi2 += (hist[b] - want) * (hist[b] - want) / want;
+        }
+        CHECK(chi2 < 43.8);   // 19 degrees of freedom
+    }
+
+    // No link between the axes of a pellet, neighbouring pellets, or the
+    // same pellet of consecutive shots.
+    double bound = 4.0 / sqrt((double)N);
+    CHECK(fabs(Correlation(x, y)) < bound);
+    std::vector<float> next(x.begin() + 1, x.end()), nextShot(x.begin() + PELLETS, x.end());
+    CHECK(fabs(Correlation(x, next)) < bound);
+    CHECK(fabs(Correlation(x, nextShot)) < bound);
+}
+
+TEST(spread_philox_words_uniform)
+{
+    // Top byte of every output word over sequential counters, the way
+    // pellets use them.
+    const int BLOCKS = 1 << 16;
+    int hist[4][256] = {};
+    for (uint32_t i = 0; i < (uint32_t)BLOCKS; i++)
+    {
+        uint32_t c[4] = { i, 0, 0, 0 };
+        Spread_Philox(c, 0x1234, SPREAD_KEY_HI);
+        for (int w = 0; w < 4; w++) hist[w][c[w] >> 24]++;
+    }
+    for (int w = 0; w < 4; w++)
+    {
+        double want = BLOCKS / 256.0, chi2 = 0;
+        for (int b = 0; b < 256; b++) chi2 += (hist[w][b] - want) * (hist[w][b] - want) / want;
+        CHECK(chi2 < 330.5);   // 255 degrees of freedom
+    }
+}
@@ -0,0 +1,164 @@
+// test_stub_arena.cpp - StubArena over real mmap'd pages
+#include "test.h"
+#include "stub_arena.h"
+#include "x86_len.h"
+#include <cstring>
+#include <vector>
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Forwards to the process backend, counting what goes through it.
+struct CountingPages : StubPages
+{
+    StubPages& real = Stub_ProcessPages();
+    int        reserves = 0, releases = 0, flushes = 0;
+    std::vector<uintptr_t> live;
+
+    size_t Granularity() override { return real.Granularity(); }
+
+    uintptr_t ReserveNear(uintptr_t lo, uintptr_t hi, uintptr_t pref, size_t size) override
+    {
+        uintptr_t p = real.ReserveNear(lo, hi, pref, size);
+        if (p) { reserves++; live.push_back(p); }
+        return p;
+    }
+
+    void Release(uintptr_t base, size_t size) override
+    {
+        releases++;
+        for (size_t i = 0; i < live.size(); i++)
+            if (live[i] == base) { live.erase(live.begin() + i); break; }
+        real.Release(base, size);
+    }
+
+    void FlushCode(uintptr_t addr, size_t len) override
+    {
+        flushes++;
+        real.FlushCode(addr, len);
+    }
+};
+
+static int NearTarget(int x) { return x * 3 + 1; }
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+TEST(stub_arena_stubs_execute)
+{
+    CountingPages pages;
+    StubArena arena(pages);
+    // mov eax, 0x1234 / ret
+    uint8_t* p = (uint8_t*)arena.Alloc(6);
+    CHECK(p);
+    if (!p) return;
+    static const uint8_t code[] = { 0xB8, 0x34, 0x12, 0x00, 0x00, 0xC3 };
+    memcpy(p, code, sizeof(code));
+    arena.Flush(p, sizeof(code));
+    CHECK_EQ(((int (*)())(void*)p)(), 0x1234);
+    CHECK_EQ(pages.flushes, 1);
+}
+
+TEST(stub_arena_near_stub_reaches_module_by_rel32)
+{
+    CountingPages pages;
+    StubArena arena(pages);
+    uintptr_t fn = (uintptr_t)&NearTarget;
+    uint8_t* p = (uint8_t*)arena.Alloc(STUB_LINE, fn, fn + 1);
+    CHECK(p);
+    if (!p) return;
+    int64_t d = (int64_t)fn - (int64_t)(uintptr_t)p;
+    CHECK(d > -0x7FFFFFFFll && d < 0x7FFFFFFFll);
+
+    // jmp NearTarget: the stub behaves exactly like the function.
+    p[0] = 0xE9;
+    CHECK(X86_PutRel32(p + 1, (uintptr_t)p + 5, fn));
+    arena.Flush(p, 5);
+    CHECK_EQ(((int (*)(int))(void*)p)(7), 22);
+}
+#endif
+
+TEST(stub_arena_lines_and_reuse)
+{
+    CountingPages pages;
+    StubArena arena(pages);
+    uint8_t* a = (uint8_t*)arena.Alloc(1);
+    uint8_t* b = (uint8_t*)arena.Alloc(STUB_LINE + 1);     // two lines
+    uint8_t* c = (uint8_t*)arena.Alloc(STUB_LINE);
+    CHECK(a && b && c);
+    if (!a || !b || !c) return;
+    CHECK_EQ((uintptr_t)a % STUB_LINE, 0);
+    CHECK_EQ(b - a, (long long)STUB_LINE);
+    CHECK_EQ(c - b, (long long)(2 * STUB_LINE));
+    CHECK_EQ(arena.LiveBytes(), 4 * STUB_LINE);
+    CHECK_EQ(arena.RegionCount(), 1);
+
+    // Freed lines trap.
+    memset(b, 0x90, 2 * STUB_LINE);
+    arena.Free(b);
+    CHECK_EQ(b[0], 0xCC);
+    CHECK_EQ(b[2 * STUB_LINE - 1], 0xCC);
+    CHECK_EQ(arena.LiveBytes(), 2 * STUB_LINE);
+
+    // Interior pointers and double frees are ignored.
+    arena.Free(c + 1);
+    arena.Free(b);
+    CHECK_EQ(arena.LiveBytes(), 2 * STUB_LINE);
+
+    // Freeing the newest allocation rolls the bump pointer back to it.
+    arena.Free(c);
+    CHECK(arena.Alloc(STUB_LINE) == c);
+    CHECK_EQ(pages.reserves, 1);
+}
+
+TEST(stub_arena_full_region_first_fit_then_new_region)
+{
+    CountingPages pages;
+    StubArena arena(pages);
+    size_t lines = pages.Granularity() / STUB_LINE;
+    std::vector<void*> all;
+    for (size_t i = 0; i < lines; i++) all.push_back(arena.Alloc(STUB_LINE));
+    CHECK(all.back() != nullptr);
+    CHECK_EQ(arena.RegionCount(), 1);
+    CHECK_EQ(arena.LiveBytes(), pages.Granularity());
+
+    // Two separate holes of one line: a two-line request can't use them.
+    arena.Free(all[10]);
+    arena.Free(all[12]);
+    CHECK(arena.Alloc(STUB_LINE) == all[10]);
+    void* two = arena.Alloc(2 * STUB_LINE);
+    CHECK(two != nullptr);
+    CHECK_EQ(arena.RegionCount(), 2);
+    CHECK(arena.Alloc(STUB_LINE) == all[12]);
+
+    // Whole region in one go, and more than that is refused.
+    CHECK(arena.Alloc(pages.Granularity()) != nullptr);
+    CHECK(arena.Alloc(pages.Granularity() + 1) == nullptr);
+    CHECK(arena.Alloc(0) == nullptr);
+    CHECK_EQ(arena.RegionCount(), 3);
+}
+
+#ifndef _WIN32
+// mincore fails with ENOMEM on an unmapped range.
+static bool Mapped(uintptr_t base)
+{
+    unsigned char vec[1];
+    return mincore((void*)base, (size_t)sysconf(_SC_PAGESIZE), vec) == 0 || errno != ENOMEM;
+}
+
+TEST(stub_arena_destructor_unmaps_every_region)
+{
+    CountingPages pages;
+    std::vector<uintptr_t> bases;
+    {
+        StubArena arena(pages);
+        for (int i = 0; i < 3; i++) arena.Alloc(pages.Granularity());
+        CHECK_EQ(arena.RegionCount(), 3);
+        bases = pages.live;
+        for (uintptr_t b : bases) CHECK(Mapped(b));
+    }
+    CHECK_EQ(pages.releases, 3);
+    CHECK(pages.live.empty());
+    for (uintptr_t b : bases) CHECK(!Mapped(b));
+}
+#endif
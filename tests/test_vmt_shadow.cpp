@@ -0,0 +1,154 @@
+// test_vmt_shadow.cpp - shadow vtables over a mock weapon class hierarchy
+#include "test.h"
+#include "mock_engine.h"
+#include "vmt_shadow.h"
+
+// The pool lives for the process and is keyed on the original vtable, so
+// every class here is static: a class rebuilt at a reused address would
+// find the previous test's shadow.
+static const int g_derivedOverrides[] = { SLOT_Holster, SLOT_WeaponIdle };
+
+static MockWeaponClass& BaseClass()
+{
+    static MockWeaponClass c(0, "CBasePlayerWeapon");
+    return c;
+}
+
+static MockWeaponClass& DerivedClass()
+{
+    static MockWeaponClass c(1, "CJanus1", &BaseClass(), g_derivedOverrides, 2);
+    return c;
+}
+
+static const int HOOKED = 50000;
+
+// Runs the class's own implementation through the shadow's back-pointer,
+// the way a call-through hook does.
+static int CallOriginal(void* self, int slot)
+{
+    void** orig = (void**)(*(void***)self)[-2];
+    return ((MockSlotFn)orig[slot])(self);
+}
+
+static int Hook_Holster(void* self) { return HOOKED + CallOriginal(self, SLOT_Holster); }
+static int Hook_Deploy(void* self)  { return HOOKED + CallOriginal(self, SLOT_Deploy); }
+
+static int g_fills;
+
+static void FillHooks(void** table, void* const* orig)
+{
+    g_fills++;
+    CHECK(table[SLOT_Holster] == orig[SLOT_Holster]);   // a plain copy before the fill
+    table[SLOT_Holster] = (void*)&Hook_Holster;
+    table[SLOT_Deploy]  = (void*)&Hook_Deploy;
+}
+
+TEST(vmt_shadow_layout)
+{
+    MockWeaponClass& d = DerivedClass();
+    void** shadow = VmtShadow_Get(d.Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    CHECK(shadow);
+    if (!shadow) return;
+    CHECK_EQ((uintptr_t)shadow % 64, 0);
+    CHECK(shadow[-2] == (void*)d.Vtable());
+    CHECK(shadow[-1] == d.Vtable()[-1]);                // RTTI word
+    CHECK(shadow[-1] == (void*)&d);
+    for (int s = 0; s < WEAPON_VTABLE_SLOTS; s++)
+        if (s != SLOT_Holster && s != SLOT_Deploy) CHECK(shadow[s] == d.Vtable()[s]);
+}
+
+TEST(vmt_shadow_pooled_per_class)
+{
+    int count = VmtShadow_Count(), fills = g_fills;
+    void** a = VmtShadow_Get(DerivedClass().Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    void** b = VmtShadow_Get(DerivedClass().Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    CHECK(a && a == b);
+    void** base = VmtShadow_Get(BaseClass().Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    CHECK(base && base != a);
+    CHECK(VmtShadow_Get(BaseClass().Vtable(), WEAPON_VTABLE_SLOTS, nullptr) == base);
+    // The derived shadow may already exist from an earlier test; the base
+    // one is new here, and neither is filled twice.
+    CHECK(VmtShadow_Count() - count <= 2);
+    CHECK(g_fills - fills == VmtShadow_Count() - count);
+    CHECK(VmtShadow_Get(nullptr, WEAPON_VTABLE_SLOTS, &FillHooks) == nullptr);
+    CHECK(VmtShadow_Get(DerivedClass().Vtable(), 0, &FillHooks) == nullptr);
+}
+
+TEST(vmt_shadow_dispatch_through_hierarchy)
+{
+    MockWeaponClass& d = DerivedClass();
+    void** shadow = VmtShadow_Get(d.Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    MockWeapon w(d);
+    VmtShadow_Attach(&w, shadow);
+
+    // Hooked slots run the hook, which reaches the class's own code:
+    // Holster is CJanus1's override, Deploy is inherited from the base.
+    CHECK_EQ(Mock_CallSlot(&w, SLOT_Holster), HOOKED + MockSlotValue(1, SLOT_Holster));
+    CHECK_EQ(Mock_CallSlot(&w, SLOT_Deploy),  HOOKED + MockSlotValue(0, SLOT_Deploy));
+    // Untouched slots keep the class's resolution.
+    CHECK_EQ(Mock_CallSlot(&w, SLOT_WeaponIdle), MockSlotValue(1, SLOT_WeaponIdle));
+    CHECK_EQ(Mock_CallSlot(&w, 0), MockSlotValue(0, 0));
+    CHECK_EQ(Mock_CallSlot(&w, WEAPON_VTABLE_SLOTS - 1), MockSlotValue(0, WEAPON_VTABLE_SLOTS - 1));
+    VmtShadow_Detach(&w);
+}
+
+TEST(vmt_shadow_only_attached_objects_change)
+{
+    MockWeaponClass& d = DerivedClass();
+    void* before[WEAPON_VTABLE_SLOTS];
+    memcpy(before, d.Vtable(), sizeof(before));
+
+    void** shadow = VmtShadow_Get(d.Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    MockWeapon mine(d), other(d), base(BaseClass());
+    VmtShadow_Attach(&mine, shadow);
+
+    CHECK(memcmp(before, d.Vtable(), sizeof(before)) == 0);   // class table untouched
+    CHECK_EQ(Mock_CallSlot(&other, SLOT_Holster), MockSlotValue(1, SLOT_Holster));
+    CHECK_EQ(Mock_CallSlot(&base, SLOT_Deploy), MockSlotValue(0, SLOT_Deploy));
+    CHECK(VmtShadow_IsShadowed(&mine));
+    CHECK(!VmtShadow_IsShadowed(&other));
+    CHECK(!VmtShadow_IsShadowed(&base));
+    CHECK(!VmtShadow_IsShadowed(nullptr));
+    VmtShadow_Detach(&mine);
+}
+
+TEST(vmt_shadow_attach_detach)
+{
+    MockWeaponClass& d = DerivedClass();
+    void** shadow = VmtShadow_Get(d.Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    MockWeapon w(d);
+    MockWeapon copy = w;
+
+    VmtShadow_Attach(&w, shadow);
+    VmtShadow_Attach(&w, shadow);                 // no-op the second time
+    CHECK(w.vptr == shadow);
+    CHECK(memcmp(w.body, copy.body, sizeof(w.body)) == 0);   // only the vptr moves
+
+    CHECK(VmtShadow_Detach(&w));
+    CHECK(w.vptr == d.Vtable());
+    CHECK_EQ(Mock_CallSlot(&w, SLOT_Holster), MockSlotValue(1, SLOT_Holster));
+    CHECK(!VmtShadow_Detach(&w));
+    CHECK(!VmtShadow_Detach(nullptr));
+
+    VmtShadow_Attach(nullptr, shadow);
+    VmtShadow_Attach(&w, nullptr);
+    CHECK(w.vptr == d.Vtable());
+}
+
+TEST(vmt_shadow_one_fill_many_classes)
+{
+    // The same hook table over two unrelated classes calls back into each
+    // class's own implementation.
+    static MockWeaponClass other(2, "CM4A1");
+    void** sd = VmtShadow_Get(DerivedClass().Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    void** so = VmtShadow_Get(other.Vtable(), WEAPON_VTABLE_SLOTS, &FillHooks);
+    CHECK(sd && so && sd != so);
+    MockWeapon a(DerivedClass()), b(other);
+    VmtShadow_Attach(&a, sd);
+    VmtShadow_Attach(&b, so);
+    CHECK_EQ(Mock_CallSlot(&a, SLOT_Holster), HOOKED + MockSlotValue(1, SLOT_Holster));
+    CHECK_EQ(Mock_CallSlot(&b, SLOT_Holster), HOOKED + MockSlotValue(2, SLOT_Holster));
+    CHECK_EQ(Mock_CallSlot(&b, SLOT_Deploy),  HOOKED + MockSlotValue(2, SLOT_Deploy));
+    VmtShadow_Detach(&a);
+    VmtShadow_Detach(&b);
+}
@@ -0,0 +1,147 @@
+// test_weapon_db.cpp - the mapped weapon records and what their consumers apply
+#include "test.h"
+#include "mock_engine.h"
+#include "weapon_db.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// The csnz_wdefc layout, one record at janus1's ID.
+struct BlobBuilder
+{
+    std::string pool = std::string(1, '\0');
+    WeaponDef   def  = {};
+
+    uint32_t Str(const char* s)
+    {
+        uint32_t off = (uint32_t)pool.size();
+        pool.append(s, strlen(s) + 1);
+        return off;
+    }
+
+    std::vector<uint8_t> Build()
+    {
+        uint32_t maxId = def.id;
+        WdbHeader h = {};
+        memcpy(h.magic, WDB_MAGIC, 8);
+        h.count       = 1;
+        h.maxId       = maxId;
+        h.indexOff    = sizeof(WdbHeader);
+        h.defsOff     = h.indexOff + (maxId + 1) * 4;
+        h.defSize     = sizeof(WeaponDef);
+        h.stringsOff  = h.defsOff + sizeof(WeaponDef);
+        h.stringsSize = (uint32_t)pool.size();
+        h.fileSize    = h.stringsOff + h.stringsSize;
+
+        std::vector<uint8_t> out(h.fileSize);
+        std::vector<uint32_t> index(maxId + 1, WDB_NONE);
+        index[def.id] = 0;
+        memcpy(&out[0], &h, sizeof(h));
+        memcpy(&out[h.indexOff], index.data(), index.size() * 4);
+        memcpy(&out[h.defsOff], &def, sizeof(def));
+        memcpy(&out[h.stringsOff], pool.data(), pool.size());
+        return out;
+    }
+};
+
+static BlobBuilder Janus1()
+{
+    BlobBuilder b;
+    WeaponDef& d  = b.def;
+    d.id          = 570;
+    d.classname   = b.Str("weapon_janus1");
+    d.modelV      = b.Str("models/v_janus1.mdl");
+    d.modelW      = b.Str("models/w_janus1.mdl");
+    d.soundFire   = b.Str("weapons/janus1-1.wav");
+    d.event       = b.Str("events/janus1.sc");
+    d.clip        = 5;
+    d.damage      = 98.0f;
+    d.spread      = 0.01f;
+    d.spreadAir   = 0.2f;
+    return b;
+}
+
+static bool OpenBlob(const std::vector<uint8_t>& blob)
+{
+    const char* path = Test_TempPath("weapons.wdb");
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fwrite(blob.data(), 1, blob.size(), f);
+    fclose(f);
+    return WeaponDb_Open(path);
+}
+
+TEST(weapon_db_direct_lookup_by_id)
+{
+    CHECK(OpenBlob(Janus1().Build()));
+    CHECK_EQ(WeaponDb_Count(), 1);
+    const WeaponDef* d = WeaponDb_Find(570);
+    CHECK(d != nullptr);
+    CHECK(!strcmp(WeaponDb_Str(d->classname), "weapon_janus1"));
+    CHECK(WeaponDb_Str(d->modelP) == nullptr);
+    CHECK(WeaponDb_Find(569) == nullptr);      // hole in the index
+    CHECK(WeaponDb_Find(571) == nullptr);      // past maxId
+    CHECK(WeaponDb_Find(WDB_NONE) == nullptr);
+    WeaponDb_Close();
+    CHECK(WeaponDb_Find(570) == nullptr);
+}
+
+TEST(weapon_db_rejects_foreign_record_size)
+{
+    std::vector<uint8_t> blob = Janus1().Build();
+    ((WdbHeader*)blob.data())->defSize -= 4;
+    CHECK(!OpenBlob(blob));
+    CHECK_EQ(WeaponDb_Count(), 0);
+}
+
+TEST(weapon_db_precache_set_strings_only)
+{
+    CHECK(OpenBlob(Janus1().Build()));
+    MockEngine& eng = Mock_Engine();
+    eng.Reset();
+    unsigned short ev = WeaponDb_Precache(*WeaponDb_Find(570), eng.funcs);
+    CHECK_EQ(eng.models.size(), 2);
+    CHECK(eng.models[0] == "models/v_janus1.mdl");
+    CHECK(eng.models[1] == "models/w_janus1.mdl");
+    CHECK_EQ(eng.sounds.size(), 1);
+    CHECK_EQ(eng.events.size(), 1);
+    CHECK(eng.events[0] == "events/janus1.sc");
+    CHECK_EQ(ev, 1);
+
+    BlobBuilder bare;
+    bare.def.id = 570;
+    CHECK(OpenBlob(bare.Build()));
+    eng.Reset();
+    CHECK_EQ(WeaponDb_Precache(*WeaponDb_Find(570), eng.funcs), 0);
+    CHECK(eng.models.empty() && eng.sounds.empty() && eng.events.empty());
+    WeaponDb_Close();
+}
+
+TEST(weapon_db_item_info_and_volley_keep_unset_fields)
+{
+    CHECK(OpenBlob(Janus1().Build()));
+    const WeaponDef& d = *WeaponDb_Find(570);
+
+    int clip = 30, ammo = 90;
+    WeaponDb_ItemInfo(d, clip, ammo);
+    CHECK_EQ(clip, 5);
+    CHECK_EQ(ammo, 90);
+
+    HsVolley v = {};
+    v.damage = 20.0f;
+    v.spreadX = v.spreadY = 0.05f;
+    WeaponDb_Volley(d, true, false, v);        // no spread_move: standing cone
+    CHECK(v.damage == 98.0f);
+    CHECK(v.spreadX == 0.01f && v.spreadY == 0.01f);
+    WeaponDb_Volley(d, true, true, v);
+    CHECK(v.spreadX == 0.2f);
+
+    BlobBuilder bare;
+    bare.def.id = 570;
+    CHECK(OpenBlob(bare.Build()));
+    HsVolley keep = v;
+    WeaponDb_Volley(*WeaponDb_Find(570), false, false, keep);
+    CHECK(keep.damage == v.damage && keep.spreadX == v.spreadX);
+    WeaponDb_Close();
+}
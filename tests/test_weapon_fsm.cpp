@@ -0,0 +1,218 @@
+// test_weapon_fsm.cpp - mode-switch tables on the mock clock
+#include "test.h"
+#include "mock_engine.h"
+#include "hlsdk/csnz_layout.h"
+#include "weapon_fsm.h"
+#include <cstring>
+#include <vector>
+
+// The Janus-1 machine (weapons/janus1.cpp) with the same shape and timers.
+#define TJANUS_STATES(S)                                                      \
+    S(Normal,  -1, 0.0f)                                                      \
+    S(Signal,   7, 10.0f)                                                     \
+    S(ChangeA,  8, 1.5f)                                                      \
+    S(ModeB,    9, 10.0f)                                                     \
+    S(ChangeB, 12, 1.5f)
+#define TJANUS_TRANS(T)                                                       \
+    T(Normal,  Signal,  WIN_CHARGED, WIN_CHARGED)                             \
+    T(Signal,  ChangeA, WIN_ATTACK2, WIN_ATTACK2)                             \
+    T(Signal,  Normal,  WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ChangeA, ModeB,   WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ModeB,   ChangeB, WIN_TIMEOUT, WIN_TIMEOUT)                             \
+    T(ChangeB, Normal,  WIN_TIMEOUT, WIN_TIMEOUT)
+WFSM_DEFINE(TJanus, TJANUS_STATES, TJANUS_TRANS)
+using namespace TJanus_Fsm;
+
+// A power of two, so the clock and every timer land on exact frames.
+static const float FRAME = 1.0f / 64.0f;
+static const int   SIGNAL_SHOTS = 5;
+
+// What the WeaponIdle pre-hook samples.
+static uint32_t Inputs(void* w, float now)
+{
+    return (Fld<WpnF::iShotCount>(w) >= SIGNAL_SHOTS ? WIN_CHARGED : 0)
+         | (Fld<WpnF::flNextSecondary>(w) > now ? WIN_ATTACK2 : 0);
+}
+
+static MockWeaponClass& JanusClass()
+{
+    static MockWeaponClass c(2, "CJanus1");
+    return c;
+}
+
+TEST(wfsm_build_rejects_bad_defs)
+{
+    WfsmTable t;
+    static const WfsmStateDef one[] = { { "A", -1, 0.0f } };
+    static const WfsmTransDef badTo[] = { { 0, 1, 0, 0 } };
+    CHECK(!Wfsm_Build(WfsmDef{ "none", one, 0, nullptr, 0 }, t));
+    CHECK(!Wfsm_Build(WfsmDef{ "badTo", one, 1, badTo, 1 }, t));
+    CHECK(!Wfsm_Build(WfsmDef{ "big", one, WFSM_MAX_STATES + 1, nullptr, 0 }, t));
+    CHECK(!Wfsm_Build(WfsmDef{ "many", one, 1, badTo, WFSM_MAX_TRANS + 1 }, t));
+    CHECK(Wfsm_Build(WfsmDef{ "one", one, 1, nullptr, 0 }, t));
+    CHECK_EQ(t.first[0], 0);
+    CHECK_EQ(t.first[1], 0);
+}
+
+TEST(wfsm_build_groups_by_state_in_list_order)
+{
+    static const WfsmStateDef st[] = { { "A", 1, 0.0f }, { "B", 2, 0.0f }, { "C", 3, 0.5f } };
+    // Interleaved, and two from A that both take WIN_ATTACK1.
+    static const WfsmTransDef tr[] = {
+        { 1, 0, WIN_RELOAD,  WIN_RELOAD },
+        { 0, 1, WIN_ATTACK1, WIN_ATTACK1 },
+        { 2, 0, WIN_TIMEOUT, WIN_TIMEOUT },
+        { 0, 2, WIN_ATTACK1 | WIN_EMPTY, WIN_ATTACK1 },
+    };
+    WfsmTable t;
+    CHECK(Wfsm_Build(WfsmDef{ "g", st, 3, tr, 4 }, t));
+    CHECK_EQ(t.first[0], 0);
+    CHECK_EQ(t.first[1], 2);
+    CHECK_EQ(t.first[2], 3);
+    CHECK_EQ(t.first[3], 4);
+    CHECK_EQ(t.to[0], 1);
+    CHECK_EQ(t.to[1], 2);
+    CHECK_EQ(t.anim[2], 3);
+
+    // A's first transition wins whenever both match; the second only
+    // when its mask leaves the first one out.
+    WfsmInst in = {};
+    CHECK_EQ(Wfsm_Tick(t, in, WIN_ATTACK1, 1.0f), 1);
+    in.state = 0;
+    CHECK_EQ(Wfsm_Tick(t, in, WIN_ATTACK1 | WIN_RELOAD, 1.0f), 1);
+    in.state = 0;
+    CHECK_EQ(Wfsm_Tick(t, in, WIN_RELOAD, 1.0f), -1);
+    CHECK_EQ(in.state, 0);
+    CHECK(strcmp(Wfsm_StateName(t, 2), "C") == 0);
+    CHECK(strcmp(Wfsm_StateName(t, 3), "?") == 0);
+}
+
+TEST(wfsm_janus_cycle_on_mock_clock)
+{
+    MockEngine& eng = Mock_Engine();
+    eng.Reset(1.0f);
+    WfsmTable t;
+    CHECK(Wfsm_Build(TJanus_Def, t));
+    MockWeapon w(JanusClass());
+    WfsmInst in = {};
+    Wfsm_Enter(t, in, Normal, eng.Time());
+
+    // (frame, state) for every transition.
+    std::vector<std::pair<int, int>> got;
+    auto run = [&](int frames)
+    {
+        for (int f = 0; f < frames; f++)
+        {
+            eng.Advance(FRAME);
+            int frame = (int)((eng.Time() - 1.0f) * 64.0f + 0.5f);
+            int s = Wfsm_Tick(t, in, Inputs(&w, eng.Time()), eng.Time());
+            if (s >= 0) got.push_back({ frame, s });
+        }
+    };
+
+    Fld<WpnF::iShotCount>(&w) = SIGNAL_SHOTS - 1;
+    run(10);
+    CHECK(got.empty());
+    Fld<WpnF::iShotCount>(&w) = SIGNAL_SHOTS;          // frame 11
+    run(1);
+    Fld<WpnF::iShotCount>(&w) = 0;
+    run(10 * 64);                                       // signal lapses
+    Fld<WpnF::iShotCount>(&w) = SIGNAL_SHOTS;           // frame 652
+    run(1);
+    Fld<WpnF::iShotCount>(&w) = 0;
+    run(99);
+    Fld<WpnF::flNextSecondary>(&w) = eng.Time() + 0.5f; // frame 752
+    run(30 * 64);
+
+    const std::pair<int, int> want[] = {
+        { 11,                 Signal  },
+        { 11 + 640,           Normal  },
+        { 652,                Signal  },
+        { 752,                ChangeA },
+        { 752 + 96,           ModeB   },
+        { 752 + 96 + 640,     ChangeB },
+        { 752 + 96 + 640 + 96, Normal },
+    };
+    CHECK_EQ(got.size(), sizeof(want) / sizeof(want[0]));
+    for (size_t i = 0; i < got.size() && i < sizeof(want) / sizeof(want[0]); i++)
+    {
+        CHECK_EQ(got[i].first, want[i].first);
+        CHECK_EQ(got[i].second, want[i].second);
+    }
+    CHECK_EQ(in.state, Normal);
+    CHECK(in.until == 0.0f);
+}
+
+TEST(wfsm_one_transition_per_tick)
+{
+    WfsmTable t;
+    CHECK(Wfsm_Build(TJanus_Def, t));
+    WfsmInst in = {};
+    Wfsm_Enter(t, in, Normal, 1.0f);
+    uint32_t both = WIN_CHARGED | WIN_ATTACK2;
+    CHECK_EQ(Wfsm_Tick(t, in, both, 1.0f), Signal);
+    CHECK_EQ(Wfsm_Tick(t, in, both, 1.0f), ChangeA);
+    CHECK_EQ(Wfsm_Tick(t, in, both, 1.0f), -1);
+    CHECK(in.until == 2.5f);
+    CHECK_EQ(Wfsm_Tick(t, in, 0, 2.4f), -1);
+    CHECK_EQ(Wfsm_Tick(t, in, 0, 2.5f), ModeB);
+}
+
+TEST(wfsm_untimed_state_never_times_out)
+{
+    WfsmTable t;
+    CHECK(Wfsm_Build(TJanus_Def, t));
+    WfsmInst in = {};
+    Wfsm_Enter(t, in, Normal, 1.0f);
+    CHECK(in.until == 0.0f);
+    CHECK_EQ(Wfsm_Tick(t, in, 0, 1.0e6f), -1);
+    // A zeroed instance is Normal too, timer off.
+    WfsmInst zero = {};
+    CHECK_EQ(Wfsm_Tick(t, zero, 0, 1.0e6f), -1);
+}
+
+// 64 weapons fired at random, one shared table; the same seed gives the
+// same transitions frame for frame.
+static std::vector<uint32_t> Skirmish(uint32_t seed, int counts[TJanus_Fsm::COUNT])
+{
+    MockEngine& eng = Mock_Engine();
+    eng.Reset(1.0f);
+    WfsmTable t;
+    Wfsm_Build(TJanus_Def, t);
+    std::vector<MockWeapon> ws(64, MockWeapon(JanusClass()));
+    std::vector<WfsmInst>   in(64);
+    for (WfsmInst& i : in) Wfsm_Enter(t, i, Normal, eng.Time());
+    MockRng rng(seed);
+    std::vector<uint32_t> trace;
+    for (int f = 0; f < 64 * 60; f++)
+    {
+        eng.Advance(FRAME);
+        float now = eng.Time();
+        for (int i = 0; i < 64; i++)
+        {
+            void* w = &ws[i];
+            uint32_t r = rng.Next();
+            if (r % 16 == 0) Fld<WpnF::iShotCount>(w)++;
+            if (r % 61 == 0) Fld<WpnF::flNextSecondary>(w) = now + 0.25f;
+            int s = Wfsm_Tick(t, in[i], Inputs(w, now), now);
+            if (s < 0) continue;
+            counts[s]++;
+            trace.push_back((uint32_t)f << 12 | (uint32_t)i << 4 | (uint32_t)s);
+            if (s == Normal) Fld<WpnF::iShotCount>(w) = 0;
+        }
+    }
+    return trace;
+}
+
+TEST(wfsm_many_weapons_deterministic)
+{
+    int a[TJanus_Fsm::COUNT] = {}, b[TJanus_Fsm::COUNT] = {};
+    std::vector<uint32_t> ta = Skirmish(77, a), tb = Skirmish(77, b);
+    CHECK(ta == tb);
+    // Every state is reached, and the cycle closes: each ModeB goes
+    // through ChangeB, and every Signal either lapses or switches.
+    for (int s = 0; s < TJanus_Fsm::COUNT; s++) CHECK(a[s] > 0);
+    CHECK(a[ChangeA] >= a[ModeB]);
+    CHECK(a[ModeB] >= a[ChangeB]);
+    CHECK(a[Signal] >= a[ChangeA]);
+}
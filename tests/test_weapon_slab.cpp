@@ -0,0 +1,99 @@
+// test_weapon_slab.cpp - size classes, reuse and chunk lifetime of WeaponSlab
+#include "test.h"
+#include "mock_engine.h"
+#include "weapon_slab.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static bool AllZero(const void* p, size_t n)
+{
+    const uint8_t* b = (const uint8_t*)p;
+    for (size_t i = 0; i < n; i++) if (b[i]) return false;
+    return true;
+}
+
+TEST(weapon_slab_rejects_out_of_range_sizes)
+{
+    WeaponSlab slab;
+    CHECK(slab.Alloc(0) == nullptr);
+    CHECK(slab.Alloc(SLAB_MAX_OBJ + 1) == nullptr);
+    CHECK(slab.Alloc(SLAB_MAX_OBJ) != nullptr);
+    CHECK_EQ(slab.Live(), 1);
+}
+
+TEST(weapon_slab_zeroed_aligned_and_reused)
+{
+    WeaponSlab slab;
+    // CJanus1's private data, dirtied and handed back: the next object of
+    // the class gets the same memory, zeroed again.
+    void* a = slab.Alloc(504);
+    CHECK(a != nullptr);
+    CHECK_EQ((uintptr_t)a % SLAB_LINE, 0);
+    CHECK(AllZero(a, 512));
+    memset(a, 0xCC, 504);
+    CHECK(slab.Free(a));
+    CHECK_EQ(slab.Live(), 0);
+
+    void* b = slab.Alloc(500);   // same 512-byte class
+    CHECK(b == a);
+    CHECK(AllZero(b, 512));
+    // Another class comes from another chunk.
+    void* c = slab.Alloc(64);
+    CHECK(c != nullptr && c != b);
+    CHECK_EQ(slab.Chunks(), 2);
+    CHECK_EQ(slab.Live(), 2);
+}
+
+TEST(weapon_slab_free_ignores_foreign_and_interior_pointers)
+{
+    WeaponSlab slab;
+    static uint8_t heap[256];
+    uint8_t* p = (uint8_t*)slab.Alloc(128);
+    CHECK(!slab.Free(nullptr));
+    CHECK(!slab.Free(heap));            // engine heap object: not ours
+    CHECK(!slab.Free(p + 64));          // inside an object
+    CHECK(slab.Owns(p + 64));
+    CHECK(!slab.Owns(heap));
+    CHECK_EQ(slab.Live(), 1);
+    CHECK(slab.Free(p));
+    CHECK_EQ(slab.Live(), 0);
+}
+
+TEST(weapon_slab_spans_chunks_and_releases_all)
+{
+    WeaponSlab slab;
+    MockRng rng(15);
+    const size_t perChunk = SLAB_CHUNK / SLAB_LINE;
+    std::vector<void*> objs;
+    for (size_t i = 0; i < perChunk + perChunk / 2; i++)
+    {
+        void* p = slab.Alloc(1 + rng.Below(SLAB_LINE));   // all in the 64-byte class
+        CHECK(p != nullptr);
+        objs.push_back(p);
+    }
+    CHECK_EQ(slab.Chunks(), 2);
+    CHECK_EQ(slab.Live(), objs.size());
+    // No two objects overlap.
+    std::vector<void*> sorted = objs;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 1; i < sorted.size(); i++)
+        CHECK((uint8_t*)sorted[i] - (uint8_t*)sorted[i - 1] >= (ptrdiff_t)SLAB_LINE);
+
+    // Free in random order; everything goes back.
+    for (size_t i = objs.size(); i > 0; i--)
+    {
+        size_t k = rng.Below((uint32_t)i);
+        CHECK(slab.Free(objs[k]));
+        objs[k] = objs[i - 1];
+    }
+    CHECK_EQ(slab.Live(), 0);
+    CHECK_EQ(slab.Chunks(), 2);          // chunks stay for the next map
+
+    void* p = slab.Alloc(32);
+    slab.ReleaseAll();
+    CHECK_EQ(slab.Chunks(), 0);
+    CHECK_EQ(slab.Live(), 0);
+    CHECK(!slab.Owns(p));
+    CHECK(!slab.Free(p));
+}
@@ -0,0 +1,288 @@
+// test_x86_len.cpp - length decoder against pinned objdump results and a live objdump fuzz
+#include "test.h"
+#include "mock_engine.h"
+#include "x86_len.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+struct PinnedInsn
+{
+    const char* hex;
+    int         len;       // objdump's length; 0 = the decoder refuses it
+    int         relOff, relSize;   // relative branch field, 0, 0 = none
+};
+
+// Lengths from objdump -D -b binary -m i386 (binutils 2.42).
+static const PinnedInsn g_pinned[] = {
+    // prologues, ModRM / SIB / displacement forms
+    { "55", 1, 0, 0 }, { "8bec", 2, 0, 0 }, { "83ec20", 3, 0, 0 }, { "81ec00010000", 6, 0, 0 },
+    { "8b4508", 3, 0, 0 }, { "8b4c2404", 4, 0, 0 }, { "8b0424", 3, 0, 0 },
+    { "8b0578563412", 6, 0, 0 }, { "8b048500000010", 7, 0, 0 }, { "8b048d00000000", 7, 0, 0 },
+    { "8b842400010000", 7, 0, 0 }, { "8d4c24f0", 4, 0, 0 }, { "c744240801000000", 8, 0, 0 },
+    { "c7050000000001000000", 10, 0, 0 },
+    // operand / address size
+    { "66c745fc0100", 6, 0, 0 }, { "66c705000000000100", 9, 0, 0 }, { "6689442402", 5, 0, 0 },
+    { "66b80100", 4, 0, 0 }, { "b801000000", 5, 0, 0 }, { "b001", 2, 0, 0 },
+    { "a100000010", 5, 0, 0 }, { "a300000010", 5, 0, 0 }, { "67a10010", 4, 0, 0 },
+    { "67a30010", 4, 0, 0 }, { "678b4600", 4, 0, 0 }, { "678b860001", 5, 0, 0 },
+    { "678b0e0010", 5, 0, 0 },
+    // immediates
+    { "6a01", 2, 0, 0 }, { "6800000010", 5, 0, 0 }, { "69c0e8030000", 6, 0, 0 },
+    { "6bc00a", 3, 0, 0 }, { "f6c101", 3, 0, 0 }, { "f7c100010000", 6, 0, 0 },
+    { "66f7c10001", 5, 0, 0 }, { "f6d8", 2, 0, 0 }, { "f7d8", 2, 0, 0 }, { "c20400", 3, 0, 0 },
+    { "ca0800", 3, 0, 0 }, { "c8100000", 4, 0, 0 }, { "cd80", 2, 0, 0 },
+    { "ea000000100800", 7, 0, 0 }, { "9a000000100800", 7, 0, 0 },
+    // branches
+    { "e800000000", 5, 1, 4 }, { "e9fbffffff", 5, 1, 4 }, { "ebfe", 2, 1, 1 }, { "7405", 2, 1, 1 },
+    { "0f8400010000", 6, 2, 4 }, { "0f85f6ffffff", 6, 2, 4 }, { "66e90100", 4, 2, 2 },
+    { "e2fe", 2, 1, 1 }, { "e3fe", 2, 1, 1 }, { "ff1500000010", 6, 0, 0 },
+    { "ff2500000010", 6, 0, 0 }, { "ffe0", 2, 0, 0 }, { "ffd0", 2, 0, 0 },
+    { "ff248500000010", 7, 0, 0 }, { "ff742404", 4, 0, 0 }, { "fe0e", 2, 0, 0 },
+    // one-byte, x87, string, lock
+    { "c3", 1, 0, 0 }, { "cb", 1, 0, 0 }, { "cf", 1, 0, 0 }, { "c9", 1, 0, 0 }, { "cc", 1, 0, 0 },
+    { "d7", 1, 0, 0 }, { "9b", 1, 0, 0 }, { "d9442404", 4, 0, 0 }, { "dd1c24", 3, 0, 0 },
+    { "dec9", 2, 0, 0 }, { "dfe0", 2, 0, 0 }, { "f3a5", 2, 0, 0 }, { "f3ab", 2, 0, 0 },
+    { "f2ae", 2, 0, 0 }, { "f00fb10a", 4, 0, 0 }, { "f00fc10a", 4, 0, 0 }, { "8cd8", 2, 0, 0 },
+    { "8ed8", 2, 0, 0 }, { "c400", 2, 0, 0 }, { "c500", 2, 0, 0 }, { "6200", 2, 0, 0 },
+    // two- and three-byte maps
+    { "0fb6c0", 3, 0, 0 }, { "0fbe4508", 4, 0, 0 }, { "0fafc1", 3, 0, 0 },
+    { "0f1f440000", 5, 0, 0 }, { "0f1f840000000000", 8, 0, 0 }, { "660f1f440000", 6, 0, 0 },
+    { "0f31", 2, 0, 0 }, { "0fa2", 2, 0, 0 }, { "0f0b", 2, 0, 0 }, { "0fc8", 2, 0, 0 },
+    { "0f28c1", 3, 0, 0 }, { "0f290424", 4, 0, 0 }, { "660f6fc1", 4, 0, 0 },
+    { "f30f7e0424", 5, 0, 0 }, { "f20f100424", 5, 0, 0 }, { "f30f2cc0", 4, 0, 0 },
+    { "0f700001", 4, 0, 0 }, { "0f71d004", 4, 0, 0 }, { "0fc2c100", 4, 0, 0 },
+    { "0fc604241b", 5, 0, 0 }, { "0fa4c108", 4, 0, 0 }, { "0facc108", 4, 0, 0 },
+    { "0fbae005", 4, 0, 0 }, { "0f0fc00d", 4, 0, 0 }, { "0f3800c1", 4, 0, 0 },
+    { "660f3800c1", 5, 0, 0 }, { "0f3a0fc108", 5, 0, 0 }, { "660f3a0fc108", 6, 0, 0 },
+    { "660f3a0a042404", 7, 0, 0 }, { "660f78c00102", 6, 0, 0 }, { "f20f79c1", 4, 0, 0 },
+    // mov CR/DR: the ModRM is a register whatever mod says
+    { "0f20c0", 3, 0, 0 }, { "0f2200", 3, 0, 0 }, { "0f22d8", 3, 0, 0 }, { "0f2105", 3, 0, 0 },
+    { "0f2338", 3, 0, 0 },
+    // segment overrides
+    { "64a118000000", 6, 0, 0 }, { "64ff3500000000", 7, 0, 0 }, { "2eff2500000010", 7, 0, 0 },
+    // refused: VEX / EVEX, 486 test registers, VIA PadLock
+    { "c5f877", 0, 0, 0 }, { "c4c0", 0, 0, 0 }, { "62c0", 0, 0, 0 }, { "0f24c0", 0, 0, 0 },
+    { "0fa7c0", 0, 0, 0 },
+};
+
+static std::vector<uint8_t> Hex(const char* s)
+{
+    std::vector<uint8_t> out;
+    for (; s[0] && s[1]; s += 2)
+    {
+        char byte[3] = { s[0], s[1], 0 };
+        out.push_back((uint8_t)strtoul(byte, nullptr, 16));
+    }
+    return out;
+}
+
+TEST(x86_len_pinned_reference)
+{
+    for (const PinnedInsn& t : g_pinned)
+    {
+        std::vector<uint8_t> b = Hex(t.hex);
+        // Trailing bytes must not change the answer.
+        std::vector<uint8_t> padded = b;
+        padded.resize(b.size() + 15, 0x90);
+        X86Insn in;
+        int len = X86_Decode(padded.data(), padded.size(), in);
+        if (len != t.len) fprintf(stderr, "  %s\n", t.hex);
+        CHECK_EQ(len, t.len);
+        if (!t.len) continue;
+        CHECK_EQ(in.relOff, t.relOff);
+        CHECK_EQ(in.relSize, t.relSize);
+    }
+}
+
+TEST(x86_len_truncated_is_invalid)
+{
+    for (const PinnedInsn& t : g_pinned)
+    {
+        if (!t.len) continue;
+        std::vector<uint8_t> b = Hex(t.hex);
+        X86Insn in;
+        CHECK_EQ(X86_Decode(b.data(), b.size(), in), t.len);
+        for (size_t n = 0; n < b.size(); n++)
+            CHECK_EQ(X86_Decode(b.data(), n, in), 0);
+    }
+}
+
+TEST(x86_len_terminators)
+{
+    const char* stop[] = { "c3", "c20400", "cb", "ca0800", "cf", "e9fbffffff", "ebfe",
+                           "ea000000100800", "ff2500000010", "ffe0", "ff248500000010" };
+    const char* go[]   = { "e800000000", "ff1500000010", "ffd0", "7405", "0f8400010000",
+                           "ff742404", "e2fe", "0f0b" };
+    X86Insn in;
+    for (const char* h : stop)
+    {
+        std::vector<uint8_t> b = Hex(h);
+        CHECK(X86_Decode(b.data(), b.size(), in) && X86_IsTerminator(in, b.data()));
+    }
+    for (const char* h : go)
+    {
+        std::vector<uint8_t> b = Hex(h);
+        CHECK(X86_Decode(b.data(), b.size(), in) && !X86_IsTerminator(in, b.data()));
+    }
+}
+
+// Where a decoded direct branch at addr goes.
+static uint32_t BranchTarget(const uint8_t* p, const X86Insn& in, uint32_t addr)
+{
+    int32_t rel = 0;
+    if (in.relSize == 1) rel = (int8_t)p[in.relOff];
+    if (in.relSize == 2) { int16_t v; memcpy(&v, p + in.relOff, 2); rel = v; }
+    if (in.relSize == 4) memcpy(&rel, p + in.relOff, 4);
+    uint32_t t = addr + in.len + (uint32_t)rel;
+    return in.relSize == 2 ? t & 0xFFFF : t;
+}
+
+TEST(x86_len_rel32_relocation_round_trip)
+{
+    // Copy each rel32 branch somewhere else, re-aim it with X86_PutRel32 and
+    // check the copy still decodes to the same length and target.
+    MockRng rng(9);
+    for (const PinnedInsn& t : g_pinned)
+    {
+        if (t.relSize != 4) continue;
+        std::vector<uint8_t> b = Hex(t.hex);
+        for (int k = 0; k < 64; k++)
+        {
+            uint32_t from = rng.Next(), to = rng.Next();
+            X86Insn in, moved;
+            CHECK(X86_Decode(b.data(), b.size(), in));
+            uint32_t target = BranchTarget(b.data(), in, from);
+            std::vector<uint8_t> c = b;
+            CHECK(X86_PutRel32(c.data() + in.relOff, (uintptr_t)to + in.len, (uintptr_t)target)
+                  || sizeof(uintptr_t) == 8);
+            if (sizeof(uintptr_t) == 8)
+            {
+                int32_t rel = (int32_t)(target - (to + in.len));
+                memcpy(c.data() + in.relOff, &rel, 4);
+            }
+            CHECK_EQ(X86_Decode(c.data(), c.size(), moved), in.len);
+            CHECK_EQ(BranchTarget(c.data(), moved, to), target);
+        }
+    }
+}
+
+#ifndef _WIN32
+static const int FUZZ_SLOT  = 32;
+static const int FUZZ_CASES = 20000;
+
+struct RefInsn
+{
+    int         len;
+    std::string text;
+};
+
+// objdump's view of the instruction at each slot start. A slot is 15 random
+// bytes then 0x90 padding: whatever the tail decodes as, it ends inside the
+// padding, so the listing is back in step at the next slot.
+static bool Objdump(const char* path, std::map<uint32_t, RefInsn>& out)
+{
+    std::string cmd = std::string("objdump -D -b binary -m i386 ") + path + " 2>/dev/null";
+    FILE* f = popen(cmd.c_str(), "r");
+    if (!f) return false;
+    char line[512];
+    std::vector<std::pair<uint32_t, std::string>> starts;
+    while (fgets(line, sizeof(line), f))
+    {
+        // "   1a:\t8b 45 08             \tmov    0x8(%ebp),%eax"; wrapped
+        // byte dumps repeat the address without a mnemonic.
+        char* tab1 = strchr(line, '\t');
+        char* tab2 = tab1 ? strchr(tab1 + 1, '\t') : nullptr;
+        char* end;
+        unsigned long addr = strtoul(line, &end, 16);
+        if (!tab2 || *end != ':') continue;
+        std::string text(tab2 + 1);
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+        starts.push_back({ (uint32_t)addr, text });
+    }
+    pclose(f);
+    for (size_t i = 0; i + 1 < starts.size(); i++)
+        if (starts[i].first % FUZZ_SLOT == 0)
+            out[starts[i].first] = { (int)(starts[i + 1].first - starts[i].first), starts[i].second };
+    return !out.empty();
+}
+
+// Forms the decoder deliberately refuses: 486 test registers (0F 24/26),
+// VIA PadLock (0F A6/A7) and VEX/EVEX (C4/C5/62 with a register ModRM).
+static bool Refused(const X86Insn& in)
+{
+    if (in.twoByte)
+        return in.opcode == 0x24 || in.opcode == 0x26 || in.opcode == 0xA6 || in.opcode == 0xA7;
+    return in.opcode == 0xC4 || in.opcode == 0xC5 || in.opcode == 0x62;
+}
+
+TEST(x86_len_fuzz_against_objdump)
+{
+    FILE* probe = popen("objdump --version 2>/dev/null", "r");
+    char ver[128] = {};
+    bool have = probe && fgets(ver, sizeof(ver), probe);
+    if (probe) pclose(probe);
+    if (!have)
+    {
+        fprintf(stderr, "  objdump not found, skipped\n");
+        return;
+    }
+
+    static const uint8_t prefixes[] = { 0x66, 0x67, 0xF0, 0xF2, 0xF3, 0x2E, 0x64 };
+    std::vector<uint8_t> buf(FUZZ_CASES * FUZZ_SLOT, 0x90);
+    MockRng rng(2024);
+    for (int c = 0; c < FUZZ_CASES; c++)
+    {
+        uint8_t* s = &buf[c * FUZZ_SLOT];
+        int k = 0;
+        if (!rng.Below(4)) s[k++] = prefixes[rng.Below(sizeof(prefixes))];
+        if (!rng.Below(3)) s[k++] = 0x0F;
+        for (; k < 15; k++) s[k] = (uint8_t)rng.Next();
+    }
+    const char* path = Test_TempPath("x86_fuzz.bin");
+    FILE* f = fopen(path, "wb");
+    CHECK(f && fwrite(buf.data(), 1, buf.size(), f) == buf.size());
+    if (f) fclose(f);
+
+    std::map<uint32_t, RefInsn> ref;
+    CHECK(Objdump(path, ref));
+    remove(path);
+
+    int compared = 0, wrong = 0;
+    for (int c = 0; c < FUZZ_CASES; c++)
+    {
+        uint32_t addr = (uint32_t)(c * FUZZ_SLOT);
+        auto it = ref.find(addr);
+        if (it == ref.end()) { wrong++; continue; }
+        const RefInsn& r = it->second;
+        const uint8_t* s = &buf[addr];
+        X86Insn in;
+        int len = X86_Decode(s, 15, in);
+
+        // A length decoder doesn't validate operands, and objdump folds
+        // fwait into the x87 instruction after it.
+        if (r.text.find("(bad)") != std::string::npos) continue;
+        if (len && !in.twoByte && in.opcode == 0x9B) continue;
+        compared++;
+
+        bool ok = len ? len == r.len : Refused(in);
+        if (ok && in.relSize)
+        {
+            size_t at = r.text.rfind("0x");
+            ok = at != std::string::npos
+              && strtoul(r.text.c_str() + at, nullptr, 16) == BranchTarget(s, in, addr);
+        }
+        if (!ok && wrong++ < 10)
+        {
+            char hex[64] = {};
+            for (int i = 0; i < 15; i++) snprintf(hex + i * 2, 3, "%02x", s[i]);
+            fprintf(stderr, "  %s: decoder %d, objdump %d '%s'\n", hex, len, r.len, r.text.c_str());
+        }
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK(compared > FUZZ_CASES / 2);
+}
+#endif
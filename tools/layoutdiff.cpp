@@ -0,0 +1,51 @@
+// layoutdiff.cpp - compare the IDA field layout with the cso_baseweapon.h
+// reconstruction and print where they disagree.
+// usage: csnz_layoutdiff          (exit code 1 if any shared field differs)
+#include "hlsdk/csnz_layout.h"
+#include <cstdio>
+#include <cstring>
+
+static const FieldInfo* FindField(const FieldInfo* f, int n, const char* name)
+{
+    for (int i = 0; i < n; i++)
+        if (!strcmp(f[i].name, name)) return &f[i];
+    return nullptr;
+}
+
+static void PrintLayout(const char* title, const FieldInfo* f, int n)
+{
+    printf("%s (%d fields)\n", title, n);
+    for (int i = 0; i < n; i++)
+        printf("  %-20s +0x%04X  %d\n", f[i].name, f[i].offset, f[i].size);
+    printf("\n");
+}
+
+int main()
+{
+    const FieldInfo* ida   = WpnF::fields;
+    const FieldInfo* recon = ReconF::fields;
+    int nIda = WpnF::count, nRecon = ReconF::count;
+
+    PrintLayout("weapon, IDA (csnz_layout.h)", ida, nIda);
+    PrintLayout("player, IDA (csnz_layout.h)", PlrF::fields, PlrF::count);
+
+    printf("weapon: IDA vs cso_baseweapon.h\n");
+    printf("  %-20s  %7s  %7s\n", "field", "ida", "recon");
+    int differ = 0;
+    for (int i = 0; i < nIda; i++)
+    {
+        const FieldInfo* r = FindField(recon, nRecon, ida[i].name);
+        if (!r) { printf("  %-20s  +0x%04X %8s  ida only\n", ida[i].name, ida[i].offset, "-"); continue; }
+        bool same = r->offset == ida[i].offset && r->size == ida[i].size;
+        if (!same) differ++;
+        printf("  %-20s  +0x%04X  +0x%04X  %s", ida[i].name, ida[i].offset, r->offset, same ? "ok" : "DIFFERS");
+        if (!same) printf(" (%+d)", ida[i].offset - r->offset);
+        printf("\n");
+    }
+    for (int i = 0; i < nRecon; i++)
+        if (!FindField(ida, nIda, recon[i].name))
+            printf("  %-20s %8s  +0x%04X  recon only\n", recon[i].name, "-", recon[i].offset);
+
+    printf("\n%d shared field(s) differ\n", differ);
+    return differ ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+// logdecode.cpp - turn a csnz_weapons.bin binary log back into text.
+// usage: csnz_logdecode csnz_weapons.bin [out.txt]
+#include "log_decode.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) { fprintf(stderr, "usage: %s <log.bin> [out.txt]\n", argv[0]); return 2; }
+
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) { perror(argv[1]); return 1; }
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    for (size_t n; (n = fread(chunk, 1, sizeof(chunk), f)) > 0; )
+        data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+
+    FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+    if (!out) { perror(argv[2]); return 1; }
+    bool ok = LogBin_Decode(data.data(), data.size(), out, stderr);
+    if (out != stdout) fclose(out);
+    if (!ok) { fprintf(stderr, "%s: not a csnz binary log\n", argv[1]); return 1; }
+    return 0;
+}
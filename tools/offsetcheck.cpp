@@ -0,0 +1,61 @@
+// offsetcheck.cpp - validate an offset database against the compiled-in
+// defaults before it goes out to servers.
+// usage: csnz_offsetcheck csnz_offsets.txt
+//
+// Reports syntax errors, unknown keys, and per section every override with
+// its default, plus any field that would overlap another or be misaligned.
+// Exit code 1 if the DLL would reject the file or any section.
+#include "offset_db.h"
+#include <cstdio>
+
+static void PrintError(void* ctx, int line, const char* msg)
+{
+    const char* path = (const char*)ctx;
+    if (line) fprintf(stderr, "%s:%d: %s\n", path, line, msg);
+    else      fprintf(stderr, "%s: %s\n", path, msg);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: csnz_offsetcheck csnz_offsets.txt\n");
+        return 2;
+    }
+    static const char* const GROUP[] = { "wpn", "plr", "rva" };
+
+    std::vector<OfsDbSection> secs;
+    bool ok = OffsetDb_Parse(argv[1], secs, PrintError, argv[1]);
+
+    for (const OfsDbSection& s : secs)
+    {
+        printf("[mp %08X %08X %08X]  (line %d)\n", s.key.timeDateStamp, s.key.checkSum, s.key.sizeOfImage, s.line);
+        int changed = 0;
+        for (int i = 0; i < OFS_COUNT; i++)
+        {
+            if (!s.set[i]) continue;
+            const OfsDbEntry& e = OFFSET_DB_ENTRIES[i];
+            char key[64];
+            snprintf(key, sizeof(key), "%s.%s", GROUP[e.group], e.name);
+            if (s.value[i] == e.def)
+                printf("  %-24s 0x%07X  same as default\n", key, (unsigned)s.value[i]);
+            else
+            {
+                printf("  %-24s 0x%07X  default 0x%07X (%+d)\n", key, (unsigned)s.value[i], (unsigned)e.def,
+                       (int)(s.value[i] - e.def));
+                changed++;
+            }
+        }
+        int bad = OffsetDb_CheckLayout(s);
+        if (bad >= 0)
+        {
+            const OfsDbEntry& e = OFFSET_DB_ENTRIES[bad];
+            fprintf(stderr, "%s:%d: %s.%s overlaps another field or is misaligned, section would be rejected\n",
+                    argv[1], s.line, GROUP[e.group], e.name);
+            ok = false;
+        }
+        printf("  %d override(s)\n\n", changed);
+    }
+    printf("%s: %zu section(s), %s\n", argv[1], secs.size(), ok ? "ok" : "ERRORS");
+    return ok ? 0 : 1;
+}
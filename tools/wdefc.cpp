@@ -0,0 +1,219 @@
+// wdefc.cpp - compile weapon definitions from text into a .wdb blob.
+// usage: csnz_wdefc weapons.txt weapons.wdb
+//        csnz_wdefc -d weapons.wdb            (dump a compiled blob)
+//
+// Text format: one [classname] section per weapon, then "key value" lines.
+// '#' starts a comment. Numbers take C syntax (0x.. for RVAs).
+#include "weapon_def.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+enum FieldKind { FK_STR, FK_U32, FK_I32, FK_F32 };
+
+struct FieldSpec
+{
+    const char* key;
+    FieldKind   kind;
+    size_t      off;
+};
+
+static const FieldSpec FIELDS[] = {
+    { "id",          FK_U32, offsetof(WeaponDef, id) },
+    { "model_v",     FK_STR, offsetof(WeaponDef, modelV) },
+    { "model_p",     FK_STR, offsetof(WeaponDef, modelP) },
+    { "model_w",     FK_STR, offsetof(WeaponDef, modelW) },
+    { "sound_fire",  FK_STR, offsetof(WeaponDef, soundFire) },
+    { "sound_reload",FK_STR, offsetof(WeaponDef, soundReload) },
+    { "event",       FK_STR, offsetof(WeaponDef, event) },
+    { "vtable",      FK_U32, offsetof(WeaponDef, vtableRva) },
+    { "factory",     FK_U32, offsetof(WeaponDef, factoryRva) },
+    { "obj_size",    FK_U32, offsetof(WeaponDef, objSize) },
+    { "clip",        FK_I32, offsetof(WeaponDef, clip) },
+    { "max_ammo",    FK_I32, offsetof(WeaponDef, maxAmmo) },
+    { "fire_rate",   FK_F32, offsetof(WeaponDef, fireRate) },
+    { "reload_time", FK_F32, offsetof(WeaponDef, reloadTime) },
+    { "damage",      FK_F32, offsetof(WeaponDef, damage) },
+    { "spread",      FK_F32, offsetof(WeaponDef, spread) },
+    { "spread_move", FK_F32, offsetof(WeaponDef, spreadMove) },
+    { "spread_air",  FK_F32, offsetof(WeaponDef, spreadAir) },
+    { "mode_shots",  FK_U32, offsetof(WeaponDef, modeShots) },
+    { "signal_time", FK_F32, offsetof(WeaponDef, signalTime) },
+    { "change_time", FK_F32, offsetof(WeaponDef, changeTime) },
+    { "mode_time",   FK_F32, offsetof(WeaponDef, modeTime) },
+};
+
+struct StringPool
+{
+    std::string                     data = std::string(1, '\0');   // offset 0 = unset
+    std::map<std::string, uint32_t> seen;
+
+    uint32_t Add(const std::string& s)
+    {
+        auto it = seen.find(s);
+        if (it != seen.end()) return it->second;
+        uint32_t off = (uint32_t)data.size();
+        data += s;
+        data += '\0';
+        seen[s] = off;
+        return off;
+    }
+};
+
+static char* Trim(char* s)
+{
+    while (*s == ' ' || *s == '\t') s++;
+    char* e = s + strlen(s);
+    while (e > s && strchr(" \t\r\n", e[-1])) *--e = 0;
+    return s;
+}
+
+static bool Compile(const char* inPath, const char* outPath)
+{
+    FILE* f = fopen(inPath, "r");
+    if (!f) { fprintf(stderr, "can't open %s\n", inPath); return false; }
+
+    std::vector<WeaponDef> defs;
+    std::vector<int>       defLine;
+    StringPool             pool;
+    char line[1024];
+    int  ln = 0;
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        ln++;
+        if (char* h = strchr(line, '#')) *h = 0;
+        char* s = Trim(line);
+        if (!*s) continue;
+
+        if (*s == '[')
+        {
+            char* e = strchr(s, ']');
+            if (!e || e == s + 1) { fprintf(stderr, "%s:%d: bad section header\n", inPath, ln); ok = false; continue; }
+            *e = 0;
+            WeaponDef d;
+            memset(&d, 0, sizeof(d));
+            d.id = WDB_NONE;
+            d.classname = pool.Add(s + 1);
+            defs.push_back(d);
+            defLine.push_back(ln);
+            continue;
+        }
+        if (defs.empty()) { fprintf(stderr, "%s:%d: key outside a [weapon] section\n", inPath, ln); ok = false; continue; }
+
+        char* val = s + strcspn(s, " \t");
+        if (*val) *val++ = 0;
+        val = Trim(val);
+
+        const FieldSpec* fs = nullptr;
+        for (const FieldSpec& c : FIELDS) if (!strcmp(c.key, s)) fs = &c;
+        if (!fs || !*val) { fprintf(stderr, "%s:%d: %s '%s'\n", inPath, ln, fs ? "missing value for" : "unknown key", s); ok = false; continue; }
+
+        uint8_t* field = (uint8_t*)&defs.back() + fs->off;
+        char* end = nullptr;
+        switch (fs->kind)
+        {
+        case FK_STR: { uint32_t o = pool.Add(val);                  memcpy(field, &o, 4); end = val + strlen(val); break; }
+        case FK_U32: { uint32_t v = (uint32_t)strtoul(val, &end, 0); memcpy(field, &v, 4); break; }
+        case FK_I32: { int32_t  v = (int32_t)strtol(val, &end, 0);   memcpy(field, &v, 4); break; }
+        case FK_F32: { float    v = strtof(val, &end);               memcpy(field, &v, 4); break; }
+        }
+        if (*end) { fprintf(stderr, "%s:%d: bad number '%s'\n", inPath, ln, val); ok = false; }
+    }
+    fclose(f);
+
+    uint32_t maxId = 0;
+    std::map<uint32_t, int> byId;
+    for (size_t i = 0; i < defs.size(); i++)
+    {
+        uint32_t id = defs[i].id;
+        if (id == WDB_NONE || id > WDB_MAX_ID)
+        {
+            fprintf(stderr, "%s:%d: missing or out-of-range id\n", inPath, defLine[i]);
+            ok = false;
+            continue;
+        }
+        if (byId.count(id))
+        {
+            fprintf(stderr, "%s:%d: id %u already used on line %d\n", inPath, defLine[i], id, defLine[byId[id]]);
+            ok = false;
+        }
+        byId[id] = (int)i;
+        if (id > maxId) maxId = id;
+    }
+    if (!ok) return false;
+
+    WdbHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, WDB_MAGIC, 8);
+    h.count       = (uint32_t)defs.size();
+    h.maxId       = maxId;
+    h.defSize     = sizeof(WeaponDef);
+    h.indexOff    = sizeof(WdbHeader);
+    h.defsOff     = h.indexOff + (maxId + 1) * 4;
+    h.stringsOff  = h.defsOff + h.count * (uint32_t)sizeof(WeaponDef);
+    h.stringsSize = (uint32_t)pool.data.size();
+    h.fileSize    = h.stringsOff + h.stringsSize;
+
+    std::vector<uint32_t> index(maxId + 1, WDB_NONE);
+    for (auto& kv : byId) index[kv.first] = (uint32_t)kv.second;
+
+    FILE* o = fopen(outPath, "wb");
+    if (!o) { fprintf(stderr, "can't write %s\n", outPath); return false; }
+    fwrite(&h, sizeof(h), 1, o);
+    fwrite(index.data(), 4, index.size(), o);
+    if (!defs.empty()) fwrite(defs.data(), sizeof(WeaponDef), defs.size(), o);
+    fwrite(pool.data.data(), 1, pool.data.size(), o);
+    bool wrote = !ferror(o);
+    fclose(o);
+    if (wrote) printf("%s: %u weapons, max id %u, %u bytes\n", outPath, h.count, maxId, h.fileSize);
+    return wrote;
+}
+
+static bool Dump(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) { fprintf(stderr, "can't open %s\n", path); return false; }
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+    fclose(f);
+
+    WdbView v;
+    if (!Wdb_View(buf.data(), buf.size(), v)) { fprintf(stderr, "%s: not a valid .wdb\n", path); return false; }
+    for (uint32_t i = 0; i < v.hdr->count; i++)
+    {
+        const WeaponDef& d = v.defs[i];
+        printf("[%s]\n", Wdb_Str(v, d.classname));
+        for (const FieldSpec& c : FIELDS)
+        {
+            const uint8_t* field = (const uint8_t*)&d + c.off;
+            uint32_t u; memcpy(&u, field, 4);
+            if (!u && c.off != offsetof(WeaponDef, id)) continue;
+            switch (c.kind)
+            {
+            case FK_STR: printf("%-12s %s\n", c.key, Wdb_Str(v, u) ? Wdb_Str(v, u) : "?"); break;
+            case FK_U32: printf(u > 0xFFFF ? "%-12s 0x%X\n" : "%-12s %u\n", c.key, u); break;
+            case FK_I32: printf("%-12s %d\n", c.key, (int32_t)u); break;
+            case FK_F32: { float x; memcpy(&x, field, 4); printf("%-12s %g\n", c.key, x); break; }
+            }
+        }
+        printf("\n");
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && !strcmp(argv[1], "-d")) return Dump(argv[2]) ? 0 : 1;
+    if (argc == 3) return Compile(argv[1], argv[2]) ? 0 : 1;
+    fprintf(stderr, "usage: csnz_wdefc weapons.txt weapons.wdb\n"
+                    "       csnz_wdefc -d weapons.wdb\n");
+    return 2;
+}